@@ -307,6 +307,11 @@ coco_problem_t *coco_problem_remove_observer(coco_problem_t *problem, coco_obser
  */
 const char *coco_observer_get_result_folder(const coco_observer_t *observer);
 
+/**
+ * @brief Returns whether the run on the given problem was completed before the experiment was resumed.
+ */
+int coco_observer_is_run_completed(const coco_observer_t *observer, const coco_problem_t *problem);
+
 /**@}*/
 
 /***********************************************************************************************************/
@@ -325,6 +330,24 @@ void coco_evaluate_function(coco_problem_t *problem, const double *x, double *y)
  */
 void coco_evaluate_constraint(coco_problem_t *problem, const double *x, double *y);
 
+/**
+ * @brief Evaluates the problem function in number_of_points points stored row by row in x and saves the
+ * results row by row in y.
+ */
+void coco_evaluate_function_batch(coco_problem_t *problem,
+                                  const double *x,
+                                  const size_t number_of_points,
+                                  double *y);
+
+/**
+ * @brief Evaluates the problem constraints in number_of_points points stored row by row in x and saves the
+ * results row by row in y.
+ */
+void coco_evaluate_constraint_batch(coco_problem_t *problem,
+                                    const double *x,
+                                    const size_t number_of_points,
+                                    double *y);
+
 /**
  * @brief Recommends a solution as the current best guesses to the problem. Not implemented yet.
  */
@@ -385,6 +408,12 @@ double coco_problem_get_best_observed_fvalue1(const coco_problem_t *problem);
  */
 double depreciated_coco_problem_get_final_target_fvalue1(const coco_problem_t *problem);
 
+/**
+ * @brief Returns the optimal value of the first objective (not meant to be used by the optimization
+ * algorithm, but e.g. for measuring its performance).
+ */
+double coco_problem_get_best_value(const coco_problem_t *problem);
+
 /**
  * @brief Returns a vector of size 'dimension' with lower bounds of the region of interest in
  * the decision space.
@@ -721,6 +750,17 @@ typedef void (*coco_problem_free_function_t)(coco_problem_t *problem);
  */
 typedef void (*coco_evaluate_function_t)(coco_problem_t *problem, const double *x, double *y);
 
+/**
+ * @brief The batch evaluate function type.
+ *
+ * This is a template for functions that evaluate several points at once. The points are stored row by row
+ * in x (number_of_points x number_of_variables) and the results row by row in y.
+ */
+typedef void (*coco_evaluate_batch_function_t)(coco_problem_t *problem,
+                                               const double *x,
+                                               const size_t number_of_points,
+                                               double *y);
+
 /**
  * @brief The recommend solutions function type.
  *
@@ -802,6 +842,12 @@ struct coco_problem_s {
   coco_evaluate_function_t evaluate_function;         /**< @brief  The function for evaluating the problem. */
   coco_evaluate_function_t evaluate_constraint;       /**< @brief  The function for evaluating the constraints. */
   coco_evaluate_function_t evaluate_gradient;         /**< @brief  The function for evaluating the constraints. */
+  coco_evaluate_batch_function_t evaluate_function_batch;   /**< @brief  The function for evaluating the
+                                                            problem in several points (NULL if not
+                                                            available). */
+  coco_evaluate_batch_function_t evaluate_constraint_batch; /**< @brief  The function for evaluating the
+                                                            constraints in several points (NULL if not
+                                                            available). */
   coco_recommend_function_t recommend_solution;       /**< @brief  The function for recommending a solution. */
   coco_problem_free_function_t problem_free_function; /**< @brief  The function for freeing this problem. */
 
@@ -866,6 +912,11 @@ struct coco_observer_s {
                              /**< @brief The "base evaluations" used to evaluations that trigger logging. */
   int precision_x;           /**< @brief Output precision for decision variables. */
   int precision_f;           /**< @brief Output precision for function values. */
+  int resume;                /**< @brief Whether the output of an interrupted experiment in result_folder is
+                             continued. */
+  size_t number_of_completed_runs;
+                             /**< @brief The number of runs found in result_folder when resuming. */
+  size_t *completed_runs;    /**< @brief The function, dimension and instance of each completed run. */
   void *data;                /**< @brief Void pointer that can be used to point to data specific to an observer. */
 
   coco_data_free_function_t data_free_function;             /**< @brief  The function for freeing this observer. */
@@ -1777,6 +1828,99 @@ static void coco_create_unique_directory(char **path) {
   return; /* Never reached */
 }
 
+/**
+ * @brief Returns the names of the files in the directory path whose names end with suffix.
+ *
+ * The number of found files is stored in number_of_files. The returned array and the names it contains
+ * need to be freed by the caller. Returns NULL if no such file exists.
+ */
+static char **coco_directory_list_files(const char *path, const char *suffix, size_t *number_of_files) {
+  char **files = NULL;
+  size_t capacity = 0;
+  const char *name;
+  size_t name_length;
+  const size_t suffix_length = strlen(suffix);
+#if _MSC_VER
+  WIN32_FIND_DATA find_data_file;
+  HANDLE find_handle = NULL;
+  char *buf;
+#else
+  DIR *d;
+  struct dirent *p;
+#endif
+
+  *number_of_files = 0;
+#if _MSC_VER
+  buf = coco_strdupf("%s\\*.*", path);
+  find_handle = FindFirstFile(buf, &find_data_file);
+  coco_free_memory(buf);
+  if (find_handle == INVALID_HANDLE_VALUE)
+    return NULL;
+  do {
+    if (find_data_file.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+      continue;
+    name = find_data_file.cFileName;
+#else
+  d = opendir(path);
+  if (d == NULL)
+    return NULL;
+  while ((p = readdir(d)) != NULL) {
+    name = p->d_name;
+#endif
+    name_length = strlen(name);
+    if (name_length < suffix_length || strcmp(name + name_length - suffix_length, suffix) != 0)
+      continue;
+    if (*number_of_files == capacity) {
+      char **new_files;
+      capacity = capacity == 0 ? 16 : 2 * capacity;
+      new_files = (char **) coco_allocate_memory(capacity * sizeof(char *));
+      if (files != NULL) {
+        memcpy(new_files, files, *number_of_files * sizeof(char *));
+        coco_free_memory(files);
+      }
+      files = new_files;
+    }
+    files[(*number_of_files)++] = coco_strdup(name);
+#if _MSC_VER
+  } while (FindNextFile(find_handle, &find_data_file));
+  FindClose(find_handle);
+#else
+  }
+  closedir(d);
+#endif
+  return files;
+}
+
+/**
+ * @brief Reads the whole file file_path into a newly allocated, zero-terminated string.
+ *
+ * The length of the content is stored in length. Returns NULL if the file cannot be read.
+ */
+static char *coco_file_read_all(const char *file_path, size_t *length) {
+  FILE *file;
+  char *content;
+  size_t capacity = 4096, read;
+
+  *length = 0;
+  file = fopen(file_path, "rb");
+  if (file == NULL)
+    return NULL;
+  content = (char *) coco_allocate_memory(capacity);
+  while ((read = fread(content + *length, 1, capacity - *length, file)) > 0) {
+    *length += read;
+    if (*length == capacity) {
+      char *new_content = (char *) coco_allocate_memory(2 * capacity);
+      memcpy(new_content, content, capacity);
+      coco_free_memory(content);
+      content = new_content;
+      capacity *= 2;
+    }
+  }
+  fclose(file);
+  content[*length] = '\0';
+  return content;
+}
+
 /**
  * The method should work across different platforms/compilers.
  *
@@ -2579,11 +2723,32 @@ static void coco_scale_vector(double *x, size_t dimension, double alpha) {
  * @param y The objective vector that is the result of the evaluation (in single-objective problems only the
  * first vector item is being set).
  */
+/**
+ * Updates the best observed value and the best observed evaluation number after the evaluation of x with
+ * the result y was counted.
+ */
+static void coco_problem_update_best_observed(coco_problem_t *problem, const double *x, const double *y) {
+  int is_feasible;
+  double *z;
+
+  /* A little bit of bookkeeping */
+  if (y[0] < problem->best_observed_fvalue[0]) {
+    is_feasible = 1;
+    if (coco_problem_get_number_of_constraints(problem) > 0) {
+      z = coco_allocate_vector(coco_problem_get_number_of_constraints(problem));
+      is_feasible = coco_is_feasible(problem, x, z);
+      coco_free_memory(z);
+    }
+    if (is_feasible) {
+      problem->best_observed_fvalue[0] = y[0];
+      problem->best_observed_evaluation[0] = problem->evaluations;    
+    }
+  }
+}
+
 void coco_evaluate_function(coco_problem_t *problem, const double *x, double *y) {
   /* implements a safer version of problem->evaluate(problem, x, y) */
   size_t i, j;
-  int is_feasible;
-  double *z;
   
   assert(problem != NULL);
   assert(problem->evaluate_function != NULL);
@@ -2607,20 +2772,7 @@ void coco_evaluate_function(coco_problem_t *problem, const double *x, double *y)
   problem->evaluate_function(problem, x, y);
   problem->evaluations++; /* each derived class has its own counter, only the most outer will be visible */
 
-  /* A little bit of bookkeeping */
-  if (y[0] < problem->best_observed_fvalue[0]) {
-    is_feasible = 1;
-    if (coco_problem_get_number_of_constraints(problem) > 0) {
-      z = coco_allocate_vector(coco_problem_get_number_of_constraints(problem));
-      is_feasible = coco_is_feasible(problem, x, z);
-      coco_free_memory(z);
-    }
-    if (is_feasible) {
-      problem->best_observed_fvalue[0] = y[0];
-      problem->best_observed_evaluation[0] = problem->evaluations;    
-    }
-  }
-
+  coco_problem_update_best_observed(problem, x, y);
 }
 
 /**
@@ -2661,6 +2813,183 @@ void coco_evaluate_constraint(coco_problem_t *problem, const double *x, double *
   problem->evaluations_constraints++;
 }
 
+static void coco_problem_transformed_evaluate_function(coco_problem_t *problem, const double *x, double *y);
+static void coco_problem_transformed_evaluate_constraint(coco_problem_t *problem, const double *x, double *y);
+static void coco_problem_transformed_evaluate_function_batch(coco_problem_t *problem,
+                                                             const double *x,
+                                                             const size_t number_of_points,
+                                                             double *y);
+static void coco_problem_transformed_evaluate_constraint_batch(coco_problem_t *problem,
+                                                               const double *x,
+                                                               const size_t number_of_points,
+                                                               double *y);
+
+/**
+ * Returns the function that evaluates the problem function of 'problem' in several points or NULL if the
+ * points need to be evaluated one by one. Transformed problems that only dispatch to their inner problem
+ * are evaluated in batches as well.
+ */
+static coco_evaluate_batch_function_t coco_problem_get_evaluate_function_batch(const coco_problem_t *problem) {
+  if (problem->evaluate_function_batch != NULL)
+    return problem->evaluate_function_batch;
+  if (problem->evaluate_function == coco_problem_transformed_evaluate_function)
+    return coco_problem_transformed_evaluate_function_batch;
+  return NULL;
+}
+
+/**
+ * Returns the function that evaluates the constraints of 'problem' in several points or NULL if the points
+ * need to be evaluated one by one.
+ */
+static coco_evaluate_batch_function_t coco_problem_get_evaluate_constraint_batch(const coco_problem_t *problem) {
+  if (problem->evaluate_constraint_batch != NULL)
+    return problem->evaluate_constraint_batch;
+  if (problem->evaluate_constraint == coco_problem_transformed_evaluate_constraint)
+    return coco_problem_transformed_evaluate_constraint_batch;
+  return NULL;
+}
+
+/**
+ * Evaluates the problem function in several points. The results, the evaluation counter and the best
+ * observed value are the same as if coco_evaluate_function() was called for the points one after the
+ * other. Transformations that support it (affine and shift transformations, stacked problems, the bbob
+ * logger...) process all points at once, e.g., with a matrix-matrix product for affine transformations.
+ *
+ * If a point contains INFINITY or NaN values, all points are evaluated with coco_evaluate_function().
+ *
+ * @note Both x and y must point to correctly sized allocated memory regions.
+ *
+ * @param problem The given COCO problem.
+ * @param x The decision vectors stored row by row (number_of_points x number_of_variables).
+ * @param number_of_points The number of decision vectors.
+ * @param y The objective vectors stored row by row (number_of_points x number_of_objectives).
+ */
+void coco_evaluate_function_batch(coco_problem_t *problem,
+                                  const double *x,
+                                  const size_t number_of_points,
+                                  double *y) {
+  size_t k;
+  coco_evaluate_batch_function_t evaluate_batch;
+  size_t number_of_variables, number_of_objectives;
+
+  assert(problem != NULL);
+  assert(problem->evaluate_function != NULL);
+  number_of_variables = coco_problem_get_dimension(problem);
+  number_of_objectives = coco_problem_get_number_of_objectives(problem);
+
+  evaluate_batch = coco_problem_get_evaluate_function_batch(problem);
+  if (evaluate_batch == NULL || !coco_vector_isfinite(x, number_of_points * number_of_variables)) {
+    for (k = 0; k < number_of_points; ++k)
+      coco_evaluate_function(problem, &x[k * number_of_variables], &y[k * number_of_objectives]);
+    return;
+  }
+
+  evaluate_batch(problem, x, number_of_points, y);
+  for (k = 0; k < number_of_points; ++k) {
+    problem->evaluations++;
+    coco_problem_update_best_observed(problem, &x[k * number_of_variables], &y[k * number_of_objectives]);
+  }
+}
+
+/**
+ * Evaluates the problem constraints in several points. The results and the evaluation counter are the same
+ * as if coco_evaluate_constraint() was called for the points one after the other.
+ *
+ * @note Both x and y must point to correctly sized allocated memory regions.
+ *
+ * @param problem The given COCO problem.
+ * @param x The decision vectors stored row by row (number_of_points x number_of_variables).
+ * @param number_of_points The number of decision vectors.
+ * @param y The constraint vectors stored row by row (number_of_points x number_of_constraints).
+ */
+void coco_evaluate_constraint_batch(coco_problem_t *problem,
+                                    const double *x,
+                                    const size_t number_of_points,
+                                    double *y) {
+  size_t k;
+  coco_evaluate_batch_function_t evaluate_batch;
+  size_t number_of_variables, number_of_constraints;
+
+  assert(problem != NULL);
+  if (problem->evaluate_constraint == NULL) {
+    coco_error("coco_evaluate_constraint_batch(): No constraint function implemented for problem %s",
+        problem->problem_id);
+  }
+  number_of_variables = coco_problem_get_dimension(problem);
+  number_of_constraints = coco_problem_get_number_of_constraints(problem);
+
+  evaluate_batch = coco_problem_get_evaluate_constraint_batch(problem);
+  if (evaluate_batch == NULL || !coco_vector_isfinite(x, number_of_points * number_of_variables)) {
+    for (k = 0; k < number_of_points; ++k)
+      coco_evaluate_constraint(problem, &x[k * number_of_variables], &y[k * number_of_constraints]);
+    return;
+  }
+
+  evaluate_batch(problem, x, number_of_points, y);
+  problem->evaluations_constraints += number_of_points;
+}
+
+/**
+ * Checks the feasibility of several points like coco_is_feasible() (without increasing the counter of
+ * constraint evaluations) and stores the result for each point in 'is_feasible'.
+ */
+static void coco_is_feasible_batch(coco_problem_t *problem,
+                                   const double *x,
+                                   const size_t number_of_points,
+                                   int *is_feasible) {
+  size_t i, k;
+  double *cons_values;
+  coco_evaluate_batch_function_t evaluate_batch;
+  const size_t number_of_variables = coco_problem_get_dimension(problem);
+  const size_t number_of_constraints = coco_problem_get_number_of_constraints(problem);
+
+  evaluate_batch = coco_problem_get_evaluate_constraint_batch(problem);
+  if (number_of_constraints <= 0 || evaluate_batch == NULL
+      || !coco_vector_isfinite(x, number_of_points * number_of_variables)) {
+    for (k = 0; k < number_of_points; ++k)
+      is_feasible[k] = coco_is_feasible(problem, &x[k * number_of_variables], NULL);
+    return;
+  }
+
+  cons_values = coco_allocate_vector(number_of_points * number_of_constraints);
+  evaluate_batch(problem, x, number_of_points, cons_values);
+  for (k = 0; k < number_of_points; ++k) {
+    is_feasible[k] = 1;
+    for (i = 0; i < number_of_constraints; ++i) {
+      if (cons_values[k * number_of_constraints + i] > 0.0) {
+        is_feasible[k] = 0;
+        break;
+      }
+    }
+  }
+  coco_free_memory(cons_values);
+}
+
+/**
+ * Checks in debug builds that no feasible point among the evaluated ones has a function value below the
+ * optimal one (the batch version of the sanity check of the transformations).
+ */
+static void coco_problem_assert_batch_values(coco_problem_t *problem,
+                                             const double *x,
+                                             const size_t number_of_points,
+                                             const double *y) {
+#ifndef NDEBUG
+  size_t k;
+  int *is_feasible;
+  const size_t number_of_objectives = coco_problem_get_number_of_objectives(problem);
+
+  is_feasible = (int *) coco_allocate_memory(number_of_points * sizeof(int));
+  coco_is_feasible_batch(problem, x, number_of_points, is_feasible);
+  for (k = 0; k < number_of_points; ++k) {
+    if (is_feasible[k])
+      assert(y[k * number_of_objectives] + 1e-13 >= problem->best_value[0]);
+  }
+  coco_free_memory(is_feasible);
+#else
+  (void) problem; (void) x; (void) number_of_points; (void) y;
+#endif
+}
+
 /**
  * @note Both x and y must point to correctly sized allocated memory regions.
  *
@@ -2714,6 +3043,8 @@ static coco_problem_t *coco_problem_allocate(const size_t number_of_variables,
   problem->evaluate_function = NULL;
   problem->evaluate_constraint = NULL;
   problem->evaluate_gradient = NULL;
+  problem->evaluate_function_batch = NULL;
+  problem->evaluate_constraint_batch = NULL;
   problem->recommend_solution = NULL;
   problem->problem_free_function = NULL;
   problem->number_of_variables = number_of_variables;
@@ -2757,6 +3088,8 @@ static coco_problem_t *coco_problem_duplicate(const coco_problem_t *other) {
 
   problem->evaluate_function = other->evaluate_function;
   problem->evaluate_constraint = other->evaluate_constraint;
+  problem->evaluate_function_batch = other->evaluate_function_batch;
+  problem->evaluate_constraint_batch = other->evaluate_constraint_batch;
   problem->recommend_solution = other->recommend_solution;
   problem->problem_free_function = other->problem_free_function;
 
@@ -3206,6 +3539,26 @@ static void coco_problem_transformed_evaluate_constraint(coco_problem_t *problem
   coco_evaluate_constraint(data->inner_problem, x, y);
 }
 
+/**
+ * @brief Calls the coco_evaluate_function_batch function on the inner problem.
+ */
+static void coco_problem_transformed_evaluate_function_batch(coco_problem_t *problem,
+                                                             const double *x,
+                                                             const size_t number_of_points,
+                                                             double *y) {
+  coco_evaluate_function_batch(coco_problem_transformed_get_inner_problem(problem), x, number_of_points, y);
+}
+
+/**
+ * @brief Calls the coco_evaluate_constraint_batch function on the inner problem.
+ */
+static void coco_problem_transformed_evaluate_constraint_batch(coco_problem_t *problem,
+                                                               const double *x,
+                                                               const size_t number_of_points,
+                                                               double *y) {
+  coco_evaluate_constraint_batch(coco_problem_transformed_get_inner_problem(problem), x, number_of_points, y);
+}
+
 static void bbob_problem_transformed_evaluate_gradient(coco_problem_t *problem, const double *x, double *y) {
   coco_problem_transformed_data_t *data;
   assert(problem != NULL);
@@ -3295,6 +3648,8 @@ static coco_problem_t *coco_problem_transformed_allocate(coco_problem_t *inner_p
   inner_copy->evaluate_function = coco_problem_transformed_evaluate_function;
   inner_copy->evaluate_constraint = coco_problem_transformed_evaluate_constraint;
   inner_copy->evaluate_gradient = bbob_problem_transformed_evaluate_gradient;
+  inner_copy->evaluate_function_batch = NULL;
+  inner_copy->evaluate_constraint_batch = NULL;
   inner_copy->recommend_solution = coco_problem_transformed_recommend_solution;
   inner_copy->problem_free_function = coco_problem_transformed_free;
   inner_copy->data = problem;
@@ -3362,6 +3717,85 @@ static void coco_problem_stacked_evaluate_constraint(coco_problem_t *problem, co
   
 }
 
+/**
+ * @brief Calls the coco_evaluate_function_batch function on the underlying problems.
+ */
+static void coco_problem_stacked_evaluate_function_batch(coco_problem_t *problem,
+                                                         const double *x,
+                                                         const size_t number_of_points,
+                                                         double *y) {
+  coco_problem_stacked_data_t* data = (coco_problem_stacked_data_t *) problem->data;
+
+  const size_t number_of_objectives_problem1 = coco_problem_get_number_of_objectives(data->problem1);
+  const size_t number_of_objectives_problem2 = coco_problem_get_number_of_objectives(data->problem2);
+  const size_t number_of_objectives = number_of_objectives_problem1 + number_of_objectives_problem2;
+  double *y1, *y2;
+  size_t i, k;
+
+  assert(coco_problem_get_number_of_objectives(problem) == number_of_objectives);
+
+  if (number_of_objectives_problem2 == 0) {
+    coco_evaluate_function_batch(data->problem1, x, number_of_points, y);
+  } else if (number_of_objectives_problem1 == 0) {
+    coco_evaluate_function_batch(data->problem2, x, number_of_points, y);
+  } else {
+    y1 = coco_allocate_vector(number_of_points * number_of_objectives_problem1);
+    y2 = coco_allocate_vector(number_of_points * number_of_objectives_problem2);
+    coco_evaluate_function_batch(data->problem1, x, number_of_points, y1);
+    coco_evaluate_function_batch(data->problem2, x, number_of_points, y2);
+    for (k = 0; k < number_of_points; ++k) {
+      for (i = 0; i < number_of_objectives_problem1; ++i)
+        y[k * number_of_objectives + i] = y1[k * number_of_objectives_problem1 + i];
+      for (i = 0; i < number_of_objectives_problem2; ++i)
+        y[k * number_of_objectives + number_of_objectives_problem1 + i] =
+            y2[k * number_of_objectives_problem2 + i];
+    }
+    coco_free_memory(y1);
+    coco_free_memory(y2);
+  }
+
+  if (problem->number_of_constraints > 0)
+    coco_problem_assert_batch_values(problem, x, number_of_points, y);
+}
+
+/**
+ * @brief Calls the coco_evaluate_constraint_batch function on the underlying problems.
+ */
+static void coco_problem_stacked_evaluate_constraint_batch(coco_problem_t *problem,
+                                                           const double *x,
+                                                           const size_t number_of_points,
+                                                           double *y) {
+  coco_problem_stacked_data_t* data = (coco_problem_stacked_data_t*) problem->data;
+
+  const size_t number_of_constraints_problem1 = coco_problem_get_number_of_constraints(data->problem1);
+  const size_t number_of_constraints_problem2 = coco_problem_get_number_of_constraints(data->problem2);
+  const size_t number_of_constraints = number_of_constraints_problem1 + number_of_constraints_problem2;
+  double *y1, *y2;
+  size_t i, k;
+
+  assert(coco_problem_get_number_of_constraints(problem) == number_of_constraints);
+
+  if (number_of_constraints_problem2 == 0) {
+    coco_evaluate_constraint_batch(data->problem1, x, number_of_points, y);
+  } else if (number_of_constraints_problem1 == 0) {
+    coco_evaluate_constraint_batch(data->problem2, x, number_of_points, y);
+  } else {
+    y1 = coco_allocate_vector(number_of_points * number_of_constraints_problem1);
+    y2 = coco_allocate_vector(number_of_points * number_of_constraints_problem2);
+    coco_evaluate_constraint_batch(data->problem1, x, number_of_points, y1);
+    coco_evaluate_constraint_batch(data->problem2, x, number_of_points, y2);
+    for (k = 0; k < number_of_points; ++k) {
+      for (i = 0; i < number_of_constraints_problem1; ++i)
+        y[k * number_of_constraints + i] = y1[k * number_of_constraints_problem1 + i];
+      for (i = 0; i < number_of_constraints_problem2; ++i)
+        y[k * number_of_constraints + number_of_constraints_problem1 + i] =
+            y2[k * number_of_constraints_problem2 + i];
+    }
+    coco_free_memory(y1);
+    coco_free_memory(y2);
+  }
+}
+
 /* TODO: Missing coco_problem_stacked_recommend_solution function! */
 
 /**
@@ -3425,8 +3859,11 @@ static coco_problem_t *coco_problem_stacked_allocate(coco_problem_t *problem1,
   coco_free_memory(s);
 
   problem->evaluate_function = coco_problem_stacked_evaluate_function;
-  if (number_of_constraints > 0)
+  problem->evaluate_function_batch = coco_problem_stacked_evaluate_function_batch;
+  if (number_of_constraints > 0) {
     problem->evaluate_constraint = coco_problem_stacked_evaluate_constraint;
+    problem->evaluate_constraint_batch = coco_problem_stacked_evaluate_constraint_batch;
+  }
 
   assert(smallest_values_of_interest);
   assert(largest_values_of_interest);
@@ -3875,6 +4312,42 @@ static void transform_obj_shift_evaluate_constraint(coco_problem_t *problem, con
     y[i] += data->offset;
 }
 
+/**
+ * @brief Evaluates the transformed function in several points.
+ */
+static void transform_obj_shift_evaluate_function_batch(coco_problem_t *problem,
+                                                        const double *x,
+                                                        const size_t number_of_points,
+                                                        double *y) {
+  transform_obj_shift_data_t *data;
+  size_t i;
+
+  data = (transform_obj_shift_data_t *) coco_problem_transformed_get_data(problem);
+  coco_evaluate_function_batch(coco_problem_transformed_get_inner_problem(problem), x, number_of_points, y);
+
+  for (i = 0; i < number_of_points * problem->number_of_objectives; i++)
+    y[i] += data->offset;
+
+  coco_problem_assert_batch_values(problem, x, number_of_points, y);
+}
+
+/**
+ * @brief Evaluates the transformed constraint in several points.
+ */
+static void transform_obj_shift_evaluate_constraint_batch(coco_problem_t *problem,
+                                                          const double *x,
+                                                          const size_t number_of_points,
+                                                          double *y) {
+  transform_obj_shift_data_t *data;
+  size_t i;
+
+  data = (transform_obj_shift_data_t *) coco_problem_transformed_get_data(problem);
+  coco_evaluate_constraint_batch(coco_problem_transformed_get_inner_problem(problem), x, number_of_points, y);
+
+  for (i = 0; i < number_of_points * problem->number_of_constraints; i++)
+    y[i] += data->offset;
+}
+
 /**
  * @brief Evaluates the gradient of the transformed function at x
  */
@@ -3901,11 +4374,15 @@ static coco_problem_t *transform_obj_shift(coco_problem_t *inner_problem, const
   problem = coco_problem_transformed_allocate(inner_problem, data, 
     NULL, "transform_obj_shift");
     
-  if (inner_problem->number_of_objectives > 0)
+  if (inner_problem->number_of_objectives > 0) {
     problem->evaluate_function = transform_obj_shift_evaluate_function;
+    problem->evaluate_function_batch = transform_obj_shift_evaluate_function_batch;
+  }
     
-  if (inner_problem->number_of_constraints > 0)
+  if (inner_problem->number_of_constraints > 0) {
     problem->evaluate_constraint = transform_obj_shift_evaluate_constraint;
+    problem->evaluate_constraint_batch = transform_obj_shift_evaluate_constraint_batch;
+  }
     
   problem->evaluate_gradient = transform_obj_shift_evaluate_gradient;  /* TODO (NH): why do we need a new function pointer here? */
   
@@ -4008,6 +4485,74 @@ static void transform_vars_affine_evaluate_constraint(coco_problem_t *problem, c
   coco_evaluate_constraint(inner_problem, data->x, y);
 }
 
+/**
+ * @brief Applies the affine transformation to several points stored row by row in 'x' and returns the
+ *        transformed points (row by row) in a newly allocated vector.
+ *
+ * Blocks of points share each row of M while it is in cache. The summation order per value is the same
+ * as in the evaluation of a single point.
+ */
+static double *transform_vars_affine_apply_batch(coco_problem_t *problem,
+                                                 const double *x,
+                                                 const size_t number_of_points) {
+  enum { block_size = 8 };
+  size_t i, j, p, p_begin, p_end;
+  transform_vars_affine_data_t *data;
+  coco_problem_t *inner_problem;
+  const double *current_row;
+  double sum[block_size];
+  double *transformed_x;
+
+  data = (transform_vars_affine_data_t *) coco_problem_transformed_get_data(problem);
+  inner_problem = coco_problem_transformed_get_inner_problem(problem);
+  transformed_x = coco_allocate_vector(number_of_points * inner_problem->number_of_variables);
+
+  for (p_begin = 0; p_begin < number_of_points; p_begin += block_size) {
+    p_end = p_begin + block_size < number_of_points ? p_begin + block_size : number_of_points;
+    for (i = 0; i < inner_problem->number_of_variables; ++i) {
+      current_row = data->M + i * problem->number_of_variables;
+      for (p = p_begin; p < p_end; ++p)
+        sum[p - p_begin] = data->b[i];
+      for (j = 0; j < problem->number_of_variables; ++j)
+        for (p = p_begin; p < p_end; ++p)
+          sum[p - p_begin] += x[p * problem->number_of_variables + j] * current_row[j];
+      for (p = p_begin; p < p_end; ++p)
+        transformed_x[p * inner_problem->number_of_variables + i] = sum[p - p_begin];
+    }
+  }
+  return transformed_x;
+}
+
+/**
+ * @brief Evaluates the transformed objective function in several points.
+ */
+static void transform_vars_affine_evaluate_function_batch(coco_problem_t *problem,
+                                                          const double *x,
+                                                          const size_t number_of_points,
+                                                          double *y) {
+  double *transformed_x = transform_vars_affine_apply_batch(problem, x, number_of_points);
+
+  coco_evaluate_function_batch(coco_problem_transformed_get_inner_problem(problem), transformed_x,
+      number_of_points, y);
+  coco_free_memory(transformed_x);
+
+  coco_problem_assert_batch_values(problem, x, number_of_points, y);
+}
+
+/**
+ * @brief Evaluates the transformed constraint in several points.
+ */
+static void transform_vars_affine_evaluate_constraint_batch(coco_problem_t *problem,
+                                                            const double *x,
+                                                            const size_t number_of_points,
+                                                            double *y) {
+  double *transformed_x = transform_vars_affine_apply_batch(problem, x, number_of_points);
+
+  coco_evaluate_constraint_batch(coco_problem_transformed_get_inner_problem(problem), transformed_x,
+      number_of_points, y);
+  coco_free_memory(transformed_x);
+}
+
 /**
  * @brief Evaluates the gradient of the transformed function.
  */
@@ -4095,11 +4640,15 @@ static coco_problem_t *transform_vars_affine(coco_problem_t *inner_problem,
   problem = coco_problem_transformed_allocate(inner_problem, data, 
     transform_vars_affine_free, "transform_vars_affine");
     
-  if (inner_problem->number_of_objectives > 0)
+  if (inner_problem->number_of_objectives > 0) {
     problem->evaluate_function = transform_vars_affine_evaluate_function;
+    problem->evaluate_function_batch = transform_vars_affine_evaluate_function_batch;
+  }
     
-  if (inner_problem->number_of_constraints > 0)
+  if (inner_problem->number_of_constraints > 0) {
     problem->evaluate_constraint = transform_vars_affine_evaluate_constraint;
+    problem->evaluate_constraint_batch = transform_vars_affine_evaluate_constraint_batch;
+  }
     
   problem->evaluate_gradient = transform_vars_affine_evaluate_gradient;
   
@@ -4187,6 +4736,58 @@ static void transform_vars_shift_evaluate_constraint(coco_problem_t *problem, co
   coco_evaluate_constraint(inner_problem, data->shifted_x, y);
 }
 
+/**
+ * @brief Returns the shifted points (row by row) of the points stored row by row in 'x' in a newly
+ *        allocated vector.
+ */
+static double *transform_vars_shift_apply_batch(coco_problem_t *problem,
+                                                const double *x,
+                                                const size_t number_of_points) {
+  size_t i, k;
+  transform_vars_shift_data_t *data;
+  double *shifted_x;
+
+  data = (transform_vars_shift_data_t *) coco_problem_transformed_get_data(problem);
+  shifted_x = coco_allocate_vector(number_of_points * problem->number_of_variables);
+  for (k = 0; k < number_of_points; ++k) {
+    for (i = 0; i < problem->number_of_variables; ++i) {
+      shifted_x[k * problem->number_of_variables + i] = x[k * problem->number_of_variables + i]
+          - data->offset[i];
+    }
+  }
+  return shifted_x;
+}
+
+/**
+ * @brief Evaluates the transformed objective function in several points.
+ */
+static void transform_vars_shift_evaluate_function_batch(coco_problem_t *problem,
+                                                         const double *x,
+                                                         const size_t number_of_points,
+                                                         double *y) {
+  double *shifted_x = transform_vars_shift_apply_batch(problem, x, number_of_points);
+
+  coco_evaluate_function_batch(coco_problem_transformed_get_inner_problem(problem), shifted_x,
+      number_of_points, y);
+  coco_free_memory(shifted_x);
+
+  coco_problem_assert_batch_values(problem, x, number_of_points, y);
+}
+
+/**
+ * @brief Evaluates the transformed constraint function in several points.
+ */
+static void transform_vars_shift_evaluate_constraint_batch(coco_problem_t *problem,
+                                                           const double *x,
+                                                           const size_t number_of_points,
+                                                           double *y) {
+  double *shifted_x = transform_vars_shift_apply_batch(problem, x, number_of_points);
+
+  coco_evaluate_constraint_batch(coco_problem_transformed_get_inner_problem(problem), shifted_x,
+      number_of_points, y);
+  coco_free_memory(shifted_x);
+}
+
 /**
  * @brief Evaluates the gradient of the transformed function at x
  */
@@ -4238,11 +4839,15 @@ static coco_problem_t *transform_vars_shift(coco_problem_t *inner_problem,
   problem = coco_problem_transformed_allocate(inner_problem, data, 
     transform_vars_shift_free, "transform_vars_shift");
     
-  if (inner_problem->number_of_objectives > 0)
+  if (inner_problem->number_of_objectives > 0) {
     problem->evaluate_function = transform_vars_shift_evaluate_function;
+    problem->evaluate_function_batch = transform_vars_shift_evaluate_function_batch;
+  }
     
-  if (inner_problem->number_of_constraints > 0)
+  if (inner_problem->number_of_constraints > 0) {
     problem->evaluate_constraint = transform_vars_shift_evaluate_constraint;
+    problem->evaluate_constraint_batch = transform_vars_shift_evaluate_constraint_batch;
+  }
     
   problem->evaluate_gradient = transform_vars_shift_evaluate_gradient;
   
@@ -18297,6 +18902,16 @@ typedef struct {
   double *x;
 } linear_constraint_data_t;	
 
+/**
+ * @brief Data type for all linear constraints of a problem flattened into one matrix.
+ *
+ * Row k of the row-major matrix (number_of_constraints x number_of_variables) is the gradient of
+ * the k-th constraint.
+ */
+typedef struct {
+  double *matrix;
+} linear_constraints_matrix_data_t;
+
 static void c_sum_variables_evaluate(coco_problem_t *self, 
                                      const double *x, 
                                      double *y);
@@ -18310,6 +18925,19 @@ static coco_problem_t *c_guarantee_feasible_point(coco_problem_t *problem,
                                                
 static void c_linear_gradient_free(void *thing);
 
+static void c_linear_matrix_evaluate(coco_problem_t *self, 
+                                     const double *x, 
+                                     double *y);
+
+static void c_linear_matrix_evaluate_batch(coco_problem_t *self,
+                                           const double *x,
+                                           const size_t number_of_points,
+                                           double *y);
+
+static void c_linear_matrix_free(void *thing);
+
+static coco_problem_t *c_linear_flatten(coco_problem_t *problem_c);
+
 static coco_problem_t *c_sum_variables_allocate(const size_t number_of_variables);
 
 static coco_problem_t *c_linear_transform(coco_problem_t *inner_problem, 
@@ -18381,6 +19009,130 @@ static void c_linear_single_evaluate(coco_problem_t *self,
   data = NULL;
 }
 
+/**
+ * @brief Evaluates all linear constraints at the point 'x' with one matrix-vector product and stores
+ *        the results in 'y'.
+ *
+ * The products are summed up in the same order as in c_linear_single_evaluate() and
+ * c_sum_variables_evaluate(), so the results are identical to evaluating the stacked constraints.
+ */
+static void c_linear_matrix_evaluate(coco_problem_t *self, 
+                                     const double *x, 
+                                     double *y) {
+
+  size_t i, k;
+  const size_t number_of_variables = self->number_of_variables;
+  linear_constraints_matrix_data_t *data;
+  const double *row;
+  double sum;
+
+  data = (linear_constraints_matrix_data_t *) coco_problem_transformed_get_data(self);
+
+  for (k = 0; k < self->number_of_constraints; ++k) {
+    row = data->matrix + k * number_of_variables;
+    sum = 0.0;
+    for (i = 0; i < number_of_variables; ++i)
+      sum += row[i] * x[i];
+    y[k] = sum;
+  }
+}
+
+/**
+ * @brief Evaluates all linear constraints at several points (matrix-matrix product).
+ *
+ * The points are stored row by row in 'x' and the constraint values of each point row by row in 'y'.
+ * Blocks of points share each constraint row while it is in cache. The summation order per value is the
+ * same as in c_linear_matrix_evaluate().
+ */
+static void c_linear_matrix_evaluate_batch(coco_problem_t *self,
+                                           const double *x,
+                                           const size_t number_of_points,
+                                           double *y) {
+
+  enum { block_size = 8 };
+  size_t i, k, p, p_begin, p_end;
+  const size_t number_of_variables = self->number_of_variables;
+  const size_t number_of_constraints = self->number_of_constraints;
+  linear_constraints_matrix_data_t *data;
+  const double *row;
+  double sum[block_size];
+
+  data = (linear_constraints_matrix_data_t *) coco_problem_transformed_get_data(self);
+
+  for (p_begin = 0; p_begin < number_of_points; p_begin += block_size) {
+    p_end = p_begin + block_size < number_of_points ? p_begin + block_size : number_of_points;
+    for (k = 0; k < number_of_constraints; ++k) {
+      row = data->matrix + k * number_of_variables;
+      for (p = p_begin; p < p_end; ++p)
+        sum[p - p_begin] = 0.0;
+      for (i = 0; i < number_of_variables; ++i)
+        for (p = p_begin; p < p_end; ++p)
+          sum[p - p_begin] += row[i] * x[p * number_of_variables + i];
+      for (p = p_begin; p < p_end; ++p)
+        y[p * number_of_constraints + k] = sum[p - p_begin];
+    }
+  }
+}
+
+/**
+ * @brief Frees the constraint matrix.
+ */
+static void c_linear_matrix_free(void *thing) {
+
+  linear_constraints_matrix_data_t *data = (linear_constraints_matrix_data_t *) thing;
+  coco_free_memory(data->matrix);
+}
+
+/**
+ * @brief Copies the gradients of the stacked linear constraints in 'problem' into consecutive rows of
+ *        'matrix', starting at row '*row', in the order in which the stack evaluates them.
+ */
+static void c_linear_collect_gradients(coco_problem_t *problem, double *matrix, size_t *row) {
+
+  size_t i;
+  coco_problem_stacked_data_t *stacked_data;
+  linear_constraint_data_t *constraint_data;
+
+  if (problem->evaluate_constraint == coco_problem_stacked_evaluate_constraint) {
+    stacked_data = (coco_problem_stacked_data_t *) problem->data;
+    c_linear_collect_gradients(stacked_data->problem1, matrix, row);
+    c_linear_collect_gradients(stacked_data->problem2, matrix, row);
+  } else {
+    assert(problem->evaluate_constraint == c_linear_single_evaluate);
+    constraint_data = (linear_constraint_data_t *) coco_problem_transformed_get_data(problem);
+    for (i = 0; i < problem->number_of_variables; ++i)
+      matrix[*row * problem->number_of_variables + i] = constraint_data->gradient[i];
+    *row += 1;
+  }
+}
+
+/**
+ * @brief Wraps the stacked linear constraints in 'problem_c' into a problem that evaluates all of them
+ *        with one contiguous constraint matrix instead of one indirect call per constraint.
+ *
+ * The stacked problem is kept as inner problem (it still defines ids, names and the initial solution).
+ */
+static coco_problem_t *c_linear_flatten(coco_problem_t *problem_c) {
+
+  size_t row = 0;
+  linear_constraints_matrix_data_t *data;
+  coco_problem_t *self;
+
+  data = (linear_constraints_matrix_data_t *) coco_allocate_memory(sizeof(*data));
+  data->matrix = coco_allocate_vector(problem_c->number_of_constraints * problem_c->number_of_variables);
+  c_linear_collect_gradients(problem_c, data->matrix, &row);
+  assert(row == problem_c->number_of_constraints);
+
+  self = coco_problem_transformed_allocate(problem_c, data, c_linear_matrix_free, "linear_constraints_matrix");
+  self->evaluate_constraint = c_linear_matrix_evaluate;
+  self->evaluate_constraint_batch = c_linear_matrix_evaluate_batch;
+  /* Keep the name of the stacked constraints */
+  coco_free_memory(self->problem_name);
+  self->problem_name = coco_strdup(problem_c->problem_name);
+
+  return self;
+}
+
 /**
  * @brief Guarantees that "feasible_direction" is feasible w.r.t. 
  *        the constraint in "problem" and records it as the 
@@ -18715,6 +19467,9 @@ static coco_problem_t *c_linear_cons_bbob_problem_allocate(const size_t function
   
   /* Exchange the first constraint position for another one if any */
   problem_c = c_linear_shuffle(problem_c, data_c1);
+
+  /* Evaluate all constraints with one constraint matrix (the gradients are final now) */
+  problem_c = c_linear_flatten(problem_c);
   
   coco_free_memory(gradient_c1);
   coco_random_free(random_generator);
@@ -21003,6 +21758,9 @@ static coco_observer_t *coco_observer_allocate(const char *result_folder,
   observer->base_evaluation_triggers = coco_strdup(base_evaluation_triggers);
   observer->precision_x = precision_x;
   observer->precision_f = precision_f;
+  observer->resume = 0;
+  observer->number_of_completed_runs = 0;
+  observer->completed_runs = NULL;
   observer->data = NULL;
   observer->data_free_function = NULL;
   observer->logger_allocate_function = NULL;
@@ -21027,6 +21785,9 @@ void coco_observer_free(coco_observer_t *observer) {
     if (observer->base_evaluation_triggers != NULL)
       coco_free_memory(observer->base_evaluation_triggers);
 
+    if (observer->completed_runs != NULL)
+      coco_free_memory(observer->completed_runs);
+
     if (observer->data != NULL) {
       if (observer->data_free_function != NULL) {
         observer->data_free_function(observer->data);
@@ -21081,6 +21842,7 @@ void coco_observer_free(coco_observer_t *observer) {
 
 static coco_problem_t *logger_bbob(coco_observer_t *observer, coco_problem_t *problem);
 static void logger_bbob_free(void *logger);
+static void logger_bbob_resume(coco_observer_t *observer);
 
 /**
  * @brief The bbob observer data type.
@@ -21103,6 +21865,9 @@ static void observer_bbob(coco_observer_t *observer, const char *options, coco_o
   observer->data_free_function = NULL;
   observer->data = NULL;
 
+  if (observer->resume)
+    logger_bbob_resume(observer);
+
   *option_keys = NULL;
 
   (void) options; /* To silence the compiler */
@@ -21119,6 +21884,8 @@ static size_t bbob_current_dim = 0;
 static size_t bbob_current_funId = 0;
 static size_t bbob_infoFile_firstInstance = 0;
 char *bbob_infoFile_firstInstance_char;
+/* prefix of the index and data files, changed when resuming in order not to append to existing files */
+static char bbob_file_prefix[32] = "bbobexp";
 /* a possible solution: have a list of dims that are already in the file, if the ones we're about to log
  * is != bbob_current_dim and the funId is currend_funId, create a new .info file with as suffix the
  * number of the first instance */
@@ -21427,7 +22194,7 @@ static void logger_bbob_initialize(logger_bbob_data_t *logger, coco_problem_t *i
   char folder_path[COCO_PATH_MAX + 2] = { 0 };
   char *tmpc_funId; /* serves to extract the function id as a char *. There should be a better way of doing this! */
   char *tmpc_dim; /* serves to extract the dimension as a char *. There should be a better way of doing this! */
-  char indexFile_prefix[10] = "bbobexp"; /* TODO (minor): make the prefix bbobexp a parameter that the user can modify */
+  const char *indexFile_prefix = bbob_file_prefix; /* TODO (minor): make the prefix a parameter that the user can modify */
   int i = 0;
   
   assert(logger != NULL);
@@ -21444,7 +22211,11 @@ static void logger_bbob_initialize(logger_bbob_data_t *logger, coco_problem_t *i
   coco_join_path(folder_path, sizeof(folder_path), logger->observer->result_folder, dataFile_path,
   NULL);
   coco_create_directory(folder_path);
-  strncat(dataFile_path, "/bbobexp_f",
+  strncat(dataFile_path, "/",
+  COCO_PATH_MAX - strlen(dataFile_path) - 1);
+  strncat(dataFile_path, indexFile_prefix,
+  COCO_PATH_MAX - strlen(dataFile_path) - 1);
+  strncat(dataFile_path, "_f",
   COCO_PATH_MAX - strlen(dataFile_path) - 1);
   strncat(dataFile_path, tmpc_funId,
   COCO_PATH_MAX - strlen(dataFile_path) - 1);
@@ -21466,6 +22237,8 @@ static void logger_bbob_initialize(logger_bbob_data_t *logger, coco_problem_t *i
   logger_bbob_openIndexFile(logger, logger->observer->result_folder, indexFile_prefix, tmpc_funId,
       dataFile_path, coco_problem_get_suite(inner_problem)->suite_name);
   fprintf(logger->index_file, ", %lu", (unsigned long) coco_problem_get_suite_dep_instance(inner_problem));
+  /* Make sure that the run is listed in the index file before its data is written (needed for resuming) */
+  fflush(logger->index_file);
   /* data files */
   /* TODO: definitely improvable but works for now */
   strncat(dataFile_path, "_i", COCO_PATH_MAX - strlen(dataFile_path) - 1);
@@ -21487,26 +22260,16 @@ static void logger_bbob_initialize(logger_bbob_data_t *logger, coco_problem_t *i
 }
 
 /**
- * Layer added to the transformed-problem evaluate_function by the logger
+ * @brief Updates the logger state and writes the data files for the evaluation of x with the result y.
  */
-static void logger_bbob_evaluate(coco_problem_t *problem, const double *x, double *y) {
+static void logger_bbob_log_evaluation(coco_problem_t *problem,
+                                       const double *x,
+                                       const double *y,
+                                       const int is_feasible) {
   size_t i;
   double y_logged;
   logger_bbob_data_t *logger = (logger_bbob_data_t *) coco_problem_transformed_get_data(problem);
-  coco_problem_t *inner_problem = coco_problem_transformed_get_inner_problem(problem);
-  const int is_feasible = problem->number_of_constraints <= 0
-                            || coco_is_feasible(inner_problem, x, NULL);
 
-  if (!logger->is_initialized) {
-    logger_bbob_initialize(logger, inner_problem);
-  }
-  if ((coco_log_level >= COCO_DEBUG) && logger->number_of_evaluations == 0) {
-    coco_debug("%4lu: ", (unsigned long) inner_problem->suite_dep_index);
-    coco_debug("on problem %s ... ", coco_problem_get_id(inner_problem));
-  }
-  
-  coco_evaluate_function(inner_problem, x, y); /* fulfill contract as "being" a coco evaluate function */
-  
   logger->number_of_evaluations_constraints = coco_problem_get_evaluations_constraints(problem);
   logger->number_of_evaluations++; /* could be != coco_problem_get_evaluations(problem) for non-anytime logging? */
   logger->written_last_eval = 0; /* flag whether the current evaluation was logged? */
@@ -21565,12 +22328,75 @@ static void logger_bbob_evaluate(coco_problem_t *problem, const double *x, doubl
         problem->number_of_variables);
     logger->written_last_eval = 1;
   }
+}
+
+/**
+ * Layer added to the transformed-problem evaluate_function by the logger
+ */
+static void logger_bbob_evaluate(coco_problem_t *problem, const double *x, double *y) {
+  logger_bbob_data_t *logger = (logger_bbob_data_t *) coco_problem_transformed_get_data(problem);
+  coco_problem_t *inner_problem = coco_problem_transformed_get_inner_problem(problem);
+  const int is_feasible = problem->number_of_constraints <= 0
+                            || coco_is_feasible(inner_problem, x, NULL);
+
+  if (!logger->is_initialized) {
+    logger_bbob_initialize(logger, inner_problem);
+  }
+  if ((coco_log_level >= COCO_DEBUG) && logger->number_of_evaluations == 0) {
+    coco_debug("%4lu: ", (unsigned long) inner_problem->suite_dep_index);
+    coco_debug("on problem %s ... ", coco_problem_get_id(inner_problem));
+  }
+  
+  coco_evaluate_function(inner_problem, x, y); /* fulfill contract as "being" a coco evaluate function */
+  
+  logger_bbob_log_evaluation(problem, x, y, is_feasible);
 
   /* Flush output so that impatient users can see progress. */
   fflush(logger->fdata_file);
      
 }  /* end logger_bbob_evaluate */
 
+/**
+ * @brief Evaluates the function in the inner problem in several points at once and logs the evaluations
+ *        one after the other, such that the output is the same as for sequential evaluations.
+ */
+static void logger_bbob_evaluate_batch(coco_problem_t *problem,
+                                       const double *x,
+                                       const size_t number_of_points,
+                                       double *y) {
+  size_t k;
+  int *is_feasible;
+  logger_bbob_data_t *logger = (logger_bbob_data_t *) coco_problem_transformed_get_data(problem);
+  coco_problem_t *inner_problem = coco_problem_transformed_get_inner_problem(problem);
+
+  is_feasible = (int *) coco_allocate_memory(number_of_points * sizeof(int));
+  if (problem->number_of_constraints <= 0) {
+    for (k = 0; k < number_of_points; ++k)
+      is_feasible[k] = 1;
+  } else {
+    coco_is_feasible_batch(inner_problem, x, number_of_points, is_feasible);
+  }
+
+  if (!logger->is_initialized) {
+    logger_bbob_initialize(logger, inner_problem);
+  }
+  if ((coco_log_level >= COCO_DEBUG) && logger->number_of_evaluations == 0) {
+    coco_debug("%4lu: ", (unsigned long) inner_problem->suite_dep_index);
+    coco_debug("on problem %s ... ", coco_problem_get_id(inner_problem));
+  }
+
+  coco_evaluate_function_batch(inner_problem, x, number_of_points, y);
+
+  for (k = 0; k < number_of_points; ++k) {
+    logger_bbob_log_evaluation(problem, &x[k * problem->number_of_variables],
+        &y[k * problem->number_of_objectives], is_feasible[k]);
+  }
+  coco_free_memory(is_feasible);
+
+  /* Flush output so that impatient users can see progress. */
+  fflush(logger->fdata_file);
+}  /* end logger_bbob_evaluate_batch */
+
 /**
  * Also serves as a finalize run method so. Must be called at the end
  * of Each run to correctly fill the index file
@@ -21646,6 +22472,204 @@ static void logger_bbob_free(void *stuff) {
   bbob_logger_is_open = 0;
 }
 
+/**
+ * @brief Keeps the first number_of_runs runs of the data file file_path and removes the rest.
+ *
+ * Each run in a data file starts with a header line ("% f evaluations | ..."). The file is removed if no
+ * run is kept.
+ */
+static void logger_bbob_resume_truncate_data_file(const char *file_path, const size_t number_of_runs) {
+  size_t length, position = 0, runs = 0;
+  char *content;
+  FILE *file;
+
+  content = coco_file_read_all(file_path, &length);
+  if (content == NULL)
+    return;
+  while (position < length) {
+    if (content[position] == '%') {
+      if (runs == number_of_runs)
+        break;
+      runs++;
+    }
+    while (position < length && content[position] != '\n')
+      position++;
+    position++;
+  }
+  if (number_of_runs == 0) {
+    remove(file_path);
+  } else if (position < length) {
+    coco_warning("logger_bbob_resume(): removing the unfinished run from %s", file_path);
+    file = fopen(file_path, "wb");
+    if (file == NULL) {
+      logger_bbob_error_io(file, errno);
+    }
+    fwrite(content, 1, position, file);
+    fclose(file);
+  }
+  coco_free_memory(content);
+}
+
+/**
+ * @brief Adds a completed run to the observer.
+ */
+static void logger_bbob_resume_add_run(coco_observer_t *observer,
+                                       const size_t function,
+                                       const size_t dimension,
+                                       const size_t instance) {
+  size_t *completed_runs;
+  const size_t count = observer->number_of_completed_runs;
+
+  /* The capacity is doubled whenever the count reaches a power of two */
+  if ((count & (count - 1)) == 0) {
+    completed_runs = (size_t *) coco_allocate_memory(3 * (count == 0 ? 1 : 2 * count) * sizeof(size_t));
+    if (observer->completed_runs != NULL) {
+      memcpy(completed_runs, observer->completed_runs, 3 * count * sizeof(size_t));
+      coco_free_memory(observer->completed_runs);
+    }
+    observer->completed_runs = completed_runs;
+  }
+  observer->completed_runs[3 * count] = function;
+  observer->completed_runs[3 * count + 1] = dimension;
+  observer->completed_runs[3 * count + 2] = instance;
+  observer->number_of_completed_runs++;
+}
+
+/**
+ * @brief Removes the unfinished runs from the index file file_name (and their data from the data files)
+ *        and adds the finished runs to the completed runs of the observer.
+ *
+ * An index file consists of groups of three lines: a header with the function and dimension, a comment
+ * line and a line with the path of the .dat file followed by one entry per run. A run adds ", instance"
+ * when it starts and ":evaluations|precision" when it is finished. Groups without finished runs are
+ * removed together with their data files.
+ */
+static void logger_bbob_resume_index_file(coco_observer_t *observer, const char *file_name) {
+  char file_path[COCO_PATH_MAX + 2] = { 0 };
+  char data_file_path[COCO_PATH_MAX + 2] = { 0 };
+  char *content, *new_content, *line, *line_end, *header = NULL, *entry, *entry_end, *kept_end;
+  const char *extensions[] = { ".dat", ".tdat", ".rdat" };
+  size_t length, new_length = 0, function = 0, dimension = 0, number_of_runs, i;
+  int changed = 0, is_finished;
+  FILE *file;
+
+  coco_join_path(file_path, sizeof(file_path), observer->result_folder, file_name, NULL);
+  content = coco_file_read_all(file_path, &length);
+  if (content == NULL)
+    return;
+  new_content = coco_allocate_string(length + 2);
+
+  for (line = content; line < content + length; line = line_end + 1) {
+    line_end = strchr(line, '\n');
+    if (line_end == NULL)
+      line_end = content + length;
+    *line_end = '\0';
+
+    if (strncmp(line, "suite", 5) == 0) {
+      if (header != NULL)
+        changed = 1; /* a group without a data file line */
+      header = line;
+      if ((strstr(line, "funcId = ") == NULL) || (strstr(line, "DIM = ") == NULL))
+        coco_error("logger_bbob_resume(): unexpected header in %s", file_path);
+      function = (size_t) strtoul(strstr(line, "funcId = ") + 9, NULL, 10);
+      dimension = (size_t) strtoul(strstr(line, "DIM = ") + 6, NULL, 10);
+    } else if (line[0] == '%' || line[0] == '\0') {
+      continue;
+    } else if (header != NULL) {
+      /* The data file line: count the finished runs */
+      number_of_runs = 0;
+      entry = strchr(line, ',');
+      kept_end = entry != NULL ? entry : line_end;
+      while (entry != NULL) {
+        entry_end = strchr(entry + 1, ',');
+        if (entry_end == NULL)
+          entry_end = line_end;
+        is_finished = 0;
+        for (i = 0; entry + i < entry_end; ++i) {
+          if (entry[i] == '|')
+            is_finished = 1;
+        }
+        if (!is_finished)
+          break;
+        logger_bbob_resume_add_run(observer, function, dimension, (size_t) strtoul(entry + 1, NULL, 10));
+        number_of_runs++;
+        kept_end = entry_end;
+        entry = entry_end < line_end ? entry_end : NULL;
+      }
+      if ((entry != NULL) || (number_of_runs == 0))
+        changed = 1;
+
+      /* Keep the finished runs in the data files (the line starts with the path of the .dat file) */
+      entry = strchr(line, ',');
+      if (entry != NULL)
+        *entry = '\0';
+      for (i = 0; i < sizeof(extensions) / sizeof(extensions[0]); ++i) {
+        coco_join_path(data_file_path, sizeof(data_file_path), observer->result_folder, line, NULL);
+        if (strlen(data_file_path) > strlen(".dat"))
+          data_file_path[strlen(data_file_path) - strlen(".dat")] = '\0';
+        strncat(data_file_path, extensions[i], COCO_PATH_MAX - strlen(data_file_path) - 1);
+        logger_bbob_resume_truncate_data_file(data_file_path, number_of_runs);
+      }
+      if (entry != NULL)
+        *entry = ',';
+      *kept_end = '\0';
+
+      if (number_of_runs > 0) {
+        if (new_length > 0)
+          new_content[new_length++] = '\n';
+        new_length += (size_t) sprintf(new_content + new_length, "%s\n%%\n%s", header, line);
+      }
+      header = NULL;
+    }
+  }
+  if (header != NULL)
+    changed = 1;
+
+  if (changed) {
+    coco_warning("logger_bbob_resume(): removing unfinished runs from %s", file_path);
+    if (new_length == 0) {
+      remove(file_path);
+    } else {
+      file = fopen(file_path, "wb");
+      if (file == NULL) {
+        logger_bbob_error_io(file, errno);
+      }
+      fwrite(new_content, 1, new_length, file);
+      fclose(file);
+    }
+  }
+  coco_free_memory(new_content);
+  coco_free_memory(content);
+}
+
+/**
+ * @brief Prepares the result folder of the observer for resuming an interrupted experiment.
+ *
+ * Scans all index files, removes the output of unfinished runs and stores the finished runs in the
+ * observer (see coco_observer_is_run_completed()). New runs are written to new files with the prefix
+ * "bbobexp-rK" (with K the number of the resumption), as the names of the files of an earlier attempt
+ * could otherwise be reused for different runs.
+ */
+static void logger_bbob_resume(coco_observer_t *observer) {
+  char **index_files;
+  size_t number_of_index_files, i;
+  unsigned long resumption, last_resumption = 0;
+
+  index_files = coco_directory_list_files(observer->result_folder, ".info", &number_of_index_files);
+  for (i = 0; i < number_of_index_files; ++i) {
+    logger_bbob_resume_index_file(observer, index_files[i]);
+    if (sscanf(index_files[i], "bbobexp-r%lu_", &resumption) == 1 && resumption > last_resumption)
+      last_resumption = resumption;
+    coco_free_memory(index_files[i]);
+  }
+  if (index_files != NULL)
+    coco_free_memory(index_files);
+  if (number_of_index_files > 0)
+    sprintf(bbob_file_prefix, "bbobexp-r%lu", last_resumption + 1);
+  coco_info("Resuming experiment in %s with %lu completed runs", observer->result_folder,
+      (unsigned long) observer->number_of_completed_runs);
+}
+
 static coco_problem_t *logger_bbob(coco_observer_t *observer, coco_problem_t *inner_problem) {
   logger_bbob_data_t *logger_bbob;
   coco_problem_t *problem;
@@ -21700,6 +22724,7 @@ static coco_problem_t *logger_bbob(coco_observer_t *observer, coco_problem_t *in
   logger_bbob->bbob_number_of_dimensions = 0;
 
   problem->evaluate_function = logger_bbob_evaluate;
+  problem->evaluate_function_batch = logger_bbob_evaluate_batch;
   bbob_logger_is_open = 1;
   return problem;
 }
@@ -24016,6 +25041,10 @@ static coco_problem_t *logger_toy(coco_observer_t *observer, coco_problem_t *inn
  * of digits to be printed after the decimal point. The default value is 8.
  * - "precision_f: VALUE" defines the precision used when outputting f values and corresponds to the number of
  * digits to be printed after the decimal point. The default value is 15.
+ * - "resume: VALUE" with VALUE 1 continues an interrupted experiment: the output is appended to the
+ * result folder NAME itself (instead of NAME-001...). The logger removes the output of runs that were not
+ * finished and coco_observer_is_run_completed() tells which runs can be skipped. Currently only supported
+ * by the "bbob" observer. The default value is 0.
  *
  * @return The constructed observer object or NULL if observer_name equals NULL, "" or "no_observer".
  */
@@ -24024,7 +25053,7 @@ coco_observer_t *coco_observer(const char *observer_name, const char *observer_o
   coco_observer_t *observer;
   char *path, *result_folder, *algorithm_name, *algorithm_info;
   const char *outer_folder_name = "exdata";
-  int precision_x, precision_f;
+  int precision_x, precision_f, resume;
 
   size_t number_target_triggers;
   size_t number_evaluation_triggers;
@@ -24037,7 +25066,7 @@ coco_observer_t *coco_observer(const char *observer_name, const char *observer_o
    * IMPORTANT: This list should be up-to-date with the code and the documentation */
   const char *known_keys[] = { "result_folder", "algorithm_name", "algorithm_info",
       "number_target_triggers", "target_precision", "number_evaluation_triggers", "base_evaluation_triggers",
-      "precision_x", "precision_f" };
+      "precision_x", "precision_f", "resume" };
   additional_option_keys = NULL; /* To be set by the chosen observer */
 
   if (0 == strcmp(observer_name, "no_observer")) {
@@ -24055,11 +25084,18 @@ coco_observer_t *coco_observer(const char *observer_name, const char *observer_o
   if (coco_options_read_string(observer_options, "result_folder", result_folder) == 0) {
     strcpy(result_folder, "default");
   }
-  /* Create the result_folder inside the "exdata" folder */
+  resume = 0;
+  if (coco_options_read_int(observer_options, "resume", &resume) != 0) {
+    resume = resume != 0;
+  }
+  /* Create the result_folder inside the "exdata" folder (or reuse it when resuming) */
   path = coco_allocate_string(COCO_PATH_MAX + 1);
   memcpy(path, outer_folder_name, strlen(outer_folder_name) + 1);
   coco_join_path(path, COCO_PATH_MAX, result_folder, NULL);
-  coco_create_unique_directory(&path);
+  if (resume)
+    coco_create_directory(path);
+  else
+    coco_create_unique_directory(&path);
   coco_info("Results will be output to folder %s", path);
 
   if (coco_options_read_string(observer_options, "algorithm_name", algorithm_name) == 0) {
@@ -24108,6 +25144,7 @@ coco_observer_t *coco_observer(const char *observer_name, const char *observer_o
   observer = coco_observer_allocate(path, observer_name, algorithm_name, algorithm_info,
       number_target_triggers, target_precision, number_evaluation_triggers, base_evaluation_triggers,
       precision_x, precision_f);
+  observer->resume = resume;
 
   coco_free_memory(path);
   coco_free_memory(result_folder);
@@ -24137,6 +25174,10 @@ coco_observer_t *coco_observer(const char *observer_name, const char *observer_o
     coco_warning("Unknown observer!");
     return NULL;
   }
+  if (observer->resume && (observer->logger_allocate_function != logger_bbob)) {
+    coco_warning("coco_observer(): the observer %s does not support resuming, results are appended to %s",
+        observer_name, observer->result_folder);
+  }
 
   /* Check for redundant option keys */
   known_option_keys = coco_option_keys_allocate(sizeof(known_keys) / sizeof(char *), known_keys);
@@ -24250,6 +25291,31 @@ const char *coco_observer_get_result_folder(const coco_observer_t *observer) {
   return observer->result_folder;
 }
 
+/**
+ * Checks whether the run on the given problem was completed before the experiment was resumed (see the
+ * observer option "resume"). Such runs can be skipped, as their output is already in the result folder.
+ *
+ * @param observer The COCO observer.
+ * @param problem The (observed or unobserved) COCO problem from the observer's suite.
+ *
+ * @return 1 if the run (function, dimension and instance) was completed and 0 otherwise.
+ */
+int coco_observer_is_run_completed(const coco_observer_t *observer, const coco_problem_t *problem) {
+  size_t i;
+  const size_t *run;
+
+  if ((observer == NULL) || (problem == NULL))
+    return 0;
+  for (i = 0; i < observer->number_of_completed_runs; ++i) {
+    run = &observer->completed_runs[3 * i];
+    if ((run[0] == coco_problem_get_suite_dep_function(problem))
+        && (run[1] == coco_problem_get_dimension(problem))
+        && (run[2] == coco_problem_get_suite_dep_instance(problem)))
+      return 1;
+  }
+  return 0;
+}
+
 #line 1 "code-experiments/src/coco_archive.c"
 /**
  * @file coco_archive.c
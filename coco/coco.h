@@ -287,6 +287,11 @@ coco_problem_t *coco_problem_remove_observer(coco_problem_t *problem, coco_obser
  */
 const char *coco_observer_get_result_folder(const coco_observer_t *observer);
 
+/**
+ * @brief Returns whether the run on the given problem was completed before the experiment was resumed.
+ */
+int coco_observer_is_run_completed(const coco_observer_t *observer, const coco_problem_t *problem);
+
 /**@}*/
 
 /***********************************************************************************************************/
@@ -305,6 +310,24 @@ void coco_evaluate_function(coco_problem_t *problem, const double *x, double *y)
  */
 void coco_evaluate_constraint(coco_problem_t *problem, const double *x, double *y);
 
+/**
+ * @brief Evaluates the problem function in number_of_points points stored row by row in x and saves the
+ * results row by row in y.
+ */
+void coco_evaluate_function_batch(coco_problem_t *problem,
+                                  const double *x,
+                                  const size_t number_of_points,
+                                  double *y);
+
+/**
+ * @brief Evaluates the problem constraints in number_of_points points stored row by row in x and saves the
+ * results row by row in y.
+ */
+void coco_evaluate_constraint_batch(coco_problem_t *problem,
+                                    const double *x,
+                                    const size_t number_of_points,
+                                    double *y);
+
 /**
  * @brief Recommends a solution as the current best guesses to the problem. Not implemented yet.
  */
@@ -365,6 +388,12 @@ double coco_problem_get_best_observed_fvalue1(const coco_problem_t *problem);
  */
 double depreciated_coco_problem_get_final_target_fvalue1(const coco_problem_t *problem);
 
+/**
+ * @brief Returns the optimal value of the first objective (not meant to be used by the optimization
+ * algorithm, but e.g. for measuring its performance).
+ */
+double coco_problem_get_best_value(const coco_problem_t *problem);
+
 /**
  * @brief Returns a vector of size 'dimension' with lower bounds of the region of interest in
  * the decision space.
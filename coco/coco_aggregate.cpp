@@ -0,0 +1,576 @@
+/**
+ * Computes ERT and runtime ECDF tables of COCO result folders written by the bbob logger and compares two
+ * result folders for regressions.
+ *
+ * Usage:
+ *   coco_aggregate [--threads N] FOLDER
+ *   coco_aggregate [--threads N] [--tolerance T] BASE_FOLDER NEW_FOLDER
+ *
+ * With one folder, the ERT of every function and dimension and the runtime ECDF of every dimension are
+ * printed. With two folders, the ERT ratios NEW / BASE are printed and the exit status is 1 if the ERT of a
+ * target increased by more than the factor 1 + T (default 0.1) or a target reached in BASE was not reached
+ * in NEW (2 on errors).
+ *
+ * The result files are memory-mapped and tokenized in place (without copying lines or fields), the data
+ * files of different index entries are parsed in parallel.
+ */
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace {
+
+/**
+ * The targets (precisions) of the runtime ECDF: 10^2, 10^1.8, ..., 10^-8 as in the COCO post-processing.
+ */
+const int NUMBER_OF_TARGETS = 51;
+
+/**
+ * The ERT is reported for the targets with these indices (10^1, 10^-1, 10^-3, 10^-5, 10^-7).
+ */
+const int ERT_TARGETS[] = { 5, 15, 25, 35, 45 };
+const int NUMBER_OF_ERT_TARGETS = sizeof(ERT_TARGETS) / sizeof(ERT_TARGETS[0]);
+
+double target_precision(int target) {
+  return std::pow(10.0, (10 - target) / 5.0);
+}
+
+/**
+ * A read-only memory mapping of a whole file.
+ */
+class MappedFile {
+ public:
+  explicit MappedFile(const std::string &path) : m_data(NULL), m_size(0) {
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+      throw std::runtime_error("cannot open " + path + ": " + strerror(errno));
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+      close(fd);
+      throw std::runtime_error("cannot stat " + path + ": " + strerror(errno));
+    }
+    m_size = (size_t) st.st_size;
+    if (m_size > 0) {
+      void *data = mmap(NULL, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (data == MAP_FAILED) {
+        close(fd);
+        throw std::runtime_error("cannot map " + path + ": " + strerror(errno));
+      }
+      m_data = (const char *) data;
+      madvise(data, m_size, MADV_SEQUENTIAL);
+    }
+    close(fd);
+  }
+
+  ~MappedFile() {
+    if (m_data != NULL) {
+      munmap((void *) m_data, m_size);
+    }
+  }
+
+  const char *begin() const { return m_data; }
+  const char *end() const { return m_data + m_size; }
+
+ private:
+  MappedFile(const MappedFile &);
+  MappedFile &operator=(const MappedFile &);
+
+  const char *m_data;
+  size_t m_size;
+};
+
+/**
+ * A tokenizer over a character range of a mapped file. The range is not null-terminated, so all parsing is
+ * bounded by the end pointer.
+ */
+class Tokenizer {
+ public:
+  Tokenizer(const char *begin, const char *end) : m_pos(begin), m_end(end) {}
+
+  bool at_end() const { return m_pos >= m_end; }
+  char peek() const { return m_pos < m_end ? *m_pos : '\0'; }
+  const char *position() const { return m_pos; }
+
+  void skip_line() {
+    const char *newline = (const char *) memchr(m_pos, '\n', (size_t) (m_end - m_pos));
+    m_pos = newline == NULL ? m_end : newline + 1;
+  }
+
+  void skip_blanks() {
+    while (m_pos < m_end && (*m_pos == ' ' || *m_pos == '\t' || *m_pos == '\r')) {
+      ++m_pos;
+    }
+  }
+
+  /**
+   * Parses a non-negative integer (e.g. a number of evaluations).
+   */
+  unsigned long parse_unsigned() {
+    skip_blanks();
+    if (m_pos >= m_end || *m_pos < '0' || *m_pos > '9') {
+      throw std::runtime_error("integer expected");
+    }
+    unsigned long value = 0;
+    while (m_pos < m_end && *m_pos >= '0' && *m_pos <= '9') {
+      value = 10 * value + (unsigned long) (*m_pos++ - '0');
+    }
+    return value;
+  }
+
+  /**
+   * Parses a floating point number in the format written by the logger ("+1.234567890e-05").
+   *
+   * Mantissas of up to 15 digits with small decimal exponents are converted exactly like strtod (one
+   * correctly rounded multiplication or division by an exact power of ten), all other numbers are
+   * converted by strtod on a copy of the token.
+   */
+  double parse_double() {
+    static const double POWERS_OF_TEN[] = {
+      1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+      1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+    skip_blanks();
+    const char *start = m_pos;
+    bool negative = false;
+    if (m_pos < m_end && (*m_pos == '+' || *m_pos == '-')) {
+      negative = *m_pos++ == '-';
+    }
+    unsigned long long mantissa = 0;
+    int digits = 0, exponent = 0;
+    bool any_digit = false;
+    for (; m_pos < m_end && *m_pos >= '0' && *m_pos <= '9'; ++m_pos, any_digit = true) {
+      if (mantissa != 0 || *m_pos != '0') {
+        ++digits;
+      }
+      mantissa = 10 * mantissa + (unsigned long long) (*m_pos - '0');
+    }
+    if (m_pos < m_end && *m_pos == '.') {
+      for (++m_pos; m_pos < m_end && *m_pos >= '0' && *m_pos <= '9'; ++m_pos, any_digit = true) {
+        if (mantissa != 0 || *m_pos != '0') {
+          ++digits;
+        }
+        mantissa = 10 * mantissa + (unsigned long long) (*m_pos - '0');
+        --exponent;
+      }
+    }
+    if (any_digit && m_pos < m_end && (*m_pos == 'e' || *m_pos == 'E')) {
+      ++m_pos;
+      bool negative_exponent = false;
+      if (m_pos < m_end && (*m_pos == '+' || *m_pos == '-')) {
+        negative_exponent = *m_pos++ == '-';
+      }
+      int value = 0;
+      while (m_pos < m_end && *m_pos >= '0' && *m_pos <= '9' && value < 100000) {
+        value = 10 * value + (*m_pos++ - '0');
+      }
+      exponent += negative_exponent ? -value : value;
+    }
+    const bool is_simple = any_digit && digits <= 15 && exponent >= -22 && exponent <= 22 &&
+        (m_pos >= m_end || *m_pos == ' ' || *m_pos == '\t' || *m_pos == '\r' || *m_pos == '\n');
+    if (is_simple) {
+      /* A mantissa of at most 15 digits is exact in a double */
+      double value = (double) mantissa;
+      value = exponent < 0 ? value / POWERS_OF_TEN[-exponent] : value * POWERS_OF_TEN[exponent];
+      return negative ? -value : value;
+    }
+
+    /* Uncommon formats (inf, nan, long mantissas, large exponents) */
+    while (m_pos < m_end && *m_pos != ' ' && *m_pos != '\t' && *m_pos != '\r' && *m_pos != '\n') {
+      ++m_pos;
+    }
+    const std::string token(start, m_pos);
+    char *token_end = NULL;
+    const double value = strtod(token.c_str(), &token_end);
+    if (token.empty() || *token_end != '\0') {
+      throw std::runtime_error("number expected instead of '" + token + "'");
+    }
+    return value;
+  }
+
+ private:
+  const char *m_pos;
+  const char *m_end;
+};
+
+/**
+ * The result of one run: the number of evaluations (objective plus constraint evaluations) after which
+ * each target was reached (0 if it was not reached) and the number of evaluations of the whole run.
+ */
+struct Run {
+  unsigned long instance;
+  unsigned long evaluations;
+  unsigned long runtimes[NUMBER_OF_TARGETS];
+};
+
+/**
+ * An index entry: a data file with the runs on several instances of a function and dimension.
+ */
+struct Group {
+  int function;
+  int dimension;
+  std::string data_path;
+  std::vector<unsigned long> instances;
+  /* The block of each run in the data files (unfinished runs, which are skipped, have blocks as well) */
+  std::vector<size_t> blocks;
+  size_t number_of_blocks;
+  std::vector<Run> runs;
+};
+
+/**
+ * Returns the positions of the blocks (one per run) of a data file. Every block starts with a "%" line.
+ */
+std::vector<std::pair<const char *, const char *> > split_blocks(const MappedFile &file) {
+  std::vector<std::pair<const char *, const char *> > blocks;
+  Tokenizer tokenizer(file.begin(), file.end());
+  while (!tokenizer.at_end()) {
+    const char *line = tokenizer.position();
+    if (tokenizer.peek() == '%') {
+      if (!blocks.empty()) {
+        blocks.back().second = line;
+      }
+      blocks.push_back(std::make_pair(line, file.end()));
+    }
+    tokenizer.skip_line();
+  }
+  return blocks;
+}
+
+/**
+ * Parses the data files of a group. The rows of the .dat file are "f-evaluations g-evaluations precision
+ * ...", the last row of a block of the .tdat file contains the evaluations of the whole run.
+ */
+void parse_group(const std::string &folder, Group &group) {
+  const std::string base = folder + "/" + group.data_path.substr(0, group.data_path.rfind('.'));
+  const MappedFile dat(base + ".dat");
+  const MappedFile tdat(base + ".tdat");
+  const std::vector<std::pair<const char *, const char *> > dat_blocks = split_blocks(dat);
+  const std::vector<std::pair<const char *, const char *> > tdat_blocks = split_blocks(tdat);
+  if (dat_blocks.size() != group.number_of_blocks || tdat_blocks.size() != group.number_of_blocks) {
+    throw std::runtime_error(base + ": the number of runs does not match the index file");
+  }
+
+  group.runs.resize(group.instances.size());
+  for (size_t i = 0; i < group.instances.size(); ++i) {
+    const size_t block = group.blocks[i];
+    Run &run = group.runs[i];
+    run.instance = group.instances[i];
+    run.evaluations = 0;
+    std::fill(run.runtimes, run.runtimes + NUMBER_OF_TARGETS, 0UL);
+
+    int next_target = 0;
+    double next_precision = target_precision(0);
+    Tokenizer dat_tokenizer(dat_blocks[block].first, dat_blocks[block].second);
+    for (dat_tokenizer.skip_line(); !dat_tokenizer.at_end(); dat_tokenizer.skip_line()) {
+      if (dat_tokenizer.peek() == '%' || dat_tokenizer.peek() == '\n') {
+        continue;
+      }
+      const unsigned long evaluations = dat_tokenizer.parse_unsigned() + dat_tokenizer.parse_unsigned();
+      const double precision = dat_tokenizer.parse_double();
+      while (next_target < NUMBER_OF_TARGETS && precision <= next_precision) {
+        run.runtimes[next_target++] = evaluations;
+        next_precision = target_precision(next_target);
+      }
+      run.evaluations = std::max(run.evaluations, evaluations);
+    }
+
+    Tokenizer tdat_tokenizer(tdat_blocks[block].first, tdat_blocks[block].second);
+    const char *last_row = NULL;
+    for (tdat_tokenizer.skip_line(); !tdat_tokenizer.at_end(); tdat_tokenizer.skip_line()) {
+      if (tdat_tokenizer.peek() != '%' && tdat_tokenizer.peek() != '\n') {
+        last_row = tdat_tokenizer.position();
+      }
+    }
+    if (last_row != NULL) {
+      Tokenizer row(last_row, tdat_blocks[block].second);
+      run.evaluations = std::max(run.evaluations, row.parse_unsigned() + row.parse_unsigned());
+    }
+  }
+}
+
+/**
+ * Parses the header value "key = value" of an index file line.
+ */
+int parse_header_value(const char *begin, const char *end, const char *key) {
+  const size_t key_length = strlen(key);
+  for (const char *pos = begin; pos + key_length <= end; ++pos) {
+    if (memcmp(pos, key, key_length) == 0) {
+      Tokenizer tokenizer(pos + key_length, end);
+      return (int) tokenizer.parse_unsigned();
+    }
+  }
+  throw std::runtime_error(std::string("missing '") + key + "' in index file");
+}
+
+/**
+ * Parses an index file: groups of a header line, a comment line and a line
+ * "data_path, instance:evaluations|precision, ...".
+ */
+void parse_index_file(const std::string &path, std::vector<Group> &groups) {
+  const MappedFile file(path);
+  Tokenizer tokenizer(file.begin(), file.end());
+  int function = 0, dimension = 0;
+  while (!tokenizer.at_end()) {
+    const char *line = tokenizer.position();
+    tokenizer.skip_line();
+    const char *line_end = tokenizer.position();
+    while (line_end > line && (line_end[-1] == '\n' || line_end[-1] == '\r')) {
+      --line_end;
+    }
+    if (line == line_end || *line == '%') {
+      continue;
+    }
+    const char *comma = (const char *) memchr(line, ',', (size_t) (line_end - line));
+    const char *slash = (const char *) memchr(line, '/', (size_t) (line_end - line));
+    if (slash == NULL || (comma != NULL && comma < slash)) {
+      function = parse_header_value(line, line_end, "funcId = ");
+      dimension = parse_header_value(line, line_end, "DIM = ");
+      continue;
+    }
+
+    Group group;
+    group.function = function;
+    group.dimension = dimension;
+    group.data_path.assign(line, comma == NULL ? line_end : comma);
+    group.number_of_blocks = 0;
+    while (comma != NULL) {
+      Tokenizer entry(comma + 1, line_end);
+      const unsigned long instance = entry.parse_unsigned();
+      comma = (const char *) memchr(comma + 1, ',', (size_t) (line_end - comma - 1));
+      const char *entry_end = comma == NULL ? line_end : comma;
+      const size_t block = group.number_of_blocks++;
+      if (memchr(entry.position(), '|', (size_t) (entry_end - entry.position())) == NULL) {
+        /* The run was not finished, its block is skipped */
+        std::cerr << "Warning: skipping an unfinished run in " << path << std::endl;
+        continue;
+      }
+      group.instances.push_back(instance);
+      group.blocks.push_back(block);
+    }
+    groups.push_back(group);
+  }
+}
+
+/**
+ * The runs of a result folder by function and dimension.
+ */
+typedef std::map<std::pair<int, int>, std::vector<Run> > Results;
+
+Results load_results(const std::string &folder, unsigned number_of_threads) {
+  std::vector<Group> groups;
+  DIR *dir = opendir(folder.c_str());
+  if (dir == NULL) {
+    throw std::runtime_error("cannot open " + folder + ": " + strerror(errno));
+  }
+  std::vector<std::string> index_files;
+  struct dirent *entry;
+  while ((entry = readdir(dir)) != NULL) {
+    const std::string name = entry->d_name;
+    if (name.size() > 5 && name.compare(name.size() - 5, 5, ".info") == 0) {
+      index_files.push_back(folder + "/" + name);
+    }
+  }
+  closedir(dir);
+  std::sort(index_files.begin(), index_files.end());
+  for (size_t i = 0; i < index_files.size(); ++i) {
+    parse_index_file(index_files[i], groups);
+  }
+
+  /* The groups are independent: every thread takes the next unparsed group */
+  std::atomic<size_t> next_group(0);
+  std::vector<std::string> errors(number_of_threads);
+  std::vector<std::thread> threads;
+  for (unsigned t = 0; t < number_of_threads; ++t) {
+    threads.push_back(std::thread([&, t]() {
+      try {
+        for (size_t i = next_group++; i < groups.size(); i = next_group++) {
+          parse_group(folder, groups[i]);
+        }
+      } catch (const std::exception &e) {
+        errors[t] = e.what();
+        next_group = groups.size();
+      }
+    }));
+  }
+  for (size_t t = 0; t < threads.size(); ++t) {
+    threads[t].join();
+  }
+  for (size_t t = 0; t < errors.size(); ++t) {
+    if (!errors[t].empty()) {
+      throw std::runtime_error(errors[t]);
+    }
+  }
+
+  Results results;
+  for (size_t i = 0; i < groups.size(); ++i) {
+    std::vector<Run> &runs = results[std::make_pair(groups[i].function, groups[i].dimension)];
+    runs.insert(runs.end(), groups[i].runs.begin(), groups[i].runs.end());
+  }
+  return results;
+}
+
+/**
+ * The expected running time to reach the target: the evaluations of all runs (up to the target in the
+ * successful runs) divided by the number of successful runs. Infinite if no run reached the target.
+ */
+double expected_running_time(const std::vector<Run> &runs, int target) {
+  double evaluations = 0;
+  size_t successes = 0;
+  for (size_t i = 0; i < runs.size(); ++i) {
+    if (runs[i].runtimes[target] > 0) {
+      evaluations += (double) runs[i].runtimes[target];
+      ++successes;
+    } else {
+      evaluations += (double) runs[i].evaluations;
+    }
+  }
+  return successes == 0 ? std::numeric_limits<double>::infinity() : evaluations / (double) successes;
+}
+
+void print_results(const Results &results) {
+  printf("%% ERT (evaluations) to reach the precision\n");
+  printf("%-4s %4s %5s", "f", "dim", "runs");
+  for (int j = 0; j < NUMBER_OF_ERT_TARGETS; ++j) {
+    printf(" %11.0e", target_precision(ERT_TARGETS[j]));
+  }
+  printf("\n");
+  std::map<int, std::vector<const Run *> > runs_by_dimension;
+  for (Results::const_iterator it = results.begin(); it != results.end(); ++it) {
+    printf("f%-3d %4d %5lu", it->first.first, it->first.second, (unsigned long) it->second.size());
+    for (int j = 0; j < NUMBER_OF_ERT_TARGETS; ++j) {
+      printf(" %11.4g", expected_running_time(it->second, ERT_TARGETS[j]));
+    }
+    printf("\n");
+    for (size_t i = 0; i < it->second.size(); ++i) {
+      runs_by_dimension[it->first.second].push_back(&it->second[i]);
+    }
+  }
+
+  /* Fraction of the (run, target) pairs reached after dimension * 10^k evaluations */
+  printf("\n%% Runtime ECDF over all functions and %d targets 1e+02..1e-08 after dim * 10^k evaluations\n",
+         NUMBER_OF_TARGETS);
+  printf("%-4s %5s", "dim", "runs");
+  for (int k = 0; k <= 6; ++k) {
+    printf(" %6s%d", "k=", k);
+  }
+  printf("\n");
+  for (std::map<int, std::vector<const Run *> >::const_iterator it = runs_by_dimension.begin();
+       it != runs_by_dimension.end(); ++it) {
+    printf("%-4d %5lu", it->first, (unsigned long) it->second.size());
+    for (int k = 0; k <= 6; ++k) {
+      const double budget = it->first * std::pow(10.0, k);
+      size_t reached = 0;
+      for (size_t i = 0; i < it->second.size(); ++i) {
+        for (int target = 0; target < NUMBER_OF_TARGETS; ++target) {
+          const unsigned long runtime = it->second[i]->runtimes[target];
+          reached += runtime > 0 && (double) runtime <= budget;
+        }
+      }
+      printf(" %7.4f", (double) reached / (double) (it->second.size() * NUMBER_OF_TARGETS));
+    }
+    printf("\n");
+  }
+}
+
+/**
+ * Prints the ERT ratios and returns the number of regressions.
+ */
+size_t compare_results(const Results &base, const Results &other, double tolerance) {
+  size_t number_of_regressions = 0;
+  printf("%% ERT ratio NEW / BASE to reach the precision (! regression, + improvement)\n");
+  printf("%-4s %4s", "f", "dim");
+  for (int j = 0; j < NUMBER_OF_ERT_TARGETS; ++j) {
+    printf(" %10.0e", target_precision(ERT_TARGETS[j]));
+  }
+  printf("\n");
+  for (Results::const_iterator it = base.begin(); it != base.end(); ++it) {
+    const Results::const_iterator other_it = other.find(it->first);
+    if (other_it == other.end()) {
+      printf("f%-3d %4d missing in NEW\n", it->first.first, it->first.second);
+      ++number_of_regressions;
+      continue;
+    }
+    printf("f%-3d %4d", it->first.first, it->first.second);
+    for (int j = 0; j < NUMBER_OF_ERT_TARGETS; ++j) {
+      const double base_ert = expected_running_time(it->second, ERT_TARGETS[j]);
+      const double other_ert = expected_running_time(other_it->second, ERT_TARGETS[j]);
+      if (std::isinf(base_ert) && std::isinf(other_ert)) {
+        printf(" %10s", "-");
+      } else if (std::isinf(other_ert)) {
+        printf(" %9s!", "inf");
+        ++number_of_regressions;
+      } else if (std::isinf(base_ert)) {
+        printf(" %9s+", "0");
+      } else {
+        const double ratio = other_ert / base_ert;
+        const bool regression = ratio > 1 + tolerance;
+        number_of_regressions += regression;
+        printf(" %9.3f%c", ratio, regression ? '!' : (ratio < 1 / (1 + tolerance) ? '+' : ' '));
+      }
+    }
+    printf("\n");
+  }
+  return number_of_regressions;
+}
+
+void print_usage(const char *program) {
+  std::cerr << "Usage: " << program << " [--threads N] [--tolerance T] FOLDER [NEW_FOLDER]" << std::endl;
+}
+
+}
+
+int main(int argc, char *argv[]) {
+  unsigned number_of_threads = std::max(1U, std::thread::hardware_concurrency());
+  double tolerance = 0.1;
+  std::vector<std::string> folders;
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    if (arg == "--threads" && i + 1 < argc) {
+      number_of_threads = (unsigned) std::max(1, atoi(argv[++i]));
+    } else if (arg == "--tolerance" && i + 1 < argc) {
+      tolerance = atof(argv[++i]);
+    } else if (arg.compare(0, 2, "--") == 0) {
+      print_usage(argv[0]);
+      return EXIT_FAILURE;
+    } else {
+      folders.push_back(arg);
+    }
+  }
+  if (folders.empty() || folders.size() > 2) {
+    print_usage(argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  try {
+    const Results base = load_results(folders[0], number_of_threads);
+    if (folders.size() == 1) {
+      print_results(base);
+      return EXIT_SUCCESS;
+    }
+    const Results other = load_results(folders[1], number_of_threads);
+    const size_t number_of_regressions = compare_results(base, other, tolerance);
+    printf("\n%lu regressions\n", (unsigned long) number_of_regressions);
+    return number_of_regressions == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+  } catch (const std::exception &e) {
+    std::cerr << "Error: " << e.what() << std::endl;
+    return 2;
+  }
+}
@@ -0,0 +1,214 @@
+/**
+ * Implementation of the benchmark problems and runs (see coco_benchmark.h).
+ */
+#include "coco_benchmark.h"
+
+#include <math.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <sstream>
+
+#include <es/core/util.h>
+#include <es/rayes/RayEs.h>
+
+namespace {
+
+class StopRunException : public std::exception {
+};
+
+std::string dimension_suffix(size_t dimension) {
+  std::ostringstream stream;
+  stream << "_d" << (dimension < 10 ? "0" : "") << dimension;
+  return stream.str();
+}
+
+}
+
+/**
+ * By the Lagrange conditions, fopt = n / sum_i (1 / a_i).
+ */
+BenchmarkProblem benchmark_ellipsoid_linear(const std::string &name, int dimension, double condition) {
+  Eigen::VectorXd weights(dimension);
+  for (int i = 0; i < dimension; ++i) {
+    weights(i) = dimension == 1 ? 1.0 : pow(condition, (double) i / (dimension - 1));
+  }
+  BenchmarkProblem problem;
+  problem.name = name + dimension_suffix((size_t) dimension);
+  problem.objective = [weights](const Eigen::VectorXd &x) {
+    return weights.dot(x.cwiseProduct(x));
+  };
+  problem.constraint = [dimension](const Eigen::VectorXd &x) {
+    Eigen::VectorXd y(1);
+    y(0) = sqrt((double) dimension) - x.sum();
+    return y;
+  };
+  problem.lbnds = Eigen::VectorXd::Constant(dimension, -5.0);
+  problem.ubnds = Eigen::VectorXd::Constant(dimension, 5.0);
+  problem.origin = Eigen::VectorXd::Constant(dimension, 2.0);
+  problem.fopt = dimension / weights.cwiseInverse().sum();
+  problem.coco_problem = NULL;
+  return problem;
+}
+
+BenchmarkProblem benchmark_coco_constrained(coco_suite_t *suite, size_t function, size_t dimension,
+                                            size_t instance) {
+  coco_problem_t *coco_problem =
+      coco_suite_get_problem_by_function_dimension_instance(suite, function, dimension, instance);
+  const size_t number_of_constraints = coco_problem_get_number_of_constraints(coco_problem);
+  const double *lower_bounds = coco_problem_get_smallest_values_of_interest(coco_problem);
+  const double *upper_bounds = coco_problem_get_largest_values_of_interest(coco_problem);
+
+  BenchmarkProblem problem;
+  std::ostringstream stream;
+  stream << "bbob-constrained_f" << (function < 10 ? "0" : "") << function;
+  if (instance != 1) {
+    stream << "_i" << (instance < 10 ? "0" : "") << instance;
+  }
+  problem.name = stream.str() + dimension_suffix(dimension);
+  problem.objective = [coco_problem](const Eigen::VectorXd &x) {
+    double y;
+    coco_evaluate_function(coco_problem, x.data(), &y);
+    return y;
+  };
+  problem.constraint = [coco_problem, number_of_constraints](const Eigen::VectorXd &x) {
+    Eigen::VectorXd y(number_of_constraints);
+    coco_evaluate_constraint(coco_problem, x.data(), y.data());
+    return y;
+  };
+  problem.lbnds = Eigen::Map<const Eigen::VectorXd>(lower_bounds, (Eigen::Index) dimension);
+  problem.ubnds = Eigen::Map<const Eigen::VectorXd>(upper_bounds, (Eigen::Index) dimension);
+  problem.origin.resize((Eigen::Index) dimension);
+  coco_problem_get_initial_solution(coco_problem, problem.origin.data());
+  problem.fopt = coco_problem_get_best_value(coco_problem);
+  problem.coco_problem = coco_problem;
+  return problem;
+}
+
+void benchmark_problem_free(BenchmarkProblem &problem) {
+  if (problem.coco_problem != NULL) {
+    coco_problem_free(problem.coco_problem);
+    problem.coco_problem = NULL;
+  }
+}
+
+BenchmarkOptions::BenchmarkOptions()
+    : stop_at_target(true), batch(false), line_search(es::rayes::LineSearchAlg::Modified) {
+}
+
+std::vector<BenchmarkProblem> benchmark_standard_problems(coco_suite_t *suite) {
+  std::vector<BenchmarkProblem> problems;
+  problems.push_back(benchmark_ellipsoid_linear("sphere-linear", 2, 1.0));
+  problems.push_back(benchmark_ellipsoid_linear("sphere-linear", 10, 1.0));
+  problems.push_back(benchmark_ellipsoid_linear("ellipsoid-linear", 5, 1e2));
+  problems.push_back(benchmark_coco_constrained(suite, 1, 2, 1));
+  problems.push_back(benchmark_coco_constrained(suite, 8, 3, 1));
+  problems.push_back(benchmark_coco_constrained(suite, 20, 5, 1));
+  problems.push_back(benchmark_coco_constrained(suite, 31, 3, 1));
+  return problems;
+}
+
+BenchmarkRun benchmark_run(const BenchmarkProblem &problem, const es::rayes::Parameters &parameters,
+                           long budget_multiplier, double precision, const BenchmarkOptions &options) {
+  typedef std::chrono::steady_clock clock;
+  const long budget = budget_multiplier * problem.lbnds.rows();
+  const double target = problem.fopt + precision * std::max(1.0, fabs(problem.fopt));
+  std::atomic<long> evaluations(0);
+  /* The evaluations when the target was reached first (0: not reached) */
+  std::atomic<long> reached_evaluations(0);
+  clock::duration function_time = clock::duration::zero();
+  /* With parallel line searches, COCO problems (which are not thread-safe) are evaluated under the mutex,
+   * synthetic problems only accumulate their time under it */
+  const bool parallel = parameters.numThreads > 1;
+  std::mutex mutex;
+
+  auto objective = [&](const Eigen::VectorXd &x) {
+    const long evaluation = ++evaluations;
+    if (evaluation > budget) {
+      throw StopRunException();
+    }
+    std::unique_lock<std::mutex> lock(mutex, std::defer_lock);
+    if (parallel && problem.coco_problem != NULL) {
+      lock.lock();
+    }
+    const clock::time_point start = clock::now();
+    const double y = problem.objective(x);
+    const clock::duration time = clock::now() - start;
+    if (parallel && !lock.owns_lock()) {
+      lock.lock();
+    }
+    function_time += time;
+    /* The Ray-ES evaluates the objective function only at feasible points */
+    if (y <= target) {
+      long not_reached = 0;
+      reached_evaluations.compare_exchange_strong(not_reached, evaluation);
+      if (options.stop_at_target) {
+        throw StopRunException();
+      }
+    }
+    return y;
+  };
+  auto constraint = [&](const Eigen::VectorXd &x) {
+    if (++evaluations > budget) {
+      throw StopRunException();
+    }
+    std::unique_lock<std::mutex> lock(mutex, std::defer_lock);
+    if (parallel && problem.coco_problem != NULL) {
+      lock.lock();
+    }
+    const clock::time_point start = clock::now();
+    const Eigen::VectorXd y = problem.constraint(x);
+    const clock::duration time = clock::now() - start;
+    if (parallel && !lock.owns_lock()) {
+      lock.lock();
+    }
+    function_time += time;
+    return y;
+  };
+
+  /* The batch functions evaluate the points one by one, so the evaluations are counted as above */
+  auto batch_objective = [&](const Eigen::MatrixXd &points) {
+    Eigen::VectorXd y(points.cols());
+    for (int k = 0; k < points.cols(); ++k) {
+      y(k) = objective(points.col(k));
+    }
+    return y;
+  };
+  auto batch_constraint = [&](const Eigen::MatrixXd &points) {
+    Eigen::MatrixXd y;
+    for (int k = 0; k < points.cols(); ++k) {
+      const Eigen::VectorXd c = constraint(points.col(k));
+      y.resize(c.rows(), points.cols());
+      y.col(k) = c;
+    }
+    return y;
+  };
+
+  std::unique_ptr<es::rayes::RayEs> solver(options.batch ?
+      new es::rayes::RayEs(batch_objective, batch_constraint, problem.lbnds, problem.ubnds, problem.origin,
+                           options.line_search, parameters) :
+      new es::rayes::RayEs(objective, constraint, problem.lbnds, problem.ubnds, problem.origin,
+                           options.line_search, parameters));
+  BenchmarkRun run;
+  run.best_f = std::numeric_limits<double>::infinity();
+  const clock::time_point start = clock::now();
+  try {
+    const es::rayes::Info info = solver->run();
+    run.best_f = info.getBestIndividual().f();
+    run.termination = es::core::toString(info.getTerminationCriterion());
+  } catch (StopRunException &) {
+    run.termination = reached_evaluations > 0 && options.stop_at_target ? "TargetReached" : "BudgetExhausted";
+  }
+
+  const clock::duration wall_time = clock::now() - start;
+  run.evaluations = reached_evaluations > 0 ? (double) reached_evaluations :
+      std::numeric_limits<double>::infinity();
+  run.evaluations_done = std::min(evaluations.load(), budget);
+  run.optimizer_time = std::chrono::duration<double, std::micro>(wall_time - function_time).count();
+  run.wall_time = std::chrono::duration<double, std::micro>(wall_time).count();
+  return run;
+}
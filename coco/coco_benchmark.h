@@ -0,0 +1,97 @@
+/**
+ * Benchmark problems with known optimal values and a measured Ray-ES run on them, shared by the regression
+ * gate (coco_regression) and the parameter tuner (coco_tune).
+ */
+#ifndef COCO_BENCHMARK_H
+#define COCO_BENCHMARK_H
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <Eigen/Dense>
+
+#include <es/rayes/Parameters.h>
+
+#include "coco.h"
+
+/**
+ * A problem with known optimal value fopt and a feasible initial ray origin.
+ */
+struct BenchmarkProblem {
+  std::string name;
+  std::function<double(const Eigen::VectorXd &)> objective;
+  std::function<Eigen::VectorXd(const Eigen::VectorXd &)> constraint;
+  Eigen::VectorXd lbnds;
+  Eigen::VectorXd ubnds;
+  Eigen::VectorXd origin;
+  double fopt;
+  /* The COCO problem evaluated by the functions (NULL for synthetic problems) */
+  coco_problem_t *coco_problem;
+};
+
+/**
+ * The result of a run.
+ */
+struct BenchmarkRun {
+  /* The evaluations (objective plus constraint) to reach the target, infinite if it was not reached */
+  double evaluations;
+  /* The evaluations of the whole run */
+  long evaluations_done;
+  /* The time in microseconds that was not spent in the problem functions (summed over the threads of parallel
+   * line searches, so only meaningful for sequential runs) */
+  double optimizer_time;
+  /* The time of the run in microseconds */
+  double wall_time;
+  /* The best objective function value of a run that terminated by itself (infinite otherwise) */
+  double best_f;
+  /* The termination criterion of the Ray-ES, "TargetReached" or "BudgetExhausted" */
+  std::string termination;
+};
+
+/**
+ * How benchmark_run() runs the Ray-ES.
+ */
+struct BenchmarkOptions {
+  BenchmarkOptions();
+
+  /* Whether the run is stopped when the target is reached (otherwise it continues until the Ray-ES
+   * terminates or the budget is exhausted) */
+  bool stop_at_target;
+  /* Whether the functions are evaluated through the batch interface of the Ray-ES */
+  bool batch;
+  /* The line search of the Ray-ES (Modified by default) */
+  es::rayes::LineSearchAlg line_search;
+};
+
+/**
+ * Returns the problem min sum_i a_i x_i^2 subject to sum_i x_i >= sqrt(n) in [-5, 5]^n with
+ * a_i = condition^(i / (n - 1)).
+ */
+BenchmarkProblem benchmark_ellipsoid_linear(const std::string &name, int dimension, double condition);
+
+/**
+ * Returns a problem of the bbob-constrained suite. The problem must be freed with benchmark_problem_free().
+ * Problems of different threads must not be allocated concurrently.
+ */
+BenchmarkProblem benchmark_coco_constrained(coco_suite_t *suite, size_t function, size_t dimension,
+                                            size_t instance);
+
+void benchmark_problem_free(BenchmarkProblem &problem);
+
+/**
+ * Returns the problems of the regression gate: synthetic problems with linear constraints and problems of the
+ * bbob-constrained suite (instance 1). They must be freed with benchmark_problem_free().
+ */
+std::vector<BenchmarkProblem> benchmark_standard_problems(coco_suite_t *suite);
+
+/**
+ * Runs the Ray-ES (with the line search of the options) until (f - fopt) / max(1, |fopt|) <= precision or
+ * dimension * budget_multiplier evaluations are done. The problem may be run with parameters.numThreads > 1
+ * (COCO problems are then evaluated one at a time).
+ */
+BenchmarkRun benchmark_run(const BenchmarkProblem &problem, const es::rayes::Parameters &parameters,
+                           long budget_multiplier, double precision,
+                           const BenchmarkOptions &options = BenchmarkOptions());
+
+#endif
@@ -0,0 +1,205 @@
+/**
+ * A statistical equivalence harness for the execution modes of the Ray-ES: runs the reference mode and an
+ * optimized mode (parallel line searches, batch evaluation, mixed precision, ...) on the problems of the
+ * regression gate with the same seeds until the Ray-ES terminates by itself, and compares per problem the
+ * distributions of the final objective function value, the evaluations to reach the target and the
+ * termination criteria. The wall times of both modes are reported side by side.
+ *
+ * Usage:
+ *   coco_equivalence [--reference FILE] [--parameters FILE] [--batch] [--seeds N] [--alpha A]
+ *                    [--resolution R]
+ *
+ * The reference mode runs with the default parameters (or the parameter file given by --reference) and the
+ * per-point functions, the optimized mode with the parameter file given by --parameters and, with --batch,
+ * through the batch interface. The final values (precision (f - fopt) / max(1, |fopt|); values below the
+ * resolution R = 1e-8 are considered equal since they differ by rounding only) and the evaluations to the
+ * target are compared with two-sided Kolmogorov-Smirnov and Mann-Whitney U tests, the termination criteria
+ * with a chi-square test. The exit status is 1 if a test is significant at the level alpha
+ * (Bonferroni corrected over all tests), i.e. the optimized mode changes the convergence behavior. Modes
+ * that keep the results bit-identical yield p-values of 1.
+ */
+#include <math.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+#include <algorithm>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <es/core/Statistics.h>
+
+#include "coco.h"
+#include "coco_benchmark.h"
+
+namespace {
+
+/**
+ * The target of the evaluations to reach it, as in the regression gate.
+ */
+const double TARGET_PRECISION = 1e-4;
+
+/**
+ * The evaluation budget of a run equals dimension * BUDGET_MULTIPLIER (runs that exhaust it have no final
+ * value).
+ */
+const long BUDGET_MULTIPLIER = 50000;
+
+/**
+ * The runs of a mode on a problem.
+ */
+struct Runs {
+  std::vector<double> precisions;
+  std::vector<double> evaluations;
+  std::map<std::string, int> terminations;
+  double wall_time;
+};
+
+void add_run(Runs &runs, const BenchmarkProblem &problem, const BenchmarkRun &run, double resolution) {
+  const double precision = (run.best_f - problem.fopt) / std::max(1.0, fabs(problem.fopt));
+  runs.precisions.push_back(std::max(resolution, precision));
+  runs.evaluations.push_back(run.evaluations);
+  ++runs.terminations[run.termination];
+  runs.wall_time += run.wall_time;
+}
+
+/**
+ * Prints the medians and the p-values of the Kolmogorov-Smirnov and the Mann-Whitney U test of a metric.
+ * Returns the number of significant tests.
+ */
+int compare(const std::vector<double> &reference, const std::vector<double> &mode, double alpha) {
+  const double p_ks = es::core::kolmogorovSmirnovTest(reference, mode);
+  const double p_mw = es::core::mannWhitneyUTestTwoSided(reference, mode);
+  printf(" %10.3g %10.3g %7.1e%c %7.1e%c", es::core::median(reference), es::core::median(mode), p_ks,
+         p_ks < alpha ? '!' : ' ', p_mw, p_mw < alpha ? '!' : ' ');
+  return (p_ks < alpha) + (p_mw < alpha);
+}
+
+/**
+ * Prints the p-value of the chi-square test of the termination criteria. Returns whether it is significant.
+ */
+int compare_terminations(const Runs &reference, const Runs &mode, double alpha) {
+  std::map<std::string, int> criteria = reference.terminations;
+  criteria.insert(mode.terminations.begin(), mode.terminations.end());
+  std::vector<int> counts_reference, counts_mode;
+  for (std::map<std::string, int>::const_iterator it = criteria.begin(); it != criteria.end(); ++it) {
+    const std::map<std::string, int>::const_iterator in_reference = reference.terminations.find(it->first);
+    const std::map<std::string, int>::const_iterator in_mode = mode.terminations.find(it->first);
+    counts_reference.push_back(in_reference == reference.terminations.end() ? 0 : in_reference->second);
+    counts_mode.push_back(in_mode == mode.terminations.end() ? 0 : in_mode->second);
+  }
+  const double p = es::core::chiSquareTest(counts_reference, counts_mode);
+  printf(" %7.1e%c", p, p < alpha ? '!' : ' ');
+  return p < alpha;
+}
+
+void print_terminations(const std::map<std::string, int> &terminations) {
+  for (std::map<std::string, int>::const_iterator it = terminations.begin(); it != terminations.end(); ++it) {
+    printf(" %s:%d", it->first.c_str(), it->second);
+  }
+}
+
+}
+
+int main(int argc, char *argv[]) {
+  unsigned number_of_seeds = 15;
+  double alpha = 0.05;
+  double resolution = 1e-8;
+  std::string reference_path, parameters_path;
+  BenchmarkOptions reference_options, mode_options;
+  reference_options.stop_at_target = false;
+  mode_options.stop_at_target = false;
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    if (arg == "--reference" && i + 1 < argc) {
+      reference_path = argv[++i];
+    } else if (arg == "--parameters" && i + 1 < argc) {
+      parameters_path = argv[++i];
+    } else if (arg == "--batch") {
+      mode_options.batch = true;
+    } else if (arg == "--seeds" && i + 1 < argc) {
+      number_of_seeds = (unsigned) std::max(1, atoi(argv[++i]));
+    } else if (arg == "--alpha" && i + 1 < argc) {
+      alpha = atof(argv[++i]);
+    } else if (arg == "--resolution" && i + 1 < argc) {
+      resolution = atof(argv[++i]);
+    } else {
+      std::cerr << "Usage: " << argv[0]
+                << " [--reference FILE] [--parameters FILE] [--batch] [--seeds N] [--alpha A] [--resolution R]"
+                << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  coco_set_log_level("warning");
+  coco_suite_t *suite = coco_suite("bbob-constrained", "instances: 1", "");
+  std::vector<BenchmarkProblem> problems = benchmark_standard_problems(suite);
+
+  int status = EXIT_SUCCESS;
+  try {
+    const es::rayes::Parameters reference_parameters = reference_path.empty() ? es::rayes::Parameters() :
+        es::rayes::loadParameters(reference_path);
+    const es::rayes::Parameters mode_parameters = parameters_path.empty() ? es::rayes::Parameters() :
+        es::rayes::loadParameters(parameters_path);
+    /* Two metrics with two tests each and the termination criteria per problem */
+    const double corrected_alpha = alpha / (double) (problems.size() * 5);
+
+    std::vector<Runs> reference_runs(problems.size()), mode_runs(problems.size());
+    double reference_wall_time = 0.0, mode_wall_time = 0.0;
+    for (size_t i = 0; i < problems.size(); ++i) {
+      reference_runs[i].wall_time = mode_runs[i].wall_time = 0.0;
+      /* The modes alternate such that drifts of the machine speed affect both alike */
+      for (unsigned seed = 1; seed <= number_of_seeds; ++seed) {
+        es::rayes::Parameters parameters = reference_parameters;
+        parameters.seed = seed;
+        add_run(reference_runs[i], problems[i],
+                benchmark_run(problems[i], parameters, BUDGET_MULTIPLIER, TARGET_PRECISION, reference_options),
+                resolution);
+        parameters = mode_parameters;
+        parameters.seed = seed;
+        add_run(mode_runs[i], problems[i],
+                benchmark_run(problems[i], parameters, BUDGET_MULTIPLIER, TARGET_PRECISION, mode_options),
+                resolution);
+      }
+      reference_wall_time += reference_runs[i].wall_time;
+      mode_wall_time += mode_runs[i].wall_time;
+    }
+
+    size_t number_of_differences = 0;
+    printf("%% medians of REF and MODE, two-sided p-values of the Kolmogorov-Smirnov (KS) and Mann-Whitney (MW)\n"
+           "%% tests and of the chi-square test of the termination criteria (! different)\n");
+    printf("%-26s %10s %10s %8s %8s %10s %10s %8s %8s %8s %9s %9s %8s\n", "problem", "final f", "", "KS", "MW",
+           "evals", "", "KS", "MW", "term", "REF/s", "MODE/s", "speedup");
+    for (size_t i = 0; i < problems.size(); ++i) {
+      printf("%-26s", problems[i].name.c_str());
+      number_of_differences += compare(reference_runs[i].precisions, mode_runs[i].precisions, corrected_alpha);
+      number_of_differences += compare(reference_runs[i].evaluations, mode_runs[i].evaluations, corrected_alpha);
+      number_of_differences += compare_terminations(reference_runs[i], mode_runs[i], corrected_alpha);
+      printf(" %9.3f %9.3f %7.2fx\n", reference_runs[i].wall_time * 1e-6, mode_runs[i].wall_time * 1e-6,
+             reference_runs[i].wall_time / mode_runs[i].wall_time);
+    }
+    printf("\n%% termination criteria\n");
+    for (size_t i = 0; i < problems.size(); ++i) {
+      printf("%-26s REF", problems[i].name.c_str());
+      print_terminations(reference_runs[i].terminations);
+      printf("  MODE");
+      print_terminations(mode_runs[i].terminations);
+      printf("\n");
+    }
+    printf("\n%lu significant differences\n", (unsigned long) number_of_differences);
+    printf("wall time: REF %.3f s, MODE %.3f s, speedup %.2fx\n", reference_wall_time * 1e-6,
+           mode_wall_time * 1e-6, reference_wall_time / mode_wall_time);
+    status = number_of_differences == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+  } catch (const std::exception &e) {
+    std::cerr << "Error: " << e.what() << std::endl;
+    status = 2;
+  }
+
+  for (size_t i = 0; i < problems.size(); ++i) {
+    benchmark_problem_free(problems[i]);
+  }
+  coco_suite_free(suite);
+  return status;
+}
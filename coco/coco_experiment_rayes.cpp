@@ -4,6 +4,7 @@
  *
  * Set the global parameter BUDGET_MULTIPLIER to suit your needs.
  */
+#include <assert.h>
 #include <math.h>
 #include <stdlib.h>
 #include <stdio.h>
@@ -14,19 +15,13 @@
 #include <string>
 #include <sstream>
 
-#include <Eigen/Dense>
-
-#include <es/rayes/RayEs.h>
-
-#include <es/core/util.h>
+#include <es/rayes/rayes_c.h>
 
 #include "coco.h"
+#include "coco_work_queue.h"
 
 #define max(a,b) ((a) > (b) ? (a) : (b))
 
-class BudgetExhaustedException : public std::exception {
-};
-
 /**
  * The maximal budget for evaluations done by an optimization algorithm equals dimension * BUDGET_MULTIPLIER.
  * Increase the budget multiplier value gradually to see how it affects the runtime.
@@ -78,7 +73,10 @@ void example_experiment(const char *suite_name,
                         const std::string &name,
                         int firstFunction,
                         int lastFunction,
-                        int dimension);
+                        int dimension,
+                        bool resume);
+
+void run_problem(coco_problem_t *problem);
 
 void my_random_search(evaluate_function_t evaluate_func,
                       evaluate_function_t evaluate_cons,
@@ -123,8 +121,17 @@ static void timing_data_finalize(timing_data_t *timing_data);
 /**
  * The main method initializes the random number generator and calls the example experiment on the
  * bi-objective suite.
+ *
+ * With the argument --resume, an interrupted experiment is continued in its result folder: runs that
+ * were completed are skipped and the output of the unfinished run is replaced.
+ *
+ * The experiment can also be distributed among several worker processes (see coco_work_queue.h):
+ *   --queue-init DIR           creates a queue with one task per problem in the directory DIR,
+ *   --queue-work DIR WORKER    runs tasks of the queue until all are claimed (run it again with the same
+ *                              WORKER name to continue a worker that was interrupted),
+ *   --queue-merge DIR          combines the output of all workers once all tasks are done.
  */
-int main(int /*argc*/, char *[]/*argv[]*/) {
+int main(int argc, char *argv[]) {
 
   // if (argc != 5) {
   //     std::cout << "Usage: " << argv[0] << " alg-name first-func-id last-func-id dimension" << std::endl;
@@ -145,6 +152,34 @@ int main(int /*argc*/, char *[]/*argv[]*/) {
   int firstFunction = 1;
   int lastFunction = 48;
   int dimension = -1; // all dimensions
+  bool resume = argc > 1 && std::string(argv[1]) == "--resume";
+
+  const std::string mode = argc > 1 ? argv[1] : "";
+  const bool queue_init = argc == 3 && mode == "--queue-init";
+  const bool queue_work = argc == 4 && mode == "--queue-work";
+  const bool queue_merge = argc == 3 && mode == "--queue-merge";
+  if (argc > 1 && !resume && !queue_init && !queue_work && !queue_merge) {
+    std::cout << "Usage: " << argv[0] << " [--resume | --queue-init DIR | --queue-work DIR WORKER | "
+              << "--queue-merge DIR]" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  /* The output of the worker W is written to exdata/<result folder>_W */
+  const std::string result_folder = name + "_on_bbob-constrained";
+  const std::string observer_options = "algorithm_name: " + name +
+                                       " algorithm_info: \"Evolutionary search algorithm\"";
+  if (queue_init) {
+    work_queue_init(argv[2], "bbob-constrained", "instances: 1-15", "dimensions: 2,3,5,10,20,40");
+    return 0;
+  }
+  if (queue_work) {
+    work_queue_work(argv[2], argv[3], "bbob", observer_options, result_folder + "_" + argv[3], run_problem);
+    return 0;
+  }
+  if (queue_merge) {
+    work_queue_merge(argv[2], "exdata/" + result_folder + "_", "exdata/" + result_folder);
+    return 0;
+  }
 
   coco_random_state_t *random_generator = coco_random_new(RANDOM_SEED);
 
@@ -154,7 +189,8 @@ int main(int /*argc*/, char *[]/*argv[]*/) {
   printf("Running the example experiment... (might take time, be patient)\n");
   fflush(stdout);
 
-  example_experiment("bbob-constrained", "bbob", random_generator, name, firstFunction, lastFunction, dimension);
+  example_experiment("bbob-constrained", "bbob", random_generator, name, firstFunction, lastFunction, dimension,
+                     resume);
 
   /* Uncomment the line below to run the same example experiment on the bbob suite */
   /* example_experiment("bbob-biobj", "bbob-biobj", random_generator); */
@@ -181,6 +217,8 @@ int main(int /*argc*/, char *[]/*argv[]*/) {
  * "bbob-constrained" for the constrained problems observer and "bbob-biobj" for the
  * bi-objective observer).
  * @param random_generator The random number generator.
+ * @param resume Whether to continue an interrupted experiment in the same result folder (completed runs
+ * are skipped).
  */
 void example_experiment(const char *suite_name,
                         const char *observer_name,
@@ -188,9 +226,9 @@ void example_experiment(const char *suite_name,
                         const std::string &name,
                         int firstFunction,
                         int lastFunction,
-                        int dimension) {
+                        int dimension,
+                        bool resume) {
 
-  size_t run;
   coco_suite_t *suite;
   coco_observer_t *observer;
   timing_data_t *timing_data;
@@ -199,7 +237,8 @@ void example_experiment(const char *suite_name,
   char *observer_options =
       coco_strdupf("result_folder: %s_on_%s_f%02d_%02d "
                    "algorithm_name: %s "
-                   "algorithm_info: \"Evolutionary search algorithm\"", name.c_str(), suite_name, firstFunction, lastFunction, name.c_str());
+                   "algorithm_info: \"Evolutionary search algorithm\" "
+                   "resume: %d", name.c_str(), suite_name, firstFunction, lastFunction, name.c_str(), resume ? 1 : 0);
 
   /* Initialize the suite and observer */
   if (dimension == -1) {
@@ -243,42 +282,14 @@ void example_experiment(const char *suite_name,
       continue;
     }
 
-    /* Run the algorithm at least once */
-    for (run = 1; run <= 1 + INDEPENDENT_RESTARTS; run++) {
-
-      size_t evaluations_done;
-      
-      evaluations_done = coco_problem_get_evaluations(PROBLEM) + 
-            coco_problem_get_evaluations_constraints(PROBLEM);
-
-      long evaluations_remaining = (long) (dimension * BUDGET_MULTIPLIER) - (long) evaluations_done;
-
-      /* Break the loop if the target was hit or there are no more remaining evaluations */
-      if ((coco_problem_final_target_hit(PROBLEM) && 
-           coco_problem_get_number_of_constraints(PROBLEM) == 0)
-           || (evaluations_remaining <= 0))
-        break;
-
-      /* Call the optimization algorithm for the remaining number of evaluations */
-      my_search(evaluate_function,
-                evaluate_constraint,
-                dimension,
-                coco_problem_get_number_of_objectives(PROBLEM),
-                coco_problem_get_number_of_constraints(PROBLEM),
-                coco_problem_get_smallest_values_of_interest(PROBLEM),
-                coco_problem_get_largest_values_of_interest(PROBLEM),
-                (size_t) evaluations_remaining);
-      
-      /* Break the loop if the algorithm performed no evaluations or an unexpected thing happened */
-      if (coco_problem_get_evaluations(PROBLEM) == evaluations_done) {
-        printf("WARNING: Budget has not been exhausted (%lu/%lu evaluations done)!\n",
-        		(unsigned long) evaluations_done, (unsigned long) dimension * BUDGET_MULTIPLIER);
-        break;
-      }
-      else if (coco_problem_get_evaluations(PROBLEM) + coco_problem_get_evaluations_constraints(PROBLEM) < evaluations_done)
-        coco_error("Something unexpected happened - function evaluations were decreased!");
+    /* Skip the runs that were completed before the experiment was resumed */
+    if (coco_observer_is_run_completed(observer, PROBLEM)) {
+      cnt += 1;
+      continue;
     }
 
+    run_problem(PROBLEM);
+
     /* Keep track of time */
     timing_data_time_problem(timing_data, PROBLEM);
 
@@ -295,6 +306,56 @@ void example_experiment(const char *suite_name,
 
 }
 
+/**
+ * Runs the algorithm (with restarts) on the given problem until the budget is exhausted or the final target
+ * is hit.
+ *
+ * @param problem The problem to be optimized.
+ */
+void run_problem(coco_problem_t *problem) {
+
+  size_t run;
+  size_t dimension = coco_problem_get_dimension(problem);
+
+  PROBLEM = problem;
+
+  /* Run the algorithm at least once */
+  for (run = 1; run <= 1 + INDEPENDENT_RESTARTS; run++) {
+
+    size_t evaluations_done;
+    
+    evaluations_done = coco_problem_get_evaluations(PROBLEM) + 
+          coco_problem_get_evaluations_constraints(PROBLEM);
+
+    long evaluations_remaining = (long) (dimension * BUDGET_MULTIPLIER) - (long) evaluations_done;
+
+    /* Break the loop if the target was hit or there are no more remaining evaluations */
+    if ((coco_problem_final_target_hit(PROBLEM) && 
+         coco_problem_get_number_of_constraints(PROBLEM) == 0)
+         || (evaluations_remaining <= 0))
+      break;
+
+    /* Call the optimization algorithm for the remaining number of evaluations */
+    my_search(evaluate_function,
+              evaluate_constraint,
+              dimension,
+              coco_problem_get_number_of_objectives(PROBLEM),
+              coco_problem_get_number_of_constraints(PROBLEM),
+              coco_problem_get_smallest_values_of_interest(PROBLEM),
+              coco_problem_get_largest_values_of_interest(PROBLEM),
+              (size_t) evaluations_remaining);
+    
+    /* Break the loop if the algorithm performed no evaluations or an unexpected thing happened */
+    if (coco_problem_get_evaluations(PROBLEM) == evaluations_done) {
+      printf("WARNING: Budget has not been exhausted (%lu/%lu evaluations done)!\n",
+      		(unsigned long) evaluations_done, (unsigned long) dimension * BUDGET_MULTIPLIER);
+      break;
+    }
+    else if (coco_problem_get_evaluations(PROBLEM) + coco_problem_get_evaluations_constraints(PROBLEM) < evaluations_done)
+      coco_error("Something unexpected happened - function evaluations were decreased!");
+  }
+}
+
 /**
  * A random search algorithm that can be used for single- as well as multi-objective optimization.
  *
@@ -426,6 +487,45 @@ void my_grid_search(evaluate_function_t evaluate,
   coco_free_memory(grid_step);
 }
 
+/**
+ * The data passed to the callbacks of the Ray-ES C interface.
+ */
+typedef struct {
+  evaluate_function_t evaluate_func;
+  evaluate_function_t evaluate_cons;
+  size_t max_budget;
+} my_search_data_t;
+
+/**
+ * Returns whether the budget is exhausted, which stops the run.
+ */
+static int my_search_budget_exhausted(const my_search_data_t *data) {
+  return coco_problem_get_evaluations(PROBLEM) + coco_problem_get_evaluations_constraints(PROBLEM) >
+      data->max_budget;
+}
+
+static int my_search_objective(const double *x, double *f, void *user_data) {
+  const my_search_data_t *data = (const my_search_data_t *) user_data;
+  if (my_search_budget_exhausted(data)) {
+    return 1;
+  }
+  data->evaluate_func(x, f);
+  return 0;
+}
+
+static int my_search_constraint(const double *x, double *c, void *user_data) {
+  const my_search_data_t *data = (const my_search_data_t *) user_data;
+  if (my_search_budget_exhausted(data)) {
+    return 1;
+  }
+  data->evaluate_cons(x, c);
+  return 0;
+}
+
+/**
+ * Runs the Ray-ES through its C interface, which passes the points and result buffers to the COCO
+ * evaluation functions without copies.
+ */
 void my_search(evaluate_function_t evaluate_func,
                evaluate_function_t evaluate_cons,
                const size_t dimension,
@@ -448,70 +548,32 @@ void my_search(evaluate_function_t evaluate_func,
     evaluate_cons(x, constraints_values);
     evaluate_func(x, functions_values);
 
-    auto evalConsWrapper = [=](const Eigen::VectorXd &xVec) {
-        if (coco_problem_get_evaluations(PROBLEM) +
-            coco_problem_get_evaluations_constraints(PROBLEM) > max_budget) {
-            throw BudgetExhaustedException();
-        }
-        for (size_t i = 0; i < dimension; ++i) {
-            x[i] = xVec(i);
-        }
-        evaluate_cons(x, constraints_values);
-        Eigen::VectorXd y(number_of_constraints);
-        for (size_t i = 0; i < number_of_constraints; ++i) {
-            y(i) = constraints_values[i];
-        }
-        return y;
-    };
+    my_search_data_t data;
+    data.evaluate_func = evaluate_func;
+    data.evaluate_cons = evaluate_cons;
+    data.max_budget = max_budget;
 
-    auto evalFuncWrapper = [=](const Eigen::VectorXd &xVec) {
-        if (coco_problem_get_evaluations(PROBLEM) +
-            coco_problem_get_evaluations_constraints(PROBLEM) > max_budget) {
-            throw BudgetExhaustedException();
-        }
-        for (size_t i = 0; i < dimension; ++i) {
-            x[i] = xVec(i);
-        }
-        evaluate_func(x, functions_values);
-        return functions_values[0];
-    };
-
-    // Eigen::VectorXd z = Eigen::MatrixXd::Zero(dimension, 1);
-    // double sigma = 1.0;
-    Eigen::VectorXd lbnds(dimension);
-    for (size_t i = 0; i < dimension; ++i) {
-        lbnds(i) = lower_bounds[i];
+    /* x still holds the initial solution, the initial ray origin */
+    rayes_solver_t *solver = rayes_create(dimension, number_of_constraints, lower_bounds, upper_bounds, x,
+                                          my_search_objective, my_search_constraint, &data);
+    if (solver == NULL) {
+        coco_error("my_search(): cannot create the solver");
     }
-    Eigen::VectorXd ubnds(dimension);
-    for (size_t i = 0; i < dimension; ++i) {
-        ubnds(i) = upper_bounds[i];
+    /* With RAYES_STATUS set, the progress of every problem is shown by es_rayesstatus */
+    if (getenv("RAYES_STATUS") != NULL) {
+        rayes_set_parameter(solver, "publishStatus", "true");
+        rayes_set_parameter(solver, "statusLabel", coco_problem_get_id(PROBLEM));
     }
-
-    try {
-        double *values = coco_allocate_vector(dimension);
-        coco_problem_get_initial_solution(PROBLEM, values);
-        Eigen::VectorXd rayInit(dimension);
-        for (size_t i = 0; i < dimension; ++i) {
-            rayInit(i) = values[i];
-        }
-        coco_free_memory(values);
-        es::rayes::RayEs solver(
-                                evalFuncWrapper,
-                                evalConsWrapper,
-                                lbnds,
-                                ubnds,
-                                rayInit,
-                                es::rayes::LineSearchAlg::Modified);
-        es::rayes::Info info = solver.run();
+    const int status = rayes_run(solver);
+    if (status == RAYES_OK) {
         std::cout << "Termination criterion: "
-                  << es::core::toString(info.getTerminationCriterion())
+                  << rayes_get_termination_criterion(solver)
                   << "."
                   << std::endl;
-    } catch (BudgetExhaustedException &) {
-        // std::cout << "budget exhausted" << std::endl;
-    } catch (std::exception &e) {
-        std::cout << "unexpected error: " << e.what() << std::endl;
+    } else if (status == RAYES_ERROR) {
+        std::cout << "unexpected error: " << rayes_get_last_error(solver) << std::endl;
     }
+    rayes_destroy(solver);
 
     coco_free_memory(x);
     coco_free_memory(functions_values);
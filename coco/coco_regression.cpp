@@ -0,0 +1,362 @@
+/**
+ * A performance regression gate for the Ray-ES: runs a fixed set of synthetic and COCO problems with fixed
+ * seeds and each line search (the runs of the Modified line search are named after the problem, the others
+ * carry the line search as suffix, e.g. "sphere-linear_d02:Standard"), records per run the number of evaluations (objective plus constraint evaluations) to reach the
+ * target and the optimizer overhead (time per evaluation not spent in the problem functions, relative to the
+ * time of a reference workload), and compares them with a baseline file.
+ *
+ * Usage:
+ *   coco_regression [--baseline FILE] [--update] [--no-timing] [--seeds N] [--alpha A] [--parameters FILE]
+ *
+ * With --update, the baseline is (re)written. Otherwise, the samples of every problem are compared with the
+ * baseline with one-sided Mann-Whitney U tests (Bonferroni corrected over all tests) and the exit status is
+ * 1 if the evaluations or the overhead increased significantly and by more than 10% resp. 25% in the median.
+ * The overhead of an unchanged tree drifts with the state of the machine (other load, frequency scaling) by
+ * more than the reference workload compensates, so a problem with a flagged overhead is measured again
+ * (CONFIRMATION_RUNS times) and the regression only counts if every new measurement is flagged as well. The
+ * evaluations are deterministic and need no confirmation. The relative overhead still depends on the machine (compiler, cache sizes), so the baseline
+ * should be updated on the machine that runs the gate (or --no-timing used).
+ *
+ * With --parameters, the runs use the parameter file (the seeds are still set by the gate), e.g. to validate a
+ * variant such as "precision = Mixed" against the baseline of the default parameters. The total wall time of
+ * the runs is printed as well; with "numThreads = N" (use --no-timing, the overhead is not meaningful then) it
+ * compares thread counts and placements, e.g. under taskset or in cpusets that emulate a topology.
+ */
+#include <math.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <Eigen/Dense>
+
+#include <es/core/Statistics.h>
+
+#include "coco.h"
+#include "coco_benchmark.h"
+
+#ifndef COCO_REGRESSION_BASELINE
+#define COCO_REGRESSION_BASELINE "regression_baseline.txt"
+#endif
+
+namespace {
+
+/**
+ * The target is reached if (f - fopt) / max(1, |fopt|) is at most this precision.
+ */
+const double TARGET_PRECISION = 1e-4;
+
+/**
+ * The evaluation budget of a run equals dimension * BUDGET_MULTIPLIER.
+ */
+const long BUDGET_MULTIPLIER = 50000;
+
+/**
+ * Median increases that are not reported as regressions even if they are significant.
+ */
+const double EVALUATIONS_TOLERANCE = 0.1;
+const double OVERHEAD_TOLERANCE = 0.25;
+
+/**
+ * A run with a fixed seed is deterministic, so it is repeated and the smallest overhead is taken to
+ * suppress timing noise.
+ */
+const int TIMING_REPETITIONS = 3;
+
+/**
+ * How often a flagged problem is measured again to confirm the regression.
+ */
+const int CONFIRMATION_RUNS = 2;
+
+/**
+ * The result of one run.
+ */
+struct Sample {
+  double evaluations;
+  double overhead;
+  /* Not part of the baseline */
+  double wall_time;
+};
+
+/**
+ * A problem of the gate run with one of the line searches.
+ */
+struct GateCase {
+  std::string name;
+  const BenchmarkProblem *problem;
+  es::rayes::LineSearchAlg line_search;
+};
+
+std::vector<GateCase> gate_cases(const std::vector<BenchmarkProblem> &problems) {
+  const es::rayes::LineSearchAlg line_searches[] = {es::rayes::LineSearchAlg::Modified,
+                                                     es::rayes::LineSearchAlg::Standard,
+                                                     es::rayes::LineSearchAlg::Adaptive};
+  std::vector<GateCase> cases;
+  for (size_t j = 0; j < sizeof(line_searches) / sizeof(line_searches[0]); ++j) {
+    for (size_t i = 0; i < problems.size(); ++i) {
+      std::ostringstream name;
+      name << problems[i].name;
+      if (line_searches[j] != es::rayes::LineSearchAlg::Modified) {
+        name << ":" << line_searches[j];
+      }
+      const GateCase gate_case = {name.str(), &problems[i], line_searches[j]};
+      cases.push_back(gate_case);
+    }
+  }
+  return cases;
+}
+
+/**
+ * Returns the time in microseconds of a fixed small linear algebra workload (the smallest of several
+ * measurements). The overhead is measured in multiples of it such that it does not depend on the speed of
+ * the machine at the moment, which varies e.g. with frequency scaling.
+ */
+double reference_time() {
+  typedef std::chrono::steady_clock clock;
+  const Eigen::MatrixXd matrix = Eigen::MatrixXd::Identity(10, 10) + Eigen::MatrixXd::Constant(10, 10, 0.1);
+  double best = std::numeric_limits<double>::max();
+  for (int repetition = 0; repetition < 5; ++repetition) {
+    Eigen::VectorXd x = Eigen::VectorXd::Ones(10);
+    const clock::time_point start = clock::now();
+    for (int i = 0; i < 1000; ++i) {
+      x = matrix * x;
+      x /= x.norm();
+    }
+    const double time = std::chrono::duration<double, std::micro>(clock::now() - start).count();
+    /* Keeps the result alive */
+    best = std::min(best, time + 0.0 * x(0));
+  }
+  return best;
+}
+
+/**
+ * Runs the Ray-ES with the given seed until the target is reached or the budget is exhausted.
+ */
+Sample run(const GateCase &gate_case, const es::rayes::Parameters &base_parameters, unsigned seed) {
+  es::rayes::Parameters parameters = base_parameters;
+  parameters.seed = seed;
+  BenchmarkOptions options;
+  options.line_search = gate_case.line_search;
+  const BenchmarkRun benchmark = benchmark_run(*gate_case.problem, parameters, BUDGET_MULTIPLIER,
+                                               TARGET_PRECISION, options);
+  Sample sample;
+  sample.evaluations = benchmark.evaluations;
+  sample.overhead = benchmark.optimizer_time / (double) std::max(1L, benchmark.evaluations_done) /
+      reference_time();
+  sample.wall_time = benchmark.wall_time;
+  return sample;
+}
+
+typedef std::map<std::string, std::vector<Sample> > Samples;
+
+Samples read_baseline(const std::string &path) {
+  std::ifstream file(path.c_str());
+  if (!file) {
+    throw std::runtime_error("cannot read the baseline " + path + " (create it with --update)");
+  }
+  Samples samples;
+  std::string line;
+  while (std::getline(file, line)) {
+    if (line.empty() || line[0] == '#') {
+      continue;
+    }
+    std::istringstream stream(line);
+    std::string name, evaluations;
+    unsigned seed;
+    Sample sample;
+    if (!(stream >> name >> seed >> evaluations >> sample.overhead)) {
+      throw std::runtime_error("invalid line in " + path + ": " + line);
+    }
+    sample.evaluations = evaluations == "inf" ? std::numeric_limits<double>::infinity() :
+        atof(evaluations.c_str());
+    sample.wall_time = 0.0;
+    samples[name].push_back(sample);
+  }
+  return samples;
+}
+
+void write_baseline(const std::string &path, const std::vector<GateCase> &cases, const Samples &samples) {
+  std::ofstream file(path.c_str());
+  file << "# coco_regression baseline: problem seed evaluations-to-target relative-overhead-per-evaluation\n";
+  for (size_t i = 0; i < cases.size(); ++i) {
+    const std::vector<Sample> &runs = samples.at(cases[i].name);
+    for (size_t seed = 1; seed <= runs.size(); ++seed) {
+      char overhead[32];
+      snprintf(overhead, sizeof(overhead), "%.4e", runs[seed - 1].overhead);
+      file << cases[i].name << " " << seed << " " << runs[seed - 1].evaluations << " " << overhead << "\n";
+    }
+  }
+  if (!file.flush()) {
+    throw std::runtime_error("cannot write the baseline " + path);
+  }
+}
+
+std::vector<double> column(const std::vector<Sample> &samples, double Sample::*member) {
+  std::vector<double> values;
+  for (size_t i = 0; i < samples.size(); ++i) {
+    values.push_back(samples[i].*member);
+  }
+  return values;
+}
+
+/**
+ * The comparison of a problem with the baseline in one metric.
+ */
+struct Comparison {
+  double base_median;
+  double current_median;
+  double p;
+  bool regression;
+};
+
+/**
+ * Compares the samples of a problem in one metric: the metric regressed if it increased significantly and
+ * by more than the tolerance in the median.
+ */
+Comparison compare(const std::vector<Sample> &base, const std::vector<Sample> &current, double Sample::*member,
+                   double alpha, double tolerance) {
+  const std::vector<double> base_values = column(base, member);
+  const std::vector<double> current_values = column(current, member);
+  Comparison comparison;
+  comparison.base_median = es::core::median(base_values);
+  comparison.current_median = es::core::median(current_values);
+  comparison.p = es::core::mannWhitneyUTest(base_values, current_values);
+  comparison.regression = comparison.p < alpha &&
+      !(comparison.current_median <= comparison.base_median * (1 + tolerance));
+  return comparison;
+}
+
+/**
+ * Prints the medians and the p-value of a comparison, marked with '!' if the regression was confirmed and
+ * with '?' if it did not reproduce.
+ */
+void print(const Comparison &comparison, bool confirmed) {
+  printf(" %10.4g %10.4g %8.1e%c", comparison.base_median, comparison.current_median, comparison.p,
+         !comparison.regression ? ' ' : confirmed ? '!' : '?');
+}
+
+/**
+ * Runs a case with the seeds 1, ..., number_of_seeds. The wall time of the runs is added to wall_time.
+ */
+std::vector<Sample> measure(const GateCase &gate_case, const es::rayes::Parameters &parameters,
+                            unsigned number_of_seeds, bool timing, double &wall_time) {
+  std::vector<Sample> samples;
+  for (unsigned seed = 1; seed <= number_of_seeds; ++seed) {
+    Sample sample = run(gate_case, parameters, seed);
+    wall_time += sample.wall_time;
+    for (int repetition = 1; timing && repetition < TIMING_REPETITIONS; ++repetition) {
+      sample.overhead = std::min(sample.overhead, run(gate_case, parameters, seed).overhead);
+    }
+    samples.push_back(sample);
+  }
+  return samples;
+}
+
+}
+
+int main(int argc, char *argv[]) {
+  std::string baseline = COCO_REGRESSION_BASELINE;
+  bool update = false, timing = true;
+  unsigned number_of_seeds = 25;
+  double alpha = 0.05;
+  std::string parameters_path;
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    if (arg == "--baseline" && i + 1 < argc) {
+      baseline = argv[++i];
+    } else if (arg == "--update") {
+      update = true;
+    } else if (arg == "--no-timing") {
+      timing = false;
+    } else if (arg == "--seeds" && i + 1 < argc) {
+      number_of_seeds = (unsigned) std::max(1, atoi(argv[++i]));
+    } else if (arg == "--alpha" && i + 1 < argc) {
+      alpha = atof(argv[++i]);
+    } else if (arg == "--parameters" && i + 1 < argc) {
+      parameters_path = argv[++i];
+    } else {
+      std::cerr << "Usage: " << argv[0]
+                << " [--baseline FILE] [--update] [--no-timing] [--seeds N] [--alpha A] [--parameters FILE]"
+                << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  coco_set_log_level("warning");
+  coco_suite_t *suite = coco_suite("bbob-constrained", "instances: 1", "");
+  std::vector<BenchmarkProblem> problems = benchmark_standard_problems(suite);
+  const std::vector<GateCase> cases = gate_cases(problems);
+
+  int status = EXIT_SUCCESS;
+  try {
+    const es::rayes::Parameters parameters = parameters_path.empty() ? es::rayes::Parameters() :
+        es::rayes::loadParameters(parameters_path);
+    Samples samples;
+    double wall_time = 0.0;
+    for (size_t i = 0; i < cases.size(); ++i) {
+      samples[cases[i].name] = measure(cases[i], parameters, number_of_seeds, timing, wall_time);
+    }
+
+    if (update) {
+      write_baseline(baseline, cases, samples);
+      printf("Wrote %s\n", baseline.c_str());
+    } else {
+      const Samples base = read_baseline(baseline);
+      const double corrected_alpha = alpha / (double) (cases.size() * (timing ? 2 : 1));
+      size_t number_of_regressions = 0, number_of_unconfirmed = 0;
+      printf("%% medians of BASE and NEW, one-sided Mann-Whitney p-value (! regression, ? not reproduced)\n");
+      printf("%-33s %10s %10s %9s %10s %10s %9s\n", "problem", "evals", "", "p", "overhead", "", "p");
+      for (size_t i = 0; i < cases.size(); ++i) {
+        const Samples::const_iterator it = base.find(cases[i].name);
+        if (it == base.end()) {
+          throw std::runtime_error("the baseline contains no runs on " + cases[i].name);
+        }
+        const Comparison evaluations = compare(it->second, samples[cases[i].name], &Sample::evaluations,
+                                               corrected_alpha, EVALUATIONS_TOLERANCE);
+        Comparison overhead = {0.0, 0.0, 1.0, false};
+        if (timing) {
+          overhead = compare(it->second, samples[cases[i].name], &Sample::overhead, corrected_alpha,
+                             OVERHEAD_TOLERANCE);
+        }
+        /* The evaluations are deterministic, only an overhead regression is measured again */
+        bool overhead_confirmed = overhead.regression;
+        for (int confirmation = 0; overhead_confirmed && confirmation < CONFIRMATION_RUNS; ++confirmation) {
+          double confirmation_time = 0.0;
+          const std::vector<Sample> again = measure(cases[i], parameters, number_of_seeds, timing,
+                                                    confirmation_time);
+          overhead_confirmed = compare(it->second, again, &Sample::overhead, corrected_alpha,
+                                       OVERHEAD_TOLERANCE).regression;
+        }
+        printf("%-33s", cases[i].name.c_str());
+        print(evaluations, evaluations.regression);
+        if (timing) {
+          print(overhead, overhead_confirmed);
+        }
+        printf("\n");
+        number_of_regressions += evaluations.regression + overhead_confirmed;
+        number_of_unconfirmed += overhead.regression && !overhead_confirmed;
+      }
+      printf("\n%lu regressions (%lu not reproduced)\n", (unsigned long) number_of_regressions,
+             (unsigned long) number_of_unconfirmed);
+      printf("wall time of the runs: %.3f s\n", wall_time * 1e-6);
+      status = number_of_regressions == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+  } catch (const std::exception &e) {
+    std::cerr << "Error: " << e.what() << std::endl;
+    status = 2;
+  }
+
+  for (size_t i = 0; i < problems.size(); ++i) {
+    benchmark_problem_free(problems[i]);
+  }
+  coco_suite_free(suite);
+  return status;
+}
@@ -0,0 +1,362 @@
+/**
+ * Tunes the strategy constants of the Ray-ES per problem class by successive halving: random configurations
+ * (and the defaults) are run on a growing set of tasks (problem instance and seed) and only the best 1/eta
+ * of them are kept in every round. The score of a configuration is the mean of log10(evaluations to the
+ * target / dimension) over the tasks, runs that do not reach the target count ten times the budget.
+ *
+ * The problem classes are the objective function types of the bbob-constrained suite (functions
+ * 6 * (class - 1) + 1, ..., 6 * class differ in the number of constraints). The runs are distributed over
+ * threads, all seeds are fixed, so the result does not depend on the number of threads.
+ *
+ * Usage:
+ *   coco_tune [--threads N] [--configurations N] [--eta N] [--classes LIST] [--dimensions LIST]
+ *             [--instances N] [--seeds N] [--budget-multiplier N] [--out DIR]
+ *
+ * For every class, the best configuration is written to DIR/<class>.params (see es::rayes::loadParameters).
+ */
+#include <math.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#include "coco.h"
+#include "coco_benchmark.h"
+
+namespace {
+
+const char *CLASS_NAMES[] = {"sphere", "separable-ellipsoid", "linear-slope", "rotated-ellipsoid", "discus",
+                             "bent-cigar", "different-powers", "separable-rastrigin"};
+const size_t NUMBER_OF_CLASSES = sizeof(CLASS_NAMES) / sizeof(CLASS_NAMES[0]);
+const size_t FUNCTIONS_PER_CLASS = 6;
+
+const double TARGET_PRECISION = 1e-4;
+
+/**
+ * A run of a configuration on a problem instance with a seed.
+ */
+struct Task {
+  size_t function;
+  size_t dimension;
+  size_t instance;
+  unsigned seed;
+};
+
+struct Options {
+  unsigned threads;
+  size_t configurations;
+  size_t eta;
+  std::vector<size_t> classes;
+  std::vector<size_t> dimensions;
+  size_t instances;
+  unsigned seeds;
+  long budget_multiplier;
+  std::string out;
+};
+
+std::vector<size_t> parse_list(const std::string &list) {
+  std::vector<size_t> values;
+  std::istringstream stream(list);
+  std::string value;
+  while (std::getline(stream, value, ',')) {
+    values.push_back((size_t) atol(value.c_str()));
+  }
+  return values;
+}
+
+double log_uniform(std::mt19937 &engine, double lo, double hi) {
+  return exp(std::uniform_real_distribution<double>(log(lo), log(hi))(engine));
+}
+
+/**
+ * Returns the defaults followed by random configurations. The engine has a fixed seed, so every call
+ * returns the same configurations.
+ */
+std::vector<es::rayes::Parameters> sample_configurations(size_t number) {
+  std::mt19937 engine(2016);
+  std::vector<es::rayes::Parameters> configurations(1);
+  while (configurations.size() < number) {
+    es::rayes::Parameters parameters;
+    parameters.lambdaPerDimension = std::uniform_int_distribution<int>(2, 8)(engine);
+    parameters.selectionRatio = std::uniform_real_distribution<double>(0.1, 0.5)(engine);
+    parameters.tauFactor = log_uniform(engine, 0.5, 2.0);
+    parameters.gLagPerDimension = std::uniform_int_distribution<int>(20, 100)(engine);
+    parameters.lineSearchPartitions = std::uniform_int_distribution<int>(1, 4)(engine);
+    parameters.lineSearchEpsilon = log_uniform(engine, 1e-12, 1e-8);
+    parameters.lineSearchStepSizeIncreaseFactor = std::uniform_real_distribution<double>(1.2, 2.5)(engine);
+    parameters.lineSearchStepSizeDecreaseFactor = log_uniform(engine, 2.0, 20.0);
+    configurations.push_back(parameters);
+  }
+  return configurations;
+}
+
+/**
+ * Returns the tasks of a class in a fixed pseudo-random order, so that every prefix covers the functions,
+ * dimensions and instances of the class evenly.
+ */
+std::vector<Task> class_tasks(size_t problem_class, const Options &options) {
+  std::vector<Task> tasks;
+  for (unsigned seed = 1; seed <= options.seeds; ++seed) {
+    for (size_t instance = 1; instance <= options.instances; ++instance) {
+      for (size_t i = 0; i < options.dimensions.size(); ++i) {
+        for (size_t function = FUNCTIONS_PER_CLASS * (problem_class - 1) + 1;
+             function <= FUNCTIONS_PER_CLASS * problem_class; ++function) {
+          Task task = {function, options.dimensions[i], instance, seed};
+          tasks.push_back(task);
+        }
+      }
+    }
+  }
+  std::mt19937 engine((unsigned) problem_class);
+  std::shuffle(tasks.begin(), tasks.end(), engine);
+  return tasks;
+}
+
+/**
+ * Runs jobs (configuration, task) on a pool of threads. Every thread allocates its own problems, as COCO
+ * problems must not be evaluated concurrently.
+ */
+class Runner {
+public:
+  Runner(const Options &options, const std::vector<es::rayes::Parameters> &configurations)
+      : m_options(options), m_configurations(configurations) {
+    std::ostringstream instances;
+    instances << "instances: 1-" << options.instances;
+    m_suite = coco_suite("bbob-constrained", instances.str().c_str(), "");
+  }
+
+  ~Runner() {
+    coco_suite_free(m_suite);
+  }
+
+  /**
+   * Returns the scores of the jobs (the log10 of the evaluations to the target per dimension).
+   */
+  std::vector<double> run(const std::vector<std::pair<size_t, Task> > &jobs) {
+    std::vector<double> scores(jobs.size());
+    std::atomic<size_t> next(0);
+    std::vector<std::thread> threads;
+    for (unsigned t = 0; t < m_options.threads; ++t) {
+      threads.push_back(std::thread([&]() {
+        typedef std::tuple<size_t, size_t, size_t> Key;
+        std::map<Key, BenchmarkProblem> problems;
+        for (size_t i = next++; i < jobs.size(); i = next++) {
+          const Task &task = jobs[i].second;
+          const Key key(task.function, task.dimension, task.instance);
+          if (problems.find(key) == problems.end()) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            problems[key] = benchmark_coco_constrained(m_suite, task.function, task.dimension, task.instance);
+          }
+          es::rayes::Parameters parameters = m_configurations[jobs[i].first];
+          parameters.seed = task.seed;
+          const BenchmarkRun run = benchmark_run(problems[key], parameters, m_options.budget_multiplier,
+                                                 TARGET_PRECISION);
+          const double evaluations = run.evaluations < HUGE_VAL ? run.evaluations :
+              10.0 * (double) (m_options.budget_multiplier * (long) task.dimension);
+          scores[i] = log10(evaluations / (double) task.dimension);
+        }
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (std::map<Key, BenchmarkProblem>::iterator it = problems.begin(); it != problems.end(); ++it) {
+          benchmark_problem_free(it->second);
+        }
+      }));
+    }
+    for (size_t t = 0; t < threads.size(); ++t) {
+      threads[t].join();
+    }
+    return scores;
+  }
+
+private:
+  const Options &m_options;
+  const std::vector<es::rayes::Parameters> &m_configurations;
+  coco_suite_t *m_suite;
+  std::mutex m_mutex;
+};
+
+/**
+ * Tunes the configurations on a class. Returns the index of the best configuration and sets the mean
+ * scores of the defaults and of the best configuration on all tasks.
+ */
+size_t tune_class(size_t problem_class, const Options &options, size_t number_of_configurations,
+                  Runner &runner, double &default_score, double &best_score) {
+  const std::vector<Task> tasks = class_tasks(problem_class, options);
+  /* scores[c][t] of configuration c on the first scores[c].size() tasks */
+  std::vector<std::vector<double> > scores(number_of_configurations);
+  std::vector<size_t> alive;
+  for (size_t c = 0; c < number_of_configurations; ++c) {
+    alive.push_back(c);
+  }
+
+  size_t rounds = 0;
+  for (size_t n = 1; n < number_of_configurations; n *= options.eta) {
+    ++rounds;
+  }
+  for (size_t round = 0; ; ++round) {
+    /* The last round and the defaults use all tasks */
+    size_t number_of_tasks = tasks.size();
+    for (size_t r = round; r < rounds; ++r) {
+      number_of_tasks /= options.eta;
+    }
+    number_of_tasks = std::max((size_t) 1, number_of_tasks);
+    const bool last = alive.size() == 1;
+    std::vector<size_t> evaluated = alive;
+    if (last && alive[0] != 0) {
+      evaluated.push_back(0);
+    }
+
+    std::vector<std::pair<size_t, Task> > jobs;
+    for (size_t i = 0; i < evaluated.size(); ++i) {
+      const size_t c = evaluated[i];
+      const size_t needed = last ? tasks.size() : number_of_tasks;
+      for (size_t t = scores[c].size(); t < needed; ++t) {
+        jobs.push_back(std::make_pair(c, tasks[t]));
+      }
+    }
+    const std::vector<double> results = runner.run(jobs);
+    for (size_t j = 0; j < jobs.size(); ++j) {
+      scores[jobs[j].first].push_back(results[j]);
+    }
+
+    std::vector<std::pair<double, size_t> > ranking;
+    for (size_t i = 0; i < alive.size(); ++i) {
+      const std::vector<double> &s = scores[alive[i]];
+      double sum = 0.0;
+      for (size_t t = 0; t < s.size(); ++t) {
+        sum += s[t];
+      }
+      ranking.push_back(std::make_pair(sum / (double) s.size(), alive[i]));
+    }
+    /* Ties are broken by the configuration index, the defaults win ties */
+    std::sort(ranking.begin(), ranking.end());
+    printf("  round %lu: %lu configurations on %lu tasks, best %lu (%.4f)\n", (unsigned long) round,
+           (unsigned long) alive.size(), (unsigned long) scores[alive[0]].size(),
+           (unsigned long) ranking[0].second, ranking[0].first);
+    fflush(stdout);
+    if (last) {
+      double sum = 0.0;
+      for (size_t t = 0; t < scores[0].size(); ++t) {
+        sum += scores[0][t];
+      }
+      default_score = sum / (double) scores[0].size();
+      best_score = ranking[0].first;
+      return alive[0];
+    }
+
+    alive.clear();
+    const size_t keep = std::max((size_t) 1, (ranking.size() + options.eta - 1) / options.eta);
+    for (size_t i = 0; i < keep; ++i) {
+      alive.push_back(ranking[i].second);
+    }
+  }
+}
+
+void usage(const char *program) {
+  std::cerr << "Usage: " << program << " [--threads N] [--configurations N] [--eta N] [--classes LIST]"
+            << " [--dimensions LIST] [--instances N] [--seeds N] [--budget-multiplier N] [--out DIR]"
+            << std::endl;
+}
+
+}
+
+int main(int argc, char *argv[]) {
+  Options options;
+  options.threads = std::max(1u, std::thread::hardware_concurrency());
+  options.configurations = 32;
+  options.eta = 2;
+  for (size_t c = 1; c <= NUMBER_OF_CLASSES; ++c) {
+    options.classes.push_back(c);
+  }
+  options.dimensions = parse_list("2,3,5");
+  options.instances = 3;
+  options.seeds = 3;
+  options.budget_multiplier = 10000;
+  options.out = ".";
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    if (i + 1 >= argc) {
+      usage(argv[0]);
+      return EXIT_FAILURE;
+    }
+    const std::string value = argv[++i];
+    if (arg == "--threads") {
+      options.threads = (unsigned) std::max(1, atoi(value.c_str()));
+    } else if (arg == "--configurations") {
+      options.configurations = (size_t) std::max(1, atoi(value.c_str()));
+    } else if (arg == "--eta") {
+      options.eta = (size_t) std::max(2, atoi(value.c_str()));
+    } else if (arg == "--classes") {
+      options.classes = parse_list(value);
+    } else if (arg == "--dimensions") {
+      options.dimensions = parse_list(value);
+    } else if (arg == "--instances") {
+      options.instances = (size_t) std::max(1, atoi(value.c_str()));
+    } else if (arg == "--seeds") {
+      options.seeds = (unsigned) std::max(1, atoi(value.c_str()));
+    } else if (arg == "--budget-multiplier") {
+      options.budget_multiplier = std::max(1L, atol(value.c_str()));
+    } else if (arg == "--out") {
+      options.out = value;
+    } else {
+      usage(argv[0]);
+      return EXIT_FAILURE;
+    }
+  }
+  for (size_t i = 0; i < options.classes.size(); ++i) {
+    if (options.classes[i] < 1 || options.classes[i] > NUMBER_OF_CLASSES) {
+      std::cerr << "Error: the classes are 1, ..., " << NUMBER_OF_CLASSES << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  coco_set_log_level("warning");
+  const std::vector<es::rayes::Parameters> configurations = sample_configurations(options.configurations);
+  try {
+    Runner runner(options, configurations);
+    std::vector<std::string> summary;
+    for (size_t i = 0; i < options.classes.size(); ++i) {
+      const size_t problem_class = options.classes[i];
+      const std::string name = CLASS_NAMES[problem_class - 1];
+      printf("Class %lu (%s)\n", (unsigned long) problem_class, name.c_str());
+      double default_score, best_score;
+      const size_t best = tune_class(problem_class, options, configurations.size(), runner, default_score,
+                                     best_score);
+
+      const std::string path = options.out + "/" + name + ".params";
+      std::ofstream file(path.c_str());
+      file << "# coco_tune: class " << problem_class << " (" << name << "), configuration " << best
+           << ", mean log10(evaluations / dimension) " << best_score << " (defaults " << default_score
+           << ")\n";
+      es::rayes::writeParameters(file, configurations[best]);
+      if (!file.flush()) {
+        throw std::runtime_error("cannot write " + path);
+      }
+
+      char line[256];
+      snprintf(line, sizeof(line), "%-20s %8.4f %8.4f %7.2fx  %s", name.c_str(), default_score, best_score,
+               pow(10.0, default_score - best_score), path.c_str());
+      summary.push_back(line);
+    }
+    printf("\n%% mean log10(evaluations / dimension) of the defaults and of the tuned configuration\n");
+    printf("%-20s %8s %8s %8s\n", "class", "default", "tuned", "speedup");
+    for (size_t i = 0; i < summary.size(); ++i) {
+      printf("%s\n", summary[i].c_str());
+    }
+  } catch (const std::exception &e) {
+    std::cerr << "Error: " << e.what() << std::endl;
+    return 2;
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,356 @@
+/**
+ * Implementation of the file-based work queue (see coco_work_queue.h).
+ *
+ * Only POSIX file system operations are used: a task is claimed with rename(), which is atomic on local
+ * file systems and on NFS, so no lock files are needed.
+ */
+#include "coco_work_queue.h"
+
+#include <dirent.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#include <algorithm>
+#include <fstream>
+#include <set>
+#include <sstream>
+#include <tuple>
+#include <vector>
+
+namespace {
+
+const char *const SUITE_FILE = "suite";
+const char *const PENDING_DIR = "pending";
+const char *const RUNNING_DIR = "running";
+const char *const DONE_DIR = "done";
+
+/**
+ * Returns the sorted names of the entries of the directory path (without "." and "..").
+ */
+std::vector<std::string> list_directory(const std::string &path) {
+  std::vector<std::string> names;
+  DIR *dir = opendir(path.c_str());
+  if (dir == NULL) {
+    coco_error("work_queue: cannot open directory %s (%s)", path.c_str(), strerror(errno));
+    return names; /* Never reached */
+  }
+  struct dirent *entry;
+  while ((entry = readdir(dir)) != NULL) {
+    if (strcmp(entry->d_name, ".") != 0 && strcmp(entry->d_name, "..") != 0) {
+      names.push_back(entry->d_name);
+    }
+  }
+  closedir(dir);
+  std::sort(names.begin(), names.end());
+  return names;
+}
+
+bool path_exists(const std::string &path) {
+  struct stat st;
+  return stat(path.c_str(), &st) == 0;
+}
+
+void make_directory(const std::string &path) {
+  if (mkdir(path.c_str(), 0755) != 0 && errno != EEXIST) {
+    coco_error("work_queue: cannot create directory %s (%s)", path.c_str(), strerror(errno));
+  }
+}
+
+bool ends_with(const std::string &str, const std::string &suffix) {
+  return str.size() >= suffix.size() && str.compare(str.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+std::string read_file(const std::string &path) {
+  std::ifstream file(path.c_str(), std::ios::binary);
+  if (!file) {
+    coco_error("work_queue: cannot read %s", path.c_str());
+  }
+  std::ostringstream content;
+  content << file.rdbuf();
+  return content.str();
+}
+
+/**
+ * Writes the file atomically: a reader (e.g. another worker) either sees the complete file or none.
+ */
+void write_file(const std::string &path, const std::string &content) {
+  const std::string tmp_path = path + ".tmp";
+  {
+    std::ofstream file(tmp_path.c_str(), std::ios::binary);
+    file << content;
+    if (!file.flush()) {
+      coco_error("work_queue: cannot write %s", tmp_path.c_str());
+    }
+  }
+  if (rename(tmp_path.c_str(), path.c_str()) != 0) {
+    coco_error("work_queue: cannot rename %s (%s)", tmp_path.c_str(), strerror(errno));
+  }
+}
+
+void copy_file(const std::string &from, const std::string &to) {
+  std::ifstream in(from.c_str(), std::ios::binary);
+  std::ofstream out(to.c_str(), std::ios::binary);
+  if (!in || !out) {
+    coco_error("work_queue: cannot copy %s to %s", from.c_str(), to.c_str());
+  }
+  out << in.rdbuf();
+  if (!out.flush()) {
+    coco_error("work_queue: cannot write %s", to.c_str());
+  }
+}
+
+/**
+ * Returns the dimension of a task, which is encoded at the end of the problem id ("..._d20").
+ */
+long task_dimension(const std::string &task) {
+  const size_t pos = task.rfind("_d");
+  return pos == std::string::npos ? 0 : strtol(task.c_str() + pos + 2, NULL, 10);
+}
+
+/**
+ * Orders the tasks by decreasing dimension: the expensive problems are claimed first such that the
+ * workers finish at about the same time.
+ */
+bool task_claimed_before(const std::string &task1, const std::string &task2) {
+  const long dimension1 = task_dimension(task1);
+  const long dimension2 = task_dimension(task2);
+  return dimension1 != dimension2 ? dimension1 > dimension2 : task1 < task2;
+}
+
+/**
+ * Moves a pending task to running (its name gets the suffix ".worker"). Returns false if no task is left.
+ */
+bool claim_task(const std::string &queue_dir, const std::string &worker, std::string &task) {
+  std::vector<std::string> tasks = list_directory(queue_dir + "/" + PENDING_DIR);
+  std::sort(tasks.begin(), tasks.end(), task_claimed_before);
+  for (size_t i = 0; i < tasks.size(); ++i) {
+    const std::string from = queue_dir + "/" + PENDING_DIR + "/" + tasks[i];
+    const std::string to = queue_dir + "/" + RUNNING_DIR + "/" + tasks[i] + "." + worker;
+    if (rename(from.c_str(), to.c_str()) == 0) {
+      task = tasks[i];
+      return true;
+    }
+    if (errno != ENOENT) {
+      coco_error("work_queue: cannot claim task %s (%s)", tasks[i].c_str(), strerror(errno));
+    }
+    /* Another worker claimed the task in the meantime */
+  }
+  return false;
+}
+
+/**
+ * Puts the tasks that the worker claimed but did not finish back to the pending tasks.
+ */
+void requeue_tasks(const std::string &queue_dir, const std::string &worker) {
+  const std::string suffix = "." + worker;
+  const std::vector<std::string> tasks = list_directory(queue_dir + "/" + RUNNING_DIR);
+  for (size_t i = 0; i < tasks.size(); ++i) {
+    if (!ends_with(tasks[i], suffix)) {
+      continue;
+    }
+    const std::string task = tasks[i].substr(0, tasks[i].size() - suffix.size());
+    const std::string from = queue_dir + "/" + RUNNING_DIR + "/" + tasks[i];
+    const std::string to = queue_dir + "/" + PENDING_DIR + "/" + task;
+    if (rename(from.c_str(), to.c_str()) != 0) {
+      coco_error("work_queue: cannot requeue task %s (%s)", task.c_str(), strerror(errno));
+    }
+    coco_info("work_queue: requeued unfinished task %s", task.c_str());
+  }
+}
+
+/**
+ * Merges the index files of one worker folder and copies the data files they refer to.
+ */
+void merge_worker_folder(const std::string &worker,
+                         const std::string &worker_folder,
+                         const std::string &merged_folder,
+                         std::set<std::tuple<long, long, long> > &runs) {
+  std::set<std::string> copied_files;
+  const std::vector<std::string> files = list_directory(worker_folder);
+  for (size_t i = 0; i < files.size(); ++i) {
+    if (!ends_with(files[i], ".info")) {
+      continue;
+    }
+    std::istringstream info(read_file(worker_folder + "/" + files[i]));
+    std::ostringstream merged_info;
+    std::string line;
+    long function = 0, dimension = 0;
+    while (std::getline(info, line)) {
+      if (line.compare(0, 5, "suite") == 0 || line.compare(0, 8, "funcId =") == 0) {
+        const size_t function_pos = line.find("funcId = ");
+        const size_t dimension_pos = line.find("DIM = ");
+        function = function_pos == std::string::npos ? 0 : strtol(line.c_str() + function_pos + 9, NULL, 10);
+        dimension = dimension_pos == std::string::npos ? 0 : strtol(line.c_str() + dimension_pos + 6, NULL, 10);
+        merged_info << line << "\n";
+        continue;
+      }
+      const size_t slash_pos = line.find('/');
+      const size_t comma_pos = line.find(',');
+      if (line.empty() || line[0] == '%' || slash_pos == std::string::npos || comma_pos < slash_pos) {
+        merged_info << line << "\n";
+        continue;
+      }
+
+      /* The entries ", instance:evaluations|precision" of the runs in this group */
+      const std::string data_path = line.substr(0, comma_pos);
+      std::istringstream entries(line.substr(comma_pos));
+      std::string entry;
+      while (std::getline(entries, entry, ',')) {
+        if (entry.empty()) {
+          continue;
+        }
+        if (entry.find(':') == std::string::npos || entry.find('|') == std::string::npos) {
+          coco_error("work_queue: unfinished run in %s/%s of worker %s, restart the worker first",
+                     worker_folder.c_str(), files[i].c_str(), worker.c_str());
+        }
+        const long instance = strtol(entry.c_str(), NULL, 10);
+        if (!runs.insert(std::make_tuple(function, dimension, instance)).second) {
+          /* The merged index would count the run twice */
+          coco_error("work_queue: run f%ld_i%02ld_d%02ld of worker %s is a duplicate",
+                     function, instance, dimension, worker.c_str());
+        }
+      }
+
+      /* Copy the data files of the group with the worker name as prefix */
+      const std::string data_dir = data_path.substr(0, slash_pos);
+      const std::string merged_path = data_dir + "/" + worker + "_" + data_path.substr(slash_pos + 1);
+      make_directory(merged_folder + "/" + data_dir);
+      if (copied_files.insert(data_path).second) {
+        const std::string base = data_path.substr(0, data_path.rfind('.'));
+        const std::string merged_base = merged_path.substr(0, merged_path.rfind('.'));
+        const char *extensions[] = { ".dat", ".tdat", ".rdat" };
+        for (size_t j = 0; j < sizeof(extensions) / sizeof(extensions[0]); ++j) {
+          const std::string from = worker_folder + "/" + base + extensions[j];
+          if (path_exists(from)) {
+            copy_file(from, merged_folder + "/" + merged_base + extensions[j]);
+          }
+        }
+      }
+      merged_info << merged_path << line.substr(comma_pos) << "\n";
+    }
+    write_file(merged_folder + "/" + worker + "_" + files[i], merged_info.str());
+  }
+}
+
+}
+
+void work_queue_init(const std::string &queue_dir,
+                     const char *suite_name,
+                     const char *suite_instance,
+                     const char *suite_options) {
+  if (path_exists(queue_dir + "/" + SUITE_FILE)) {
+    coco_error("work_queue: queue %s exists already", queue_dir.c_str());
+  }
+  make_directory(queue_dir);
+  make_directory(queue_dir + "/" + PENDING_DIR);
+  make_directory(queue_dir + "/" + RUNNING_DIR);
+  make_directory(queue_dir + "/" + DONE_DIR);
+
+  coco_suite_t *suite = coco_suite(suite_name, suite_instance, suite_options);
+  coco_problem_t *problem;
+  size_t number_of_tasks = 0;
+  while ((problem = coco_suite_get_next_problem(suite, NULL)) != NULL) {
+    std::ostringstream index;
+    index << coco_problem_get_suite_dep_index(problem) << "\n";
+    write_file(queue_dir + "/" + PENDING_DIR + "/" + coco_problem_get_id(problem), index.str());
+    ++number_of_tasks;
+  }
+  coco_suite_free(suite);
+
+  /* Written last: a queue without suite file is incomplete */
+  write_file(queue_dir + "/" + SUITE_FILE,
+             std::string(suite_name) + "\n" + suite_instance + "\n" + suite_options + "\n");
+  coco_info("work_queue: created %lu tasks in %s", (unsigned long) number_of_tasks, queue_dir.c_str());
+}
+
+void work_queue_work(const std::string &queue_dir,
+                     const std::string &worker,
+                     const char *observer_name,
+                     const std::string &observer_options,
+                     const std::string &observer_result_folder,
+                     work_queue_run_function_t run) {
+  if (worker.empty() || worker.find_first_of("./") != std::string::npos) {
+    coco_error("work_queue: invalid worker name '%s'", worker.c_str());
+  }
+
+  std::istringstream suite_definition(read_file(queue_dir + "/" + SUITE_FILE));
+  std::string suite_name, suite_instance, suite_options;
+  std::getline(suite_definition, suite_name);
+  std::getline(suite_definition, suite_instance);
+  std::getline(suite_definition, suite_options);
+
+  requeue_tasks(queue_dir, worker);
+
+  /* With resume, the output of a previous (interrupted) execution of this worker is continued */
+  char *options = coco_strdupf("%s result_folder: %s resume: 1",
+                               observer_options.c_str(), observer_result_folder.c_str());
+  coco_suite_t *suite = coco_suite(suite_name.c_str(), suite_instance.c_str(), suite_options.c_str());
+  coco_observer_t *observer = coco_observer(observer_name, options);
+  coco_free_memory(options);
+
+  std::string task;
+  size_t number_of_tasks = 0;
+  while (claim_task(queue_dir, worker, task)) {
+    const std::string running_path = queue_dir + "/" + RUNNING_DIR + "/" + task + "." + worker;
+    const size_t index = (size_t) strtoul(read_file(running_path).c_str(), NULL, 10);
+    coco_problem_t *problem = coco_problem_add_observer(coco_suite_get_problem(suite, index), observer);
+    if (task != coco_problem_get_id(problem)) {
+      coco_error("work_queue: task %s does not match problem %s (different suite definition?)",
+                 task.c_str(), coco_problem_get_id(problem));
+    }
+
+    /* The run may have been completed just before the worker was interrupted */
+    if (!coco_observer_is_run_completed(observer, problem)) {
+      run(problem);
+    }
+    /* Finalizes the output of the run */
+    coco_problem_free(problem);
+
+    const std::string done_path = queue_dir + "/" + DONE_DIR + "/" + task + "." + worker;
+    if (rename(running_path.c_str(), done_path.c_str()) != 0) {
+      coco_error("work_queue: cannot complete task %s (%s)", task.c_str(), strerror(errno));
+    }
+    ++number_of_tasks;
+  }
+
+  coco_observer_free(observer);
+  coco_suite_free(suite);
+  coco_info("work_queue: worker %s completed %lu tasks", worker.c_str(), (unsigned long) number_of_tasks);
+}
+
+void work_queue_merge(const std::string &queue_dir,
+                      const std::string &worker_folder_prefix,
+                      const std::string &merged_folder) {
+  const size_t number_of_pending = list_directory(queue_dir + "/" + PENDING_DIR).size();
+  const size_t number_of_running = list_directory(queue_dir + "/" + RUNNING_DIR).size();
+  if (number_of_pending > 0 || number_of_running > 0) {
+    coco_error("work_queue: %lu tasks are pending and %lu tasks are running, cannot merge",
+               (unsigned long) number_of_pending, (unsigned long) number_of_running);
+  }
+  if (path_exists(merged_folder)) {
+    coco_error("work_queue: %s exists already", merged_folder.c_str());
+  }
+
+  /* The workers are the suffixes of the done tasks */
+  const std::vector<std::string> tasks = list_directory(queue_dir + "/" + DONE_DIR);
+  std::set<std::string> workers;
+  for (size_t i = 0; i < tasks.size(); ++i) {
+    workers.insert(tasks[i].substr(tasks[i].rfind('.') + 1));
+  }
+
+  make_directory(merged_folder);
+  std::set<std::tuple<long, long, long> > runs;
+  for (std::set<std::string>::const_iterator worker = workers.begin(); worker != workers.end(); ++worker) {
+    merge_worker_folder(*worker, worker_folder_prefix + *worker, merged_folder, runs);
+  }
+  if (runs.size() != tasks.size()) {
+    coco_warning("work_queue: %lu tasks are done, but the output contains %lu runs",
+                 (unsigned long) tasks.size(), (unsigned long) runs.size());
+  }
+  coco_info("work_queue: merged %lu runs of %lu workers into %s",
+            (unsigned long) runs.size(), (unsigned long) workers.size(), merged_folder.c_str());
+}
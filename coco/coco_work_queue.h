@@ -0,0 +1,65 @@
+/**
+ * A file-based work queue that distributes the problems of a COCO suite among several worker processes,
+ * possibly on different machines that share the queue directory.
+ *
+ * The queue directory contains the suite definition (file "suite") and the subdirectories "pending",
+ * "running" and "done" with one task file per problem. A worker claims a task by renaming its file from
+ * "pending" to "running" (rename is atomic, so every task is claimed by exactly one worker) and moves it to
+ * "done" when the run is finished. Every worker writes its own COCO output (observer option "resume: 1"),
+ * the outputs are combined with work_queue_merge() once all tasks are done.
+ */
+#ifndef COCO_WORK_QUEUE_H
+#define COCO_WORK_QUEUE_H
+
+#include <string>
+
+#include "coco.h"
+
+/**
+ * A function that runs the optimization algorithm on the given (observed) problem.
+ */
+typedef void (*work_queue_run_function_t)(coco_problem_t *problem);
+
+/**
+ * Creates the queue in queue_dir with one pending task for each problem of the suite defined by
+ * suite_name, suite_instance and suite_options (see coco_suite()).
+ */
+void work_queue_init(const std::string &queue_dir,
+                     const char *suite_name,
+                     const char *suite_instance,
+                     const char *suite_options);
+
+/**
+ * Claims and runs tasks of the queue until no pending task is left.
+ *
+ * The results are written to the result folder observer_result_folder (inside the "exdata" folder). The
+ * tasks this worker claimed but did not finish before (e.g. because the process was killed) are put back
+ * to the queue first, so a worker is restarted by running it again with the same name.
+ *
+ * @param queue_dir The queue directory.
+ * @param worker The name of the worker (unique among the workers, without '.' and '/').
+ * @param observer_name The name of the observer (see coco_observer()).
+ * @param observer_options The options of the observer without result_folder and resume.
+ * @param observer_result_folder The result folder of this worker.
+ * @param run The function that runs the algorithm on a problem.
+ */
+void work_queue_work(const std::string &queue_dir,
+                     const std::string &worker,
+                     const char *observer_name,
+                     const std::string &observer_options,
+                     const std::string &observer_result_folder,
+                     work_queue_run_function_t run);
+
+/**
+ * Merges the COCO output of all workers that finished tasks of the queue into merged_folder.
+ *
+ * The output of worker W is expected in worker_folder_prefix + W. Its index and data files are copied with
+ * the prefix "W_" and the paths to the data files in the index files are adapted. Fails if tasks are still
+ * pending or running, if merged_folder exists or if a run (function, dimension, instance) was done by
+ * several workers or twice by one worker.
+ */
+void work_queue_merge(const std::string &queue_dir,
+                      const std::string &worker_folder_prefix,
+                      const std::string &merged_folder);
+
+#endif
@@ -0,0 +1,81 @@
+/*! \file
+ *  \brief Contains a lock-free histogram of latencies.
+ */
+
+#ifndef ES_CORE_LATENCYHISTOGRAM_H
+#define ES_CORE_LATENCYHISTOGRAM_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+
+namespace es {
+namespace core {
+
+/*!
+ * \brief Histogram of latencies in nanoseconds with logarithmic buckets.
+ *
+ * As in HdrHistogram, every power of two is divided into 32 linear
+ * buckets, so quantiles are accurate to about 3% of the value (values
+ * below 64 ns exactly) up to about 2^45 ns (9.7 hours); larger values are
+ * counted in the last bucket. The counts are atomic, so any number of
+ * threads can record into the same histogram without locks, and
+ * histograms of several threads or runs are combined with merge().
+ */
+class LatencyHistogram {
+ public:
+    LatencyHistogram();
+    LatencyHistogram(const LatencyHistogram &other);
+    LatencyHistogram &operator=(const LatencyHistogram &other);
+
+    /*! Records a latency (thread-safe). */
+    void record(std::uint64_t nanoseconds);
+
+    /*! Adds the recorded values of other. */
+    void merge(const LatencyHistogram &other);
+
+    /*! Removes all recorded values. */
+    void reset();
+
+    std::uint64_t getCount() const;
+    /*! Smallest and largest recorded value (0 if there is none). */
+    std::uint64_t getMin() const;
+    std::uint64_t getMax() const;
+    double getMean() const;
+
+    /*!
+     * \brief Returns the q-quantile (q in [0, 1]).
+     *
+     * This is the upper end of the bucket of the smallest recorded value
+     * that is greater or equal to the fraction q of the values (at most
+     * the largest recorded value, 0 if there is none).
+     */
+    std::uint64_t getQuantile(double q) const;
+
+    /*!
+     * \brief Writes a summary line with quantiles followed by the non-empty
+     * buckets as lines "lower upper count cumulative-fraction".
+     */
+    void write(std::ostream &os) const;
+
+ private:
+    static const int kSubBucketBits = 5;
+    static const int kMaxExponent = 45;
+    static const int kNumBuckets =
+        (kMaxExponent - kSubBucketBits + 2) << kSubBucketBits;
+
+    static int bucketIndex(std::uint64_t value);
+    static std::uint64_t bucketLower(int index);
+    static std::uint64_t bucketUpper(int index);
+
+    std::array<std::atomic<std::uint64_t>, kNumBuckets> m_counts;
+    std::atomic<std::uint64_t> m_sum;
+    std::atomic<std::uint64_t> m_min;
+    std::atomic<std::uint64_t> m_max;
+};
+
+}
+}
+
+#endif
@@ -0,0 +1,50 @@
+/*! \file
+ *  \brief Contains a generator for Sobol low-discrepancy sequences.
+ */
+
+#ifndef ES_CORE_SOBOL_H
+#define ES_CORE_SOBOL_H
+
+#include <cstdint>
+#include <vector>
+
+#include <Eigen/Dense>
+
+namespace es {
+namespace core {
+
+/*! \brief Generator for (scrambled) Sobol sequences of arbitrary dimension.
+ *
+ * The primitive polynomials needed for the dimensions are enumerated
+ * on construction. Without scrambling, all initial direction numbers are 1.
+ * With scrambling, the initial direction numbers are chosen at random
+ * (odd and smaller than 2^k as required) and a random digital shift is
+ * applied to every coordinate.
+ */
+class Sobol {
+ public:
+    Sobol(int dimension, bool scramble);
+
+    int dimension() const;
+
+    /*!
+     * \brief Returns the next points of the sequence.
+     *
+     * The result is a dimension times nPoints matrix whose columns are
+     * points in the open unit cube (0, 1)^dimension.
+     */
+    Eigen::MatrixXd next(int nPoints);
+
+ private:
+    static constexpr int NUM_BITS = 32;
+
+    int m_dimension;
+    std::vector<std::uint32_t> m_directions;
+    std::vector<std::uint32_t> m_state;
+    std::uint32_t m_index;
+};
+
+}
+}
+
+#endif
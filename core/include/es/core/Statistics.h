@@ -0,0 +1,66 @@
+/*! \file
+ *  \brief Contains statistical tests for comparing samples.
+ */
+
+#ifndef ES_CORE_STATISTICS_H
+#define ES_CORE_STATISTICS_H
+
+#include <vector>
+
+namespace es {
+namespace core {
+
+/*!
+ * \brief Returns the median of the sample.
+ *
+ * Infinite values are allowed (e.g. for unsuccessful runs).
+ */
+double median(std::vector<double> sample);
+
+/*!
+ * \brief One-sided Mann-Whitney U test.
+ *
+ * Returns the p-value of the hypothesis that the values of sample b tend
+ * to be greater than the values of sample a. The normal approximation with
+ * tie and continuity correction is used, which is adequate for samples of
+ * about ten or more values. Infinite values are allowed and ranked last.
+ */
+double mannWhitneyUTest(const std::vector<double> &a,
+                        const std::vector<double> &b);
+
+/*!
+ * \brief Two-sided Mann-Whitney U test.
+ *
+ * Returns the p-value of the hypothesis that the values of one sample tend
+ * to be greater than the values of the other one (twice the smaller
+ * one-sided p-value, at most 1).
+ */
+double mannWhitneyUTestTwoSided(const std::vector<double> &a,
+                                const std::vector<double> &b);
+
+/*!
+ * \brief Two-sample Kolmogorov-Smirnov test.
+ *
+ * Returns the p-value of the hypothesis that the samples come from
+ * different distributions. The asymptotic distribution of the statistic
+ * with Stephens' correction for the effective sample size is used.
+ * Infinite values are allowed.
+ */
+double kolmogorovSmirnovTest(const std::vector<double> &a,
+                             const std::vector<double> &b);
+
+/*!
+ * \brief Chi-square test of homogeneity of two categorical samples.
+ *
+ * countsA[i] and countsB[i] are the numbers of observations of category i
+ * in the samples. Returns the p-value of the hypothesis that the category
+ * frequencies differ; categories that occur in neither sample are ignored.
+ * The approximation is rough if expected counts are below five.
+ */
+double chiSquareTest(const std::vector<int> &countsA,
+                     const std::vector<int> &countsB);
+
+}
+}
+
+#endif
@@ -0,0 +1,116 @@
+/*! \file
+ *  \brief Contains a pool of (optionally pinned) worker threads.
+ */
+
+#ifndef ES_CORE_WORKERPOOL_H
+#define ES_CORE_WORKERPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace es {
+namespace core {
+
+/*! \brief The CPUs the process may run on, grouped by NUMA node. */
+struct CpuTopology {
+    /*! Allowed CPUs ordered by node (the affinity mask of the process, so
+     *  cpusets and taskset restrict them). */
+    std::vector<int> cpus;
+    /*! NUMA node of each entry of cpus. */
+    std::vector<int> nodes;
+};
+
+/*!
+ * \brief Reads the topology from /sys/devices/system/node (all allowed
+ * CPUs are on node 0 if it is not available).
+ */
+CpuTopology detectCpuTopology();
+
+/*!
+ * \brief Runs batches of tasks on persistent worker threads.
+ *
+ * The tasks 0, ..., numTasks - 1 of a batch are split into contiguous
+ * ranges, one per worker. A worker that finished its range steals tasks
+ * from the ranges of the workers on its own NUMA node first and from the
+ * other nodes last.
+ *
+ * With pinning, the workers are bound to the allowed CPUs in the order of
+ * the topology, i.e. the first node is filled before the next one is used,
+ * which keeps small pools (and the data they share) on one socket. Every
+ * worker allocates its own state after it is pinned, and memory that a
+ * task allocates is first touched by its worker, so both are placed on the
+ * worker's node by the default first-touch policy of Linux. The random
+ * number generator of es::core is thread-local and thus per worker, too.
+ */
+class WorkerPool {
+ public:
+    /*! A task receives its index and the index of the worker. */
+    typedef std::function<void(int task, int worker)> Task;
+
+    WorkerPool(int numWorkers, bool pinWorkers);
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool &) = delete;
+    WorkerPool &operator=(const WorkerPool &) = delete;
+
+    int getNumWorkers() const;
+
+    /*! Adds workers until there are numWorkers (not during a batch). */
+    void reserveWorkers(int numWorkers);
+
+    /*!
+     * \brief Runs the tasks and waits for them.
+     *
+     * Rethrows the exception of the task with the smallest index.
+     */
+    void run(int numTasks, const Task &task);
+
+    /*!
+     * \brief Starts the tasks without waiting.
+     *
+     * wait() must be called before the next batch is started. The task
+     * must stay alive until then.
+     */
+    void start(int numTasks, const Task &task);
+
+    /*! Waits for the started batch and rethrows like run(). */
+    void wait();
+
+    /*! Number of tasks that were run by another worker than the one whose
+     *  range they belonged to. */
+    long getNumStolenTasks() const;
+
+ private:
+    struct Worker;
+
+    void work(int index);
+    bool runTask(Worker &owner, int worker);
+    void stop();
+
+    CpuTopology m_topology;
+    bool m_pinWorkers;
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    std::vector<std::thread> m_threads;
+
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_done;
+    unsigned long m_batch;
+    int m_numBusy;
+    int m_numInitialized;
+    bool m_stop;
+    Task m_task;
+    std::vector<std::exception_ptr> m_errors;
+    std::atomic<long> m_numStolenTasks;
+};
+
+}
+}
+
+#endif
@@ -28,6 +28,16 @@ std::string toString(const T &v) {
     return os.str();
 }
 
+/*!
+ * \brief Seeds the random number generator used by randn and rand.
+ *
+ * Every thread draws all random variates from its own generator, such that
+ * seeded runs in parallel threads are reproducible. Without a call to
+ * seedRandom, the generator of a thread is seeded from the clock on first
+ * use.
+ */
+void seedRandom(unsigned seed);
+
 /*!
  * \brief Initializes a matrix with
  * iid standard normally distributed random variates.
@@ -37,6 +47,16 @@ std::string toString(const T &v) {
  */
 Eigen::MatrixXd randn(int nRows, int nCols);
 
+/*!
+ * \brief Fills a matrix with iid standard normally distributed random
+ * variates in place.
+ *
+ * The variates are drawn in the same order as by randn(int, int), so the
+ * double version yields the same matrix; the float version rounds them.
+ */
+void randn(Eigen::Ref<Eigen::MatrixXd> m);
+void randn(Eigen::Ref<Eigen::MatrixXf> m);
+
 /*!
 * \brief Initializes a matrix with iid uniformly distributed random variates.
 *
@@ -46,6 +66,15 @@ Eigen::MatrixXd randn(int nRows, int nCols);
 */
 Eigen::MatrixXd rand(int nRows, int nCols, double lo, double hi);
 
+/*!
+ * \brief Computes the inverse of the standard normal
+ * cumulative distribution function.
+ *
+ * Uses the rational approximation by P. J. Acklam refined
+ * by one step of Halley's method. The argument must be in (0, 1).
+ */
+double normInv(double p);
+
 }
 }
 
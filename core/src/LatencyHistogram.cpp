@@ -0,0 +1,177 @@
+#include "es/core/LatencyHistogram.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace es {
+namespace core {
+
+namespace {
+
+const std::memory_order relaxed = std::memory_order_relaxed;
+
+// floor(log2(value)) for value > 0
+int floorLog2(std::uint64_t value) {
+    int exponent = 0;
+    while (value >>= 1) {
+        ++exponent;
+    }
+    return exponent;
+}
+
+void atomicMin(std::atomic<std::uint64_t> &target, std::uint64_t value) {
+    std::uint64_t current = target.load(relaxed);
+    while (value < current &&
+           !target.compare_exchange_weak(current, value, relaxed)) {
+    }
+}
+
+void atomicMax(std::atomic<std::uint64_t> &target, std::uint64_t value) {
+    std::uint64_t current = target.load(relaxed);
+    while (value > current &&
+           !target.compare_exchange_weak(current, value, relaxed)) {
+    }
+}
+
+}
+
+LatencyHistogram::LatencyHistogram() {
+    reset();
+}
+
+LatencyHistogram::LatencyHistogram(const LatencyHistogram &other) {
+    reset();
+    merge(other);
+}
+
+LatencyHistogram &LatencyHistogram::operator=(
+        const LatencyHistogram &other) {
+    if (this != &other) {
+        reset();
+        merge(other);
+    }
+    return *this;
+}
+
+void LatencyHistogram::record(std::uint64_t nanoseconds) {
+    m_counts[bucketIndex(nanoseconds)].fetch_add(1, relaxed);
+    m_sum.fetch_add(nanoseconds, relaxed);
+    atomicMin(m_min, nanoseconds);
+    atomicMax(m_max, nanoseconds);
+}
+
+void LatencyHistogram::merge(const LatencyHistogram &other) {
+    for (int i = 0; i < kNumBuckets; ++i) {
+        const std::uint64_t count = other.m_counts[i].load(relaxed);
+        if (count > 0) {
+            m_counts[i].fetch_add(count, relaxed);
+        }
+    }
+    m_sum.fetch_add(other.m_sum.load(relaxed), relaxed);
+    atomicMin(m_min, other.m_min.load(relaxed));
+    atomicMax(m_max, other.m_max.load(relaxed));
+}
+
+void LatencyHistogram::reset() {
+    for (std::atomic<std::uint64_t> &count : m_counts) {
+        count.store(0, relaxed);
+    }
+    m_sum.store(0, relaxed);
+    m_min.store(std::numeric_limits<std::uint64_t>::max(), relaxed);
+    m_max.store(0, relaxed);
+}
+
+std::uint64_t LatencyHistogram::getCount() const {
+    std::uint64_t count = 0;
+    for (const std::atomic<std::uint64_t> &bucketCount : m_counts) {
+        count += bucketCount.load(relaxed);
+    }
+    return count;
+}
+
+std::uint64_t LatencyHistogram::getMin() const {
+    return getCount() > 0 ? m_min.load(relaxed) : 0;
+}
+
+std::uint64_t LatencyHistogram::getMax() const {
+    return m_max.load(relaxed);
+}
+
+double LatencyHistogram::getMean() const {
+    const std::uint64_t count = getCount();
+    return count > 0 ?
+        static_cast<double>(m_sum.load(relaxed)) / count : 0.0;
+}
+
+std::uint64_t LatencyHistogram::getQuantile(double q) const {
+    const std::uint64_t count = getCount();
+    if (count == 0) {
+        return 0;
+    }
+    const std::uint64_t rank = std::max<std::uint64_t>(1,
+        static_cast<std::uint64_t>(std::ceil(
+            std::min(1.0, std::max(0.0, q)) * count)));
+    std::uint64_t cumulative = 0;
+    for (int i = 0; i < kNumBuckets; ++i) {
+        cumulative += m_counts[i].load(relaxed);
+        if (cumulative >= rank) {
+            return std::min(bucketUpper(i), getMax());
+        }
+    }
+    return getMax();
+}
+
+void LatencyHistogram::write(std::ostream &os) const {
+    os << "count " << getCount() << " min " << getMin() << " mean "
+       << getMean() << " p50 " << getQuantile(0.5) << " p90 "
+       << getQuantile(0.9) << " p99 " << getQuantile(0.99) << " p99.9 "
+       << getQuantile(0.999) << " p99.99 " << getQuantile(0.9999)
+       << " max " << getMax() << " (ns)\n";
+    const std::uint64_t count = getCount();
+    std::uint64_t cumulative = 0;
+    for (int i = 0; i < kNumBuckets; ++i) {
+        const std::uint64_t bucketCount = m_counts[i].load(relaxed);
+        if (bucketCount == 0) {
+            continue;
+        }
+        cumulative += bucketCount;
+        os << bucketLower(i) << " " << bucketUpper(i) << " " << bucketCount
+           << " " << static_cast<double>(cumulative) / count << "\n";
+    }
+}
+
+// values below 2^(kSubBucketBits + 1) have their own buckets; above, the
+// kSubBucketBits bits after the leading one select the bucket
+int LatencyHistogram::bucketIndex(std::uint64_t value) {
+    if (value < (std::uint64_t(2) << kSubBucketBits)) {
+        return static_cast<int>(value);
+    }
+    const int exponent = floorLog2(value);
+    if (exponent > kMaxExponent) {
+        return kNumBuckets - 1;
+    }
+    const int shift = exponent - kSubBucketBits;
+    return (shift << kSubBucketBits) + static_cast<int>(value >> shift);
+}
+
+std::uint64_t LatencyHistogram::bucketLower(int index) {
+    if (index < (2 << kSubBucketBits)) {
+        return index;
+    }
+    const int shift = (index >> kSubBucketBits) - 1;
+    const std::uint64_t subBucket =
+        (index & ((1 << kSubBucketBits) - 1)) + (1 << kSubBucketBits);
+    return subBucket << shift;
+}
+
+std::uint64_t LatencyHistogram::bucketUpper(int index) {
+    if (index < (2 << kSubBucketBits)) {
+        return index;
+    }
+    const int shift = (index >> kSubBucketBits) - 1;
+    return bucketLower(index) + (std::uint64_t(1) << shift) - 1;
+}
+
+}
+}
@@ -0,0 +1,188 @@
+#include "es/core/Sobol.h"
+#include "es/core/util.h"
+
+#include <cmath>
+#include <stdexcept>
+
+namespace es {
+namespace core {
+
+namespace {
+
+// Polynomials over GF(2) are represented as bit masks where bit i
+// is the coefficient of x^i.
+
+std::uint64_t mulMod(std::uint64_t a, std::uint64_t b,
+                     std::uint64_t p, int degree) {
+    std::uint64_t r = 0;
+    while (b) {
+        if (b & 1) {
+            r ^= a;
+        }
+        b >>= 1;
+        a <<= 1;
+        if ((a >> degree) & 1) {
+            a ^= p;
+        }
+    }
+    return r;
+}
+
+std::uint64_t powMod(std::uint64_t a, std::uint64_t e,
+                     std::uint64_t p, int degree) {
+    std::uint64_t r = 1;
+    while (e) {
+        if (e & 1) {
+            r = mulMod(r, a, p, degree);
+        }
+        e >>= 1;
+        a = mulMod(a, a, p, degree);
+    }
+    return r;
+}
+
+std::vector<std::uint64_t> primeFactors(std::uint64_t n) {
+    std::vector<std::uint64_t> factors;
+    for (std::uint64_t q = 2; q * q <= n; ++q) {
+        if (n % q == 0) {
+            factors.push_back(q);
+            while (n % q == 0) {
+                n /= q;
+            }
+        }
+    }
+    if (n > 1) {
+        factors.push_back(n);
+    }
+    return factors;
+}
+
+// A polynomial of the given degree is primitive iff x has the
+// multiplicative order 2^degree - 1 modulo the polynomial.
+bool isPrimitive(std::uint64_t p, int degree,
+                 const std::vector<std::uint64_t> &orderFactors) {
+    const std::uint64_t order = (std::uint64_t(1) << degree) - 1;
+    const std::uint64_t x = degree == 1 ? 1 : 2;
+    if (powMod(x, order, p, degree) != 1) {
+        return false;
+    }
+    for (std::uint64_t q : orderFactors) {
+        if (powMod(x, order / q, p, degree) == 1) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::vector<std::uint64_t> primitivePolynomials(int count) {
+    std::vector<std::uint64_t> polynomials;
+    for (int degree = 1; static_cast<int>(polynomials.size()) < count;
+         ++degree) {
+        if (degree >= 32) {
+            throw std::runtime_error("Sobol: dimension too large");
+        }
+        const std::vector<std::uint64_t> orderFactors =
+            primeFactors((std::uint64_t(1) << degree) - 1);
+        const std::uint64_t first = (std::uint64_t(1) << degree) | 1;
+        const std::uint64_t last = std::uint64_t(1) << (degree + 1);
+        for (std::uint64_t p = first;
+             p < last && static_cast<int>(polynomials.size()) < count;
+             p += 2) {
+            if (isPrimitive(p, degree, orderFactors)) {
+                polynomials.push_back(p);
+            }
+        }
+    }
+    return polynomials;
+}
+
+int degreeOf(std::uint64_t p) {
+    int degree = 0;
+    while (p >>= 1) {
+        ++degree;
+    }
+    return degree;
+}
+
+}
+
+Sobol::Sobol(int dimension, bool scramble)
+    : m_dimension(dimension)
+    , m_directions(static_cast<std::size_t>(dimension) * NUM_BITS)
+    , m_state(dimension, 0)
+    , m_index(0)
+{
+    if (dimension < 1) {
+        throw std::runtime_error("Sobol: dimension must be positive");
+    }
+    const Eigen::MatrixXd u = scramble ?
+        rand(NUM_BITS + 1, dimension, 0.0, 1.0) :
+        Eigen::MatrixXd::Zero(NUM_BITS + 1, dimension);
+    const std::vector<std::uint64_t> polynomials =
+        primitivePolynomials(dimension - 1);
+
+    std::vector<std::uint32_t> m(NUM_BITS + 1);
+    for (int j = 0; j < dimension; ++j) {
+        std::uint32_t *v = &m_directions[static_cast<std::size_t>(j) *
+                                         NUM_BITS];
+        if (j == 0) {
+            // van der Corput sequence
+            for (int k = 1; k <= NUM_BITS; ++k) {
+                v[k - 1] = std::uint32_t(1) << (NUM_BITS - k);
+            }
+        } else {
+            const std::uint64_t p = polynomials[j - 1];
+            const int s = degreeOf(p);
+            for (int k = 1; k <= s; ++k) {
+                // odd and smaller than 2^k
+                const double span = std::ldexp(1.0, k - 1);
+                m[k] = 2 * static_cast<std::uint32_t>(
+                               std::floor(u(k, j) * span)) + 1;
+            }
+            for (int k = s + 1; k <= NUM_BITS; ++k) {
+                std::uint32_t mk = m[k - s] ^ (m[k - s] << s);
+                for (int i = 1; i < s; ++i) {
+                    if ((p >> (s - i)) & 1) {
+                        mk ^= m[k - i] << i;
+                    }
+                }
+                m[k] = mk;
+            }
+            for (int k = 1; k <= NUM_BITS; ++k) {
+                v[k - 1] = m[k] << (NUM_BITS - k);
+            }
+        }
+        m_state[j] = static_cast<std::uint32_t>(
+            std::floor(u(0, j) * std::ldexp(1.0, NUM_BITS)));
+    }
+}
+
+int Sobol::dimension() const {
+    return m_dimension;
+}
+
+Eigen::MatrixXd Sobol::next(int nPoints) {
+    Eigen::MatrixXd points(m_dimension, nPoints);
+    const double scale = std::ldexp(1.0, -NUM_BITS);
+    for (int col = 0; col < nPoints; ++col) {
+        // Gray code ordering: flip the direction number of the
+        // rightmost zero bit of the index
+        int c = 0;
+        while ((m_index >> c) & 1) {
+            ++c;
+        }
+        if (c >= NUM_BITS) {
+            throw std::runtime_error("Sobol: sequence exhausted");
+        }
+        ++m_index;
+        for (int j = 0; j < m_dimension; ++j) {
+            m_state[j] ^= m_directions[static_cast<std::size_t>(j) *
+                                       NUM_BITS + c];
+            points(j, col) = (static_cast<double>(m_state[j]) + 0.5) * scale;
+        }
+    }
+    return points;
+}
+
+}
+}
@@ -0,0 +1,207 @@
+#include "es/core/Statistics.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+namespace es {
+namespace core {
+
+namespace {
+
+// regularized upper incomplete gamma function Q(a, x) by its series
+// (x < a + 1) or its continued fraction (Numerical Recipes, 6.2)
+double gammaQ(double a, double x) {
+    if (!(x > 0.0)) {
+        return 1.0;
+    }
+    const double logPrefactor = -x + a * std::log(x) - std::lgamma(a);
+    if (x < a + 1.0) {
+        double term = 1.0 / a;
+        double sum = term;
+        for (int n = 1; n < 1000 && std::abs(term) > 1e-15 * sum; ++n) {
+            term *= x / (a + n);
+            sum += term;
+        }
+        return std::max(0.0, 1.0 - sum * std::exp(logPrefactor));
+    }
+    const double tiny = 1e-300;
+    double b = x + 1.0 - a;
+    double c = 1.0 / tiny;
+    double d = 1.0 / b;
+    double h = d;
+    for (int i = 1; i < 1000; ++i) {
+        const double an = -i * (i - a);
+        b += 2.0;
+        d = an * d + b;
+        d = std::abs(d) < tiny ? tiny : d;
+        c = b + an / c;
+        c = std::abs(c) < tiny ? tiny : c;
+        d = 1.0 / d;
+        const double delta = d * c;
+        h *= delta;
+        if (std::abs(delta - 1.0) < 1e-15) {
+            break;
+        }
+    }
+    return std::exp(logPrefactor) * h;
+}
+
+// complementary distribution function of the Kolmogorov distribution
+double kolmogorovQ(double lambda) {
+    if (lambda < 0.2) {
+        return 1.0;
+    }
+    double sum = 0.0;
+    double sign = 1.0;
+    for (int j = 1; j <= 100; ++j) {
+        const double term = sign * std::exp(-2.0 * j * j * lambda * lambda);
+        sum += term;
+        if (std::abs(term) < 1e-12 * std::abs(sum)) {
+            break;
+        }
+        sign = -sign;
+    }
+    return std::min(1.0, std::max(0.0, 2.0 * sum));
+}
+
+}
+
+double median(std::vector<double> sample) {
+    if (sample.empty()) {
+        throw std::runtime_error("median: empty sample");
+    }
+    std::sort(sample.begin(), sample.end());
+    const std::size_t n = sample.size();
+    if (n % 2 == 1 || sample[n / 2 - 1] == sample[n / 2]) {
+        return sample[n / 2];
+    }
+    return 0.5 * (sample[n / 2 - 1] + sample[n / 2]);
+}
+
+double mannWhitneyUTest(const std::vector<double> &a,
+                        const std::vector<double> &b) {
+    if (a.empty() || b.empty()) {
+        throw std::runtime_error("mannWhitneyUTest: empty sample");
+    }
+    // pool the samples, the flag marks the values of b
+    std::vector<std::pair<double, bool>> pooled;
+    for (double value : a) {
+        pooled.push_back(std::make_pair(value, false));
+    }
+    for (double value : b) {
+        pooled.push_back(std::make_pair(value, true));
+    }
+    std::sort(pooled.begin(), pooled.end());
+
+    // rank sum of b with mid-ranks for ties
+    const double n = static_cast<double>(pooled.size());
+    double rankSumB = 0.0;
+    double tieCorrection = 0.0;
+    for (std::size_t i = 0; i < pooled.size();) {
+        std::size_t j = i;
+        while (j < pooled.size() && pooled[j].first == pooled[i].first) {
+            ++j;
+        }
+        const double rank = 0.5 * static_cast<double>(i + j + 1);
+        const double ties = static_cast<double>(j - i);
+        tieCorrection += ties * ties * ties - ties;
+        for (std::size_t k = i; k < j; ++k) {
+            if (pooled[k].second) {
+                rankSumB += rank;
+            }
+        }
+        i = j;
+    }
+
+    const double nA = static_cast<double>(a.size());
+    const double nB = static_cast<double>(b.size());
+    const double u = rankSumB - nB * (nB + 1.0) / 2.0;
+    const double mean = nA * nB / 2.0;
+    const double variance =
+        nA * nB / 12.0 * ((n + 1.0) - tieCorrection / (n * (n - 1.0)));
+    if (!(variance > 0.0)) {
+        return 1.0;
+    }
+    const double z = (u - mean - 0.5) / std::sqrt(variance);
+    return 0.5 * std::erfc(z / std::sqrt(2.0));
+}
+
+double mannWhitneyUTestTwoSided(const std::vector<double> &a,
+                                const std::vector<double> &b) {
+    return std::min(1.0, 2.0 * std::min(mannWhitneyUTest(a, b),
+                                         mannWhitneyUTest(b, a)));
+}
+
+double kolmogorovSmirnovTest(const std::vector<double> &a,
+                             const std::vector<double> &b) {
+    if (a.empty() || b.empty()) {
+        throw std::runtime_error("kolmogorovSmirnovTest: empty sample");
+    }
+    std::vector<double> sortedA = a;
+    std::vector<double> sortedB = b;
+    std::sort(sortedA.begin(), sortedA.end());
+    std::sort(sortedB.begin(), sortedB.end());
+
+    // largest distance of the empirical distribution functions, which
+    // only change at the sample values (equal values are stepped over
+    // together)
+    const double nA = static_cast<double>(a.size());
+    const double nB = static_cast<double>(b.size());
+    std::size_t i = 0;
+    std::size_t j = 0;
+    double distance = 0.0;
+    while (i < sortedA.size() && j < sortedB.size()) {
+        const double value = std::min(sortedA[i], sortedB[j]);
+        while (i < sortedA.size() && sortedA[i] == value) {
+            ++i;
+        }
+        while (j < sortedB.size() && sortedB[j] == value) {
+            ++j;
+        }
+        distance = std::max(distance, std::abs(i / nA - j / nB));
+    }
+
+    const double effectiveSize = std::sqrt(nA * nB / (nA + nB));
+    return kolmogorovQ((effectiveSize + 0.12 + 0.11 / effectiveSize) *
+                       distance);
+}
+
+double chiSquareTest(const std::vector<int> &countsA,
+                     const std::vector<int> &countsB) {
+    if (countsA.size() != countsB.size()) {
+        throw std::runtime_error("chiSquareTest: different categories");
+    }
+    double totalA = 0.0;
+    double totalB = 0.0;
+    for (std::size_t i = 0; i < countsA.size(); ++i) {
+        totalA += countsA[i];
+        totalB += countsB[i];
+    }
+    if (!(totalA > 0.0 && totalB > 0.0)) {
+        throw std::runtime_error("chiSquareTest: empty sample");
+    }
+    double statistic = 0.0;
+    int degreesOfFreedom = -1;
+    for (std::size_t i = 0; i < countsA.size(); ++i) {
+        const double total = countsA[i] + countsB[i];
+        if (total == 0.0) {
+            continue;
+        }
+        const double expectedA = total * totalA / (totalA + totalB);
+        const double expectedB = total * totalB / (totalA + totalB);
+        statistic += (countsA[i] - expectedA) * (countsA[i] - expectedA) /
+            expectedA;
+        statistic += (countsB[i] - expectedB) * (countsB[i] - expectedB) /
+            expectedB;
+        ++degreesOfFreedom;
+    }
+    if (degreesOfFreedom < 1) {
+        return 1.0;
+    }
+    return gammaQ(0.5 * degreesOfFreedom, 0.5 * statistic);
+}
+
+}
+}
@@ -0,0 +1,296 @@
+#include "es/core/WorkerPool.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <new>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include <dirent.h>
+#include <pthread.h>
+#include <sched.h>
+
+namespace es {
+namespace core {
+
+namespace {
+
+const char NODE_DIRECTORY[] = "/sys/devices/system/node";
+
+const std::size_t CACHE_LINE_SIZE = 64;
+
+// Parses a CPU list such as "0-3,8-11".
+std::vector<int> parseCpuList(const std::string &text) {
+    std::vector<int> cpus;
+    std::istringstream is(text);
+    std::string item;
+    while (std::getline(is, item, ',')) {
+        const std::size_t dash = item.find('-');
+        const int first = std::atoi(item.c_str());
+        const int last = dash == std::string::npos ? first :
+            std::atoi(item.c_str() + dash + 1);
+        for (int cpu = first; cpu <= last; ++cpu) {
+            cpus.push_back(cpu);
+        }
+    }
+    return cpus;
+}
+
+}
+
+CpuTopology detectCpuTopology() {
+    std::vector<int> nodeOfCpu(CPU_SETSIZE, 0);
+    if (DIR *directory = opendir(NODE_DIRECTORY)) {
+        while (dirent *entry = readdir(directory)) {
+            int node;
+            char rest;
+            if (std::sscanf(entry->d_name, "node%d%c", &node, &rest) != 1) {
+                continue;
+            }
+            std::ifstream file((std::string(NODE_DIRECTORY) + "/" +
+                                entry->d_name + "/cpulist").c_str());
+            std::string text;
+            std::getline(file, text);
+            for (int cpu : parseCpuList(text)) {
+                if (cpu >= 0 && cpu < CPU_SETSIZE) {
+                    nodeOfCpu[cpu] = node;
+                }
+            }
+        }
+        closedir(directory);
+    }
+
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) {
+        const int numCpus = static_cast<int>(
+            std::max(1u, std::thread::hardware_concurrency()));
+        for (int cpu = 0; cpu < numCpus && cpu < CPU_SETSIZE; ++cpu) {
+            CPU_SET(cpu, &allowed);
+        }
+    }
+    std::vector<std::pair<int, int>> nodeCpus;
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+        if (CPU_ISSET(cpu, &allowed)) {
+            nodeCpus.push_back(std::make_pair(nodeOfCpu[cpu], cpu));
+        }
+    }
+    std::sort(nodeCpus.begin(), nodeCpus.end());
+
+    CpuTopology topology;
+    for (const std::pair<int, int> &nodeCpu : nodeCpus) {
+        topology.nodes.push_back(nodeCpu.first);
+        topology.cpus.push_back(nodeCpu.second);
+    }
+    return topology;
+}
+
+// The state of a worker; it is allocated by the worker thread itself. It
+// is aligned to and padded to whole cache lines, so the ranges of
+// different workers never share a line.
+struct alignas(CACHE_LINE_SIZE) WorkerPool::Worker {
+    // the range [next, end) of the tasks of the current batch that were
+    // not taken yet; next is advanced by the worker and by thieves
+    std::atomic<int> next;
+    int end;
+    int node;
+
+    // the plain operator new of C++14 does not respect the extended
+    // alignment
+    static void *operator new(std::size_t size) {
+        void *memory;
+        if (posix_memalign(&memory, alignof(Worker), size) != 0) {
+            throw std::bad_alloc();
+        }
+        return memory;
+    }
+
+    static void operator delete(void *memory) {
+        std::free(memory);
+    }
+};
+
+WorkerPool::WorkerPool(int numWorkers, bool pinWorkers)
+    : m_pinWorkers(pinWorkers)
+    , m_batch(0)
+    , m_numBusy(0)
+    , m_numInitialized(0)
+    , m_stop(false)
+    , m_numStolenTasks(0) {
+    if (numWorkers < 1) {
+        throw std::runtime_error("a worker pool needs at least one worker");
+    }
+    if (pinWorkers) {
+        m_topology = detectCpuTopology();
+    }
+    try {
+        reserveWorkers(numWorkers);
+    } catch (...) {
+        stop();
+        throw;
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    stop();
+}
+
+void WorkerPool::stop() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_wake.notify_all();
+    for (std::thread &thread : m_threads) {
+        thread.join();
+    }
+    m_threads.clear();
+}
+
+int WorkerPool::getNumWorkers() const {
+    return static_cast<int>(m_workers.size());
+}
+
+void WorkerPool::reserveWorkers(int numWorkers) {
+    const int numWorkersPrev = getNumWorkers();
+    if (numWorkers <= numWorkersPrev) {
+        return;
+    }
+    m_workers.resize(numWorkers);
+    for (int index = numWorkersPrev; index < numWorkers; ++index) {
+        m_threads.emplace_back(&WorkerPool::work, this, index);
+    }
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_done.wait(lock, [this, numWorkers]() {
+        return m_numInitialized == numWorkers;
+    });
+}
+
+void WorkerPool::run(int numTasks, const Task &task) {
+    start(numTasks, task);
+    wait();
+}
+
+void WorkerPool::start(int numTasks, const Task &task) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_task = task;
+    m_errors.assign(numTasks, std::exception_ptr());
+    const int numWorkers = getNumWorkers();
+    for (int index = 0; index < numWorkers; ++index) {
+        Worker &worker = *m_workers[index];
+        worker.next.store(static_cast<int>(
+            static_cast<long>(numTasks) * index / numWorkers),
+            std::memory_order_relaxed);
+        worker.end = static_cast<int>(
+            static_cast<long>(numTasks) * (index + 1) / numWorkers);
+    }
+    ++m_batch;
+    m_numBusy = numWorkers;
+    m_wake.notify_all();
+}
+
+void WorkerPool::wait() {
+    std::vector<std::exception_ptr> errors;
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_done.wait(lock, [this]() { return m_numBusy == 0; });
+        m_task = Task();
+        errors.swap(m_errors);
+    }
+    for (const std::exception_ptr &error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+}
+
+long WorkerPool::getNumStolenTasks() const {
+    return m_numStolenTasks.load();
+}
+
+bool WorkerPool::runTask(Worker &owner, int worker) {
+    const int task = owner.next.fetch_add(1);
+    if (task >= owner.end) {
+        return false;
+    }
+    try {
+        m_task(task, worker);
+    } catch (...) {
+        m_errors[task] = std::current_exception();
+    }
+    return true;
+}
+
+void WorkerPool::work(int index) {
+    int node = 0;
+    if (m_pinWorkers && !m_topology.cpus.empty()) {
+        const std::size_t slot = index % m_topology.cpus.size();
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET(m_topology.cpus[slot], &cpus);
+        // without permission (e.g. a restricted cpuset) the worker is not
+        // pinned, which only affects the performance
+        pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+        node = m_topology.nodes[slot];
+    }
+    // allocated after pinning, so it is placed on the node of the worker
+    std::unique_ptr<Worker> state(new Worker());
+    state->next.store(0);
+    state->end = 0;
+    state->node = node;
+
+    unsigned long batch;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_workers[index] = std::move(state);
+        ++m_numInitialized;
+        batch = m_batch;
+    }
+    m_done.notify_all();
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [this, batch]() {
+                return m_stop || m_batch != batch;
+            });
+            if (m_stop) {
+                return;
+            }
+            batch = m_batch;
+        }
+
+        Worker &own = *m_workers[index];
+        while (runTask(own, index)) {
+        }
+        // steal from the workers of the same node first
+        const int numWorkers = getNumWorkers();
+        for (int pass = 0; pass < 2; ++pass) {
+            for (int offset = 1; offset < numWorkers; ++offset) {
+                Worker &victim = *m_workers[(index + offset) % numWorkers];
+                if ((victim.node == own.node) != (pass == 0)) {
+                    continue;
+                }
+                while (runTask(victim, index)) {
+                    m_numStolenTasks.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+        }
+
+        bool done;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            done = --m_numBusy == 0;
+        }
+        if (done) {
+            m_done.notify_all();
+        }
+    }
+}
+
+}
+}
@@ -1,41 +1,114 @@
 #include "es/core/util.h"
 
 #include <chrono>
+#include <functional>
 #include <random>
+#include <thread>
+#include <cmath>
+#include <stdexcept>
 
 namespace es {
 namespace core {
 
-Eigen::MatrixXd randn(int nRows, int nCols) {
-    unsigned seed = std::chrono::system_clock::now().time_since_epoch().count();
-    std::default_random_engine generator (seed);
+namespace {
+
+std::mt19937 &generator() {
+    // the thread id distinguishes threads started at the same time
+    static thread_local std::mt19937 generator(static_cast<unsigned>(
+        std::chrono::system_clock::now().time_since_epoch().count() ^
+        std::hash<std::thread::id>()(std::this_thread::get_id())));
+    return generator;
+}
 
+// Draws the variates row by row although Eigen stores the matrices column
+// by column: this is the order of the original randn(), so a seed yields
+// the same mutations (and thus the same runs and baselines) as before. The
+// strided writes do not matter for the small mutation matrices.
+template<typename Matrix>
+void fillRandn(Matrix &m) {
     std::normal_distribution<double> distribution (0.0, 1.0);
 
-    Eigen::MatrixXd m(nRows, nCols);
-    for (int row = 0; row < nRows; ++row) {
-        for (int col = 0; col < nCols; ++col) {
-            m(row, col) = distribution(generator);
+    std::mt19937 &engine = generator();
+    for (Eigen::Index row = 0; row < m.rows(); ++row) {
+        for (Eigen::Index col = 0; col < m.cols(); ++col) {
+            m(row, col) = distribution(engine);
         }
     }
+}
+
+}
+
+void seedRandom(unsigned seed) {
+    generator().seed(seed);
+}
+
+Eigen::MatrixXd randn(int nRows, int nCols) {
+    Eigen::MatrixXd m(nRows, nCols);
+    fillRandn(m);
     return m;
 }
 
-Eigen::MatrixXd rand(int nRows, int nCols, double lo, double hi) {
-    unsigned seed = std::chrono::system_clock::now().time_since_epoch().count();
-    std::default_random_engine generator (seed);
+void randn(Eigen::Ref<Eigen::MatrixXd> m) {
+    fillRandn(m);
+}
+
+void randn(Eigen::Ref<Eigen::MatrixXf> m) {
+    fillRandn(m);
+}
 
+Eigen::MatrixXd rand(int nRows, int nCols, double lo, double hi) {
     std::uniform_real_distribution<double> distribution (lo, hi);
 
+    std::mt19937 &engine = generator();
     Eigen::MatrixXd m(nRows, nCols);
     for (int row = 0; row < nRows; ++row) {
         for (int col = 0; col < nCols; ++col) {
-            m(row, col) = distribution(generator);
+            m(row, col) = distribution(engine);
         }
     }
     return m;
 }
 
-}
+double normInv(double p) {
+    if (!(p > 0.0 && p < 1.0)) {
+        throw std::runtime_error("normInv: argument must be in (0, 1)");
+    }
+    static const double a[] = {-3.969683028665376e+01,  2.209460984245205e+02,
+                               -2.759285104469687e+02,  1.383577518672690e+02,
+                               -3.066479806614716e+01,  2.506628277459239e+00};
+    static const double b[] = {-5.447609879822406e+01,  1.615858368580409e+02,
+                               -1.556989798598866e+02,  6.680131188771972e+01,
+                               -1.328068155288572e+01};
+    static const double c[] = {-7.784894002430293e-03, -3.223964580411365e-01,
+                               -2.400758277161838e+00, -2.549732539343734e+00,
+                                4.374664141464968e+00,  2.938163982698783e+00};
+    static const double d[] = { 7.784695709041462e-03,  3.224671290700398e-01,
+                                2.445134137142996e+00,  3.754408661907416e+00};
+    const double pLow = 0.02425;
+    double x = 0.0;
+    if (p < pLow) {
+        const double q = std::sqrt(-2.0 * std::log(p));
+        x = (((((c[0] * q + c[1]) * q + c[2]) * q + c[3]) * q + c[4]) * q +
+             c[5]) /
+            ((((d[0] * q + d[1]) * q + d[2]) * q + d[3]) * q + 1.0);
+    } else if (p <= 1.0 - pLow) {
+        const double q = p - 0.5;
+        const double r = q * q;
+        x = (((((a[0] * r + a[1]) * r + a[2]) * r + a[3]) * r + a[4]) * r +
+             a[5]) * q /
+            (((((b[0] * r + b[1]) * r + b[2]) * r + b[3]) * r + b[4]) * r +
+             1.0);
+    } else {
+        const double q = std::sqrt(-2.0 * std::log(1.0 - p));
+        x = -(((((c[0] * q + c[1]) * q + c[2]) * q + c[3]) * q + c[4]) * q +
+              c[5]) /
+            ((((d[0] * q + d[1]) * q + d[2]) * q + d[3]) * q + 1.0);
+    }
+    // one Halley step brings the relative error to machine precision
+    const double e = 0.5 * std::erfc(-x / std::sqrt(2.0)) - p;
+    const double u = e * std::sqrt(2.0 * M_PI) * std::exp(x * x / 2.0);
+    return x - u / (1.0 + x * u / 2.0);
 }
 
+}
+}
@@ -0,0 +1,78 @@
+#!/usr/bin/env python3
+"""Compares per-point and batch callbacks on a synthetic problem.
+
+The problem is a shifted ellipsoid with linear constraints whose NumPy
+evaluation is vectorized over the rows of the candidate matrix. Both modes
+run with the same seed and must find the same solution with the same number
+of evaluations; only the time spent in the interpreter differs.
+
+    python3 <build>/python/benchmark.py [--dimension N]
+"""
+
+import argparse
+import time
+
+import numpy as np
+
+import rayes
+
+
+def make_problem(dimension, num_constraints, seed):
+    rng = np.random.default_rng(seed)
+    scales = 10.0 ** (3.0 * np.arange(dimension) / max(1, dimension - 1))
+    shift = rng.uniform(-1.0, 1.0, dimension)
+    normals = rng.normal(size=(num_constraints, dimension))
+    offsets = rng.uniform(0.5, 1.0, num_constraints)
+
+    def objective(x):
+        # x is a single point (n,) or a matrix of points (k, n)
+        return ((x - shift) ** 2 * scales).sum(axis=-1)
+
+    def constraint(x):
+        return x @ normals.T - offsets
+
+    return objective, constraint
+
+
+def run(dimension, line_search, batch, seed):
+    objective, constraint = make_problem(dimension, dimension // 2, seed)
+    solver = rayes.RayEs(objective, constraint,
+                         -5.0 * np.ones(dimension), 5.0 * np.ones(dimension),
+                         np.zeros(dimension), line_search=line_search,
+                         parameters={"seed": seed}, batch=batch)
+    start = time.perf_counter()
+    info = solver.run()
+    return info, time.perf_counter() - start
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--dimension", type=int, default=10)
+    parser.add_argument("--seed", type=int, default=1)
+    args = parser.parse_args()
+
+    print("{:<10} {:>7} {:>12} {:>10} {:>10} {:>9} {:>8}".format(
+        "LINE", "BATCH", "BEST F", "EVALS", "CALLS", "TIME/S", "SPEEDUP"))
+    for line_search in rayes.LINE_SEARCHES:
+        times = {}
+        results = {}
+        for batch in (False, True):
+            info, seconds = run(args.dimension, line_search, batch,
+                                args.seed)
+            times[batch] = seconds
+            results[batch] = info
+            print("{:<10} {:>7} {:>12.5e} {:>10} {:>10} {:>9.2f} {:>8}"
+                  .format(line_search, str(batch), info.best_f,
+                          info.num_fitness_evaluations,
+                          info.num_callback_batches, seconds,
+                          "{:.1f}x".format(times[False] / seconds)
+                          if batch else ""))
+        if not (np.array_equal(results[False].best_x, results[True].best_x)
+                and results[False].num_fitness_evaluations ==
+                results[True].num_fitness_evaluations):
+            raise SystemExit("batch and per-point runs differ for " +
+                             line_search)
+
+
+if __name__ == "__main__":
+    main()
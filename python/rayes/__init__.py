@@ -0,0 +1,112 @@
+"""Python interface of Ray-ES, an evolution strategy that evolves rays.
+
+The objective and the constraints are either per-point functions (called
+with a vector of length n) or, with ``batch=True``, batch functions called
+with a read-only ``(k, n)`` NumPy array holding one candidate point per row:
+
+    >>> import numpy as np, rayes
+    >>> solver = rayes.RayEs(
+    ...     lambda X: ((X - 0.3) ** 2).sum(axis=1),
+    ...     lambda X: np.stack([X.sum(axis=1) - 1.0], axis=1),
+    ...     -5 * np.ones(4), 5 * np.ones(4), np.zeros(4),
+    ...     parameters={"seed": 1}, batch=True)
+    >>> info = solver.run()
+
+A batch objective returns ``k`` values, a batch constraint a ``(k, m)``
+array; a point is feasible if all its constraint values are <= 0. The
+arrays passed to the callbacks are views of the solver's memory and are
+only valid during the call: copy them to keep them, a callback that keeps
+them fails the run with a RuntimeError. The solver releases
+the GIL while it runs; it is reacquired for the callbacks.
+"""
+
+import numpy as np
+
+from . import _rayes
+
+__all__ = ["Info", "RayEs"]
+
+LINE_SEARCHES = ("Standard", "Modified", "Adaptive")
+
+
+class Info:
+    """Result of a run; vectors and histories are NumPy arrays."""
+
+    def __init__(self, values):
+        self.termination_criterion = values["termination_criterion"]
+        self.num_fitness_evaluations = values["num_fitness_evaluations"]
+        self.num_generations = values["num_generations"]
+        self.best_x = np.asarray(values["best_x"], dtype=np.float64)
+        self.best_f = values["best_f"]
+        self.num_polish_fitness_evaluations = \
+            values["num_polish_fitness_evaluations"]
+        self.polished_x = np.asarray(values["polished_x"], dtype=np.float64)
+        self.polished_f = values["polished_f"]
+        self.lambda_history = np.asarray(values["lambda_history"],
+                                         dtype=np.int64)
+        #: per line search: num_selections, num_fitness_evaluations and
+        #: improvement
+        self.line_search_statistics = values["line_search_statistics"]
+        #: number of calls of the objective and the constraint function
+        self.num_callback_batches = values["num_callback_batches"]
+
+    def __repr__(self):
+        return ("Info(termination_criterion={!r}, best_f={!r}, "
+                "num_fitness_evaluations={!r})".format(
+                    self.termination_criterion, self.best_f,
+                    self.num_fitness_evaluations))
+
+
+def _format_parameter(value):
+    if isinstance(value, (bool, np.bool_)):
+        return "true" if value else "false"
+    return str(value)
+
+
+class RayEs:
+    """Solver for min f(x) s.t. c(x) <= 0 and lbnds <= x <= ubnds.
+
+    ``line_search`` is one of "Standard", "Modified" and "Adaptive";
+    ``parameters`` maps names of the parameter file format (see the
+    README, e.g. ``{"seed": 1, "localPolish": True}``) to values.
+    ``constraint`` may be None for problems with box constraints only.
+    """
+
+    def __init__(self, objective, constraint, lbnds, ubnds, ray_origin,
+                 line_search="Modified", parameters=None, batch=False):
+        if line_search not in LINE_SEARCHES:
+            raise ValueError("line_search must be one of " +
+                             ", ".join(LINE_SEARCHES))
+        self.objective = objective
+        self.constraint = constraint
+        self.lbnds = np.ascontiguousarray(lbnds, dtype=np.float64)
+        self.ubnds = np.ascontiguousarray(ubnds, dtype=np.float64)
+        self.ray_origin = np.ascontiguousarray(ray_origin, dtype=np.float64)
+        self.line_search = line_search
+        self.parameters = dict(parameters or {})
+        self.batch = batch
+
+    def run(self):
+        """Runs the solver and returns its Info."""
+        objective = self.objective
+        constraint = self.constraint
+
+        def objective_wrapper(x):
+            if not self.batch:
+                return objective(np.asarray(x))
+            return np.ascontiguousarray(objective(np.asarray(x)),
+                                        dtype=np.float64)
+
+        def constraint_wrapper(x):
+            return np.ascontiguousarray(constraint(np.asarray(x)),
+                                        dtype=np.float64)
+
+        parameters_text = "".join(
+            "{} = {}\n".format(name, _format_parameter(value))
+            for name, value in self.parameters.items())
+        values = _rayes.run(objective_wrapper,
+                            None if constraint is None else
+                            constraint_wrapper,
+                            self.lbnds, self.ubnds, self.ray_origin,
+                            self.line_search, parameters_text, self.batch)
+        return Info(values)
@@ -0,0 +1,581 @@
+// The extension module _rayes behind the Python package rayes (see
+// rayes/__init__.py). It only depends on the CPython API: the candidate
+// points are passed to the callbacks as read-only buffers of the solver's
+// memory, and float64 C-contiguous results (NumPy arrays) are read through
+// the buffer protocol.
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include "es/rayes/RayEs.h"
+#include "es/rayes/Individual.h"
+#include "es/core/util.h"
+
+#include <cstring>
+#include <exception>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <Eigen/Dense>
+
+namespace {
+
+// Thrown by the callback wrappers when a Python callback raised; the
+// Python exception is kept in Callbacks and restored after the run.
+class PythonError : public std::exception {
+};
+
+// The callbacks of a run and the first Python exception raised by them.
+// All members are only accessed with the GIL held.
+struct Callbacks {
+    Callbacks()
+        : objective(nullptr)
+        , constraint(nullptr)
+        , numCallbackBatches(0)
+        , errorType(nullptr)
+        , errorValue(nullptr)
+        , errorTraceback(nullptr) {
+    }
+
+    ~Callbacks() {
+        Py_XDECREF(errorType);
+        Py_XDECREF(errorValue);
+        Py_XDECREF(errorTraceback);
+    }
+
+    // Moves the current Python exception into the members and throws.
+    [[noreturn]] void fail() {
+        if (errorType == nullptr) {
+            PyErr_Fetch(&errorType, &errorValue, &errorTraceback);
+        } else {
+            PyErr_Clear();
+        }
+        throw PythonError();
+    }
+
+    PyObject *objective;
+    // Py_None if there are no constraints
+    PyObject *constraint;
+    long numCallbackBatches;
+    PyObject *errorType;
+    PyObject *errorValue;
+    PyObject *errorTraceback;
+};
+
+// Acquires the GIL for the callbacks (run() releases it).
+class GilLock {
+ public:
+    GilLock()
+        : m_state(PyGILState_Ensure()) {
+    }
+
+    ~GilLock() {
+        PyGILState_Release(m_state);
+    }
+
+    GilLock(const GilLock &) = delete;
+    GilLock &operator=(const GilLock &) = delete;
+
+ private:
+    PyGILState_STATE m_state;
+};
+
+// The candidate points passed to a callback. They export the memory of the
+// solver through the buffer protocol during the call only and count the
+// exports, so a callback that keeps an array of them (which would point to
+// memory the solver reuses) is detected: NumPy arrays and memoryviews of
+// the points hold an export until they are released.
+struct CandidatePoints {
+    PyObject_HEAD
+    // nullptr after the call
+    const double *data;
+    int ndim;
+    Py_ssize_t shape[2];
+    Py_ssize_t strides[2];
+    Py_ssize_t numExports;
+};
+
+int getCandidateBuffer(PyObject *obj, Py_buffer *buffer, int flags) {
+    CandidatePoints *points = reinterpret_cast<CandidatePoints *>(obj);
+    buffer->obj = nullptr;
+    if (points->data == nullptr) {
+        PyErr_SetString(PyExc_BufferError,
+                        "the candidate points are only valid during the "
+                        "call of the callback");
+        return -1;
+    }
+    if (flags & PyBUF_WRITABLE) {
+        PyErr_SetString(PyExc_BufferError,
+                        "the candidate points are read-only");
+        return -1;
+    }
+    const int first = points->ndim == 2 ? 0 : 1;
+    buffer->buf = const_cast<double *>(points->data);
+    buffer->len = points->shape[0] * points->shape[1] * sizeof(double);
+    buffer->readonly = 1;
+    buffer->itemsize = sizeof(double);
+    buffer->format = (flags & PyBUF_FORMAT) ? const_cast<char *>("d") :
+        nullptr;
+    buffer->ndim = points->ndim;
+    buffer->shape = (flags & PyBUF_ND) ? points->shape + first : nullptr;
+    buffer->strides = (flags & PyBUF_STRIDES) == PyBUF_STRIDES ?
+        points->strides + first : nullptr;
+    buffer->suboffsets = nullptr;
+    buffer->internal = nullptr;
+    buffer->obj = obj;
+    Py_INCREF(obj);
+    ++points->numExports;
+    return 0;
+}
+
+void releaseCandidateBuffer(PyObject *obj, Py_buffer *) {
+    --reinterpret_cast<CandidatePoints *>(obj)->numExports;
+}
+
+PyBufferProcs CANDIDATE_BUFFER_PROCS = {
+    getCandidateBuffer, releaseCandidateBuffer
+};
+
+// completed by PyInit__rayes
+PyTypeObject CANDIDATE_POINTS_TYPE = {};
+
+// Calls fun with a read-only view of numPoints points of the given
+// dimension stored one after another at data; the view is a matrix with
+// one point per row, or a vector for a single point (batch false). The
+// view is invalidated after the call, so the callback must not keep it.
+PyObject *callWithView(Callbacks &callbacks, PyObject *fun,
+                       const double *data, Py_ssize_t numPoints,
+                       Py_ssize_t dimension, bool batch) {
+    CandidatePoints *points =
+        PyObject_New(CandidatePoints, &CANDIDATE_POINTS_TYPE);
+    if (points == nullptr) {
+        callbacks.fail();
+    }
+    points->data = data;
+    points->ndim = batch ? 2 : 1;
+    points->shape[0] = numPoints;
+    points->shape[1] = dimension;
+    points->strides[0] = dimension * sizeof(double);
+    points->strides[1] = sizeof(double);
+    points->numExports = 0;
+    PyObject *view = reinterpret_cast<PyObject *>(points);
+    ++callbacks.numCallbackBatches;
+    PyObject *result = PyObject_CallFunctionObjArgs(fun, view, nullptr);
+    points->data = nullptr;
+    const bool kept = points->numExports > 0;
+    Py_DECREF(view);
+    if (result == nullptr) {
+        callbacks.fail();
+    }
+    if (kept) {
+        Py_DECREF(result);
+        PyErr_SetString(PyExc_RuntimeError,
+                        "a callback kept a reference to the candidate "
+                        "points; copy them to keep them");
+        callbacks.fail();
+    }
+    return result;
+}
+
+bool isFloat64(const Py_buffer &buffer) {
+    const char *format = buffer.format != nullptr ? buffer.format : "B";
+    if (format[0] == '@' || format[0] == '=') {
+        ++format;
+    }
+    return std::strcmp(format, "d") == 0;
+}
+
+// Appends the numbers of obj (a number, a sequence of numbers or, for
+// depth 2, a sequence of such sequences) to values and records the shape.
+bool readSequence(PyObject *obj, int depth, std::vector<double> &values,
+                  std::vector<Py_ssize_t> &shape) {
+    if (depth == 0 || !PySequence_Check(obj)) {
+        const double value = PyFloat_AsDouble(obj);
+        if (value == -1.0 && PyErr_Occurred()) {
+            return false;
+        }
+        values.push_back(value);
+        return true;
+    }
+    PyObject *sequence = PySequence_Fast(obj, "expected a sequence");
+    if (sequence == nullptr) {
+        return false;
+    }
+    const Py_ssize_t size = PySequence_Fast_GET_SIZE(sequence);
+    shape.push_back(size);
+    std::vector<Py_ssize_t> itemShape;
+    for (Py_ssize_t i = 0; i < size; ++i) {
+        std::vector<Py_ssize_t> currShape;
+        if (!readSequence(PySequence_Fast_GET_ITEM(sequence, i), depth - 1,
+                          values, currShape)) {
+            Py_DECREF(sequence);
+            return false;
+        }
+        if (i > 0 && currShape != itemShape) {
+            Py_DECREF(sequence);
+            PyErr_SetString(PyExc_ValueError, "ragged nested sequence");
+            return false;
+        }
+        itemShape = currShape;
+    }
+    Py_DECREF(sequence);
+    shape.insert(shape.end(), itemShape.begin(), itemShape.end());
+    return true;
+}
+
+// Reads the values of an array-like with up to maxDims dimensions in C
+// order. float64 C-contiguous buffers (NumPy arrays) are copied at once.
+void readArray(Callbacks &callbacks, PyObject *obj, int maxDims,
+               std::vector<double> &values, std::vector<Py_ssize_t> &shape) {
+    values.clear();
+    shape.clear();
+    Py_buffer buffer;
+    if (PyObject_CheckBuffer(obj) &&
+        PyObject_GetBuffer(obj, &buffer,
+                           PyBUF_C_CONTIGUOUS | PyBUF_FORMAT) == 0) {
+        const bool valid = isFloat64(buffer) && buffer.ndim <= maxDims;
+        if (valid) {
+            shape.assign(buffer.shape, buffer.shape + buffer.ndim);
+            const double *data = static_cast<const double *>(buffer.buf);
+            values.assign(data, data + buffer.len / sizeof(double));
+        }
+        PyBuffer_Release(&buffer);
+        if (valid) {
+            return;
+        }
+    }
+    PyErr_Clear();
+    if (!readSequence(obj, maxDims, values, shape)) {
+        callbacks.fail();
+    }
+}
+
+PyObject *toList(const Eigen::VectorXd &x) {
+    PyObject *list = PyList_New(x.size());
+    if (list == nullptr) {
+        return nullptr;
+    }
+    for (Eigen::Index i = 0; i < x.size(); ++i) {
+        PyList_SET_ITEM(list, i, PyFloat_FromDouble(x(i)));
+    }
+    return list;
+}
+
+template<typename T>
+std::string toText(const T &value) {
+    std::ostringstream os;
+    os << value;
+    return os.str();
+}
+
+// Sets key of dict to value and drops the reference to value.
+bool setItem(PyObject *dict, const char *key, PyObject *value) {
+    if (value == nullptr) {
+        return false;
+    }
+    const int status = PyDict_SetItemString(dict, key, value);
+    Py_DECREF(value);
+    return status == 0;
+}
+
+PyObject *toDict(const es::rayes::Info &info, long numCallbackBatches) {
+    PyObject *dict = PyDict_New();
+    if (dict == nullptr) {
+        return nullptr;
+    }
+    const es::rayes::Individual best = info.getBestIndividual();
+    const es::rayes::Individual polished = info.getPolishedIndividual();
+    PyObject *lambdaHistory = PyList_New(0);
+    for (int lambda : info.getLambdaHistory()) {
+        PyObject *item = PyLong_FromLong(lambda);
+        if (lambdaHistory == nullptr || item == nullptr ||
+            PyList_Append(lambdaHistory, item) != 0) {
+            Py_XDECREF(item);
+            Py_XDECREF(lambdaHistory);
+            Py_DECREF(dict);
+            return nullptr;
+        }
+        Py_DECREF(item);
+    }
+    PyObject *statistics = PyDict_New();
+    if (statistics != nullptr) {
+        for (const auto &entry : info.getLineSearchStatistics()) {
+            PyObject *value = Py_BuildValue(
+                "{s:i,s:i,s:i,s:d}",
+                "num_selections", entry.second.numSelections,
+                "num_fitness_evaluations",
+                entry.second.numFitnessEvaluations,
+                "num_saved_fitness_evaluations",
+                entry.second.numSavedFitnessEvaluations,
+                "improvement", entry.second.improvement);
+            if (!setItem(statistics, toText(entry.first).c_str(), value)) {
+                Py_CLEAR(statistics);
+                break;
+            }
+        }
+    }
+    const bool ok =
+        setItem(dict, "termination_criterion", PyUnicode_FromString(
+                    toText(info.getTerminationCriterion()).c_str())) &&
+        setItem(dict, "num_fitness_evaluations",
+                PyLong_FromLong(info.getNumFitnessEvaluations())) &&
+        setItem(dict, "num_generations",
+                PyLong_FromLong(info.getNumGenerations())) &&
+        setItem(dict, "best_x", toList(best.bestOnRay())) &&
+        setItem(dict, "best_f", PyFloat_FromDouble(best.f())) &&
+        setItem(dict, "num_polish_fitness_evaluations",
+                PyLong_FromLong(info.getNumPolishFitnessEvaluations())) &&
+        setItem(dict, "polished_x", toList(polished.bestOnRay())) &&
+        setItem(dict, "polished_f", PyFloat_FromDouble(polished.f())) &&
+        setItem(dict, "lambda_history", lambdaHistory) &&
+        setItem(dict, "line_search_statistics", statistics) &&
+        setItem(dict, "num_callback_batches",
+                PyLong_FromLong(numCallbackBatches));
+    if (!ok) {
+        Py_DECREF(dict);
+        return nullptr;
+    }
+    return dict;
+}
+
+bool toVector(PyObject *obj, const char *name, Eigen::VectorXd &x) {
+    std::vector<double> values;
+    std::vector<Py_ssize_t> shape;
+    Callbacks callbacks;
+    try {
+        readArray(callbacks, obj, 1, values, shape);
+    } catch (const PythonError &) {
+        PyErr_Restore(callbacks.errorType, callbacks.errorValue,
+                      callbacks.errorTraceback);
+        callbacks.errorType = nullptr;
+        callbacks.errorValue = nullptr;
+        callbacks.errorTraceback = nullptr;
+        return false;
+    }
+    if (shape.size() != 1) {
+        PyErr_Format(PyExc_ValueError, "%s must be a vector", name);
+        return false;
+    }
+    x = Eigen::Map<const Eigen::VectorXd>(values.data(), values.size());
+    return true;
+}
+
+const char RUN_DOC[] =
+    "run(objective, constraint, lbnds, ubnds, ray_origin, line_search, "
+    "parameters, batch)\n\n"
+    "Runs RayEs and returns its Info as a dict. Use rayes.RayEs instead.";
+
+PyObject *run(PyObject *, PyObject *args) {
+    PyObject *objective;
+    PyObject *constraint;
+    PyObject *lbndsObj;
+    PyObject *ubndsObj;
+    PyObject *rayOriginObj;
+    const char *lineSearch;
+    const char *parametersText;
+    int batch;
+    if (!PyArg_ParseTuple(args, "OOOOOssp", &objective, &constraint,
+                          &lbndsObj, &ubndsObj, &rayOriginObj, &lineSearch,
+                          &parametersText, &batch)) {
+        return nullptr;
+    }
+    if (!PyCallable_Check(objective) ||
+        (constraint != Py_None && !PyCallable_Check(constraint))) {
+        PyErr_SetString(PyExc_TypeError,
+                        "objective and constraint must be callable");
+        return nullptr;
+    }
+    Eigen::VectorXd lbnds;
+    Eigen::VectorXd ubnds;
+    Eigen::VectorXd rayOrigin;
+    if (!toVector(lbndsObj, "lbnds", lbnds) ||
+        !toVector(ubndsObj, "ubnds", ubnds) ||
+        !toVector(rayOriginObj, "ray_origin", rayOrigin)) {
+        return nullptr;
+    }
+    if (lbnds.size() == 0 || ubnds.size() != lbnds.size() ||
+        rayOrigin.size() != lbnds.size()) {
+        PyErr_SetString(PyExc_ValueError,
+                        "lbnds, ubnds and ray_origin must have the same "
+                        "nonzero size");
+        return nullptr;
+    }
+
+    es::rayes::LineSearchAlg lineSearchAlg;
+    const std::string lineSearchName = lineSearch;
+    if (lineSearchName == "Standard") {
+        lineSearchAlg = es::rayes::LineSearchAlg::Standard;
+    } else if (lineSearchName == "Modified") {
+        lineSearchAlg = es::rayes::LineSearchAlg::Modified;
+    } else if (lineSearchName == "Adaptive") {
+        lineSearchAlg = es::rayes::LineSearchAlg::Adaptive;
+    } else {
+        PyErr_Format(PyExc_ValueError, "unknown line search '%s'",
+                     lineSearch);
+        return nullptr;
+    }
+    es::rayes::Parameters parameters;
+    try {
+        std::istringstream is(parametersText);
+        es::rayes::readParameters(is, parameters);
+    } catch (const std::exception &e) {
+        PyErr_SetString(PyExc_ValueError, e.what());
+        return nullptr;
+    }
+
+    Callbacks callbacks;
+    callbacks.objective = objective;
+    callbacks.constraint = constraint;
+    const Py_ssize_t dimension = lbnds.size();
+
+    // the callbacks are only called from this thread (also in batch mode)
+    auto batchObjective = [&](const Eigen::MatrixXd &x) {
+        GilLock lock;
+        PyObject *result = callWithView(callbacks, callbacks.objective,
+                                        x.data(), x.cols(), dimension, true);
+        std::vector<double> values;
+        std::vector<Py_ssize_t> shape;
+        try {
+            readArray(callbacks, result, 1, values, shape);
+        } catch (const PythonError &) {
+            Py_DECREF(result);
+            throw;
+        }
+        Py_DECREF(result);
+        if (static_cast<Eigen::Index>(values.size()) != x.cols()) {
+            PyErr_Format(PyExc_ValueError,
+                         "the objective returned %zd values for %zd points",
+                         static_cast<Py_ssize_t>(values.size()),
+                         static_cast<Py_ssize_t>(x.cols()));
+            callbacks.fail();
+        }
+        return Eigen::VectorXd(
+            Eigen::Map<const Eigen::VectorXd>(values.data(), x.cols()));
+    };
+    auto batchConstraint = [&](const Eigen::MatrixXd &x) {
+        if (callbacks.constraint == Py_None) {
+            return Eigen::MatrixXd(0, x.cols());
+        }
+        GilLock lock;
+        PyObject *result = callWithView(callbacks, callbacks.constraint,
+                                        x.data(), x.cols(), dimension, true);
+        std::vector<double> values;
+        std::vector<Py_ssize_t> shape;
+        try {
+            readArray(callbacks, result, 2, values, shape);
+        } catch (const PythonError &) {
+            Py_DECREF(result);
+            throw;
+        }
+        Py_DECREF(result);
+        if (shape.size() != 2 || shape[0] != x.cols()) {
+            PyErr_Format(PyExc_ValueError,
+                         "the constraint must return an array of shape "
+                         "(%zd, m)", static_cast<Py_ssize_t>(x.cols()));
+            callbacks.fail();
+        }
+        // the rows of the result are the columns of the Eigen matrix
+        return Eigen::MatrixXd(Eigen::Map<const Eigen::MatrixXd>(
+            values.data(), shape[1], shape[0]));
+    };
+    auto objectiveFun = [&](const Eigen::VectorXd &x) {
+        GilLock lock;
+        PyObject *result = callWithView(callbacks, callbacks.objective,
+                                        x.data(), 1, dimension, false);
+        const double f = PyFloat_AsDouble(result);
+        Py_DECREF(result);
+        if (f == -1.0 && PyErr_Occurred()) {
+            callbacks.fail();
+        }
+        return f;
+    };
+    auto constraintFun = [&](const Eigen::VectorXd &x) {
+        if (callbacks.constraint == Py_None) {
+            return Eigen::VectorXd(0);
+        }
+        GilLock lock;
+        PyObject *result = callWithView(callbacks, callbacks.constraint,
+                                        x.data(), 1, dimension, false);
+        std::vector<double> values;
+        std::vector<Py_ssize_t> shape;
+        try {
+            readArray(callbacks, result, 1, values, shape);
+        } catch (const PythonError &) {
+            Py_DECREF(result);
+            throw;
+        }
+        Py_DECREF(result);
+        return Eigen::VectorXd(
+            Eigen::Map<const Eigen::VectorXd>(values.data(), values.size()));
+    };
+
+    es::rayes::Info info;
+    std::string error;
+    bool pythonError = false;
+    Py_BEGIN_ALLOW_THREADS
+    try {
+        if (batch) {
+            info = es::rayes::RayEs(es::rayes::BatchObjectiveFun(
+                                        batchObjective),
+                                    es::rayes::BatchConstraintFun(
+                                        batchConstraint),
+                                    lbnds, ubnds, rayOrigin, lineSearchAlg,
+                                    parameters).run();
+        } else {
+            info = es::rayes::RayEs(objectiveFun, constraintFun, lbnds,
+                                    ubnds, rayOrigin, lineSearchAlg,
+                                    parameters).run();
+        }
+    } catch (const PythonError &) {
+        pythonError = true;
+    } catch (const std::exception &e) {
+        error = e.what();
+        if (error.empty()) {
+            error = "RayEs failed";
+        }
+    }
+    Py_END_ALLOW_THREADS
+
+    if (pythonError) {
+        PyErr_Restore(callbacks.errorType, callbacks.errorValue,
+                      callbacks.errorTraceback);
+        callbacks.errorType = nullptr;
+        callbacks.errorValue = nullptr;
+        callbacks.errorTraceback = nullptr;
+        return nullptr;
+    }
+    if (!error.empty()) {
+        PyErr_SetString(PyExc_RuntimeError, error.c_str());
+        return nullptr;
+    }
+    return toDict(info, callbacks.numCallbackBatches);
+}
+
+PyMethodDef METHODS[] = {
+    {"run", run, METH_VARARGS, RUN_DOC},
+    {nullptr, nullptr, 0, nullptr}
+};
+
+PyModuleDef MODULE = {
+    PyModuleDef_HEAD_INIT, "_rayes",
+    "Bindings of the ray-based evolution strategy (see rayes).", -1,
+    METHODS, nullptr, nullptr, nullptr, nullptr
+};
+
+}
+
+PyMODINIT_FUNC PyInit__rayes() {
+    PyTypeObject &type = CANDIDATE_POINTS_TYPE;
+    const PyVarObject head = {PyObject_HEAD_INIT(nullptr) 0};
+    type.ob_base = head;
+    type.tp_name = "_rayes.CandidatePoints";
+    type.tp_basicsize = sizeof(CandidatePoints);
+    type.tp_flags = Py_TPFLAGS_DEFAULT;
+    type.tp_doc = "Read-only candidate points, valid during the call.";
+    type.tp_as_buffer = &CANDIDATE_BUFFER_PROCS;
+    if (PyType_Ready(&type) != 0) {
+        return nullptr;
+    }
+    return PyModule_Create(&MODULE);
+}
@@ -0,0 +1,133 @@
+#!/usr/bin/env python3
+"""Offline tests of the Python package rayes.
+
+They run small problems only and need neither a network nor data files:
+
+    python3 <build>/python/test_rayes.py
+"""
+
+import sys
+import unittest
+
+try:
+    import numpy as np
+except ImportError:
+    # ctest reports the exit status 77 as skipped
+    print("SKIP: NumPy is not installed")
+    sys.exit(77)
+
+import rayes
+
+DIMENSION = 3
+
+
+def make_solver(objective, constraint, batch, line_search="Modified"):
+    return rayes.RayEs(objective, constraint,
+                       -5.0 * np.ones(DIMENSION), 5.0 * np.ones(DIMENSION),
+                       np.zeros(DIMENSION), line_search=line_search,
+                       parameters={"seed": 1}, batch=batch)
+
+
+def objective(x):
+    # x is a single point (n,) or a matrix of points (k, n)
+    return ((x - 1.0) ** 2).sum(axis=-1)
+
+
+def constraint(x):
+    # sum(x) <= 1 as (m,) or (k, m) values
+    return x.sum(axis=-1, keepdims=True) - 1.0
+
+
+class CallbackError(Exception):
+    pass
+
+
+class BatchTest(unittest.TestCase):
+
+    def test_batch_equals_per_point(self):
+        for line_search in rayes.LINE_SEARCHES:
+            with self.subTest(line_search=line_search):
+                single = make_solver(objective, constraint, False,
+                                     line_search).run()
+                batch = make_solver(objective, constraint, True,
+                                    line_search).run()
+                np.testing.assert_array_equal(single.best_x, batch.best_x)
+                self.assertEqual(single.best_f, batch.best_f)
+                self.assertEqual(single.num_fitness_evaluations,
+                                 batch.num_fitness_evaluations)
+                self.assertLess(batch.num_callback_batches,
+                                single.num_callback_batches)
+
+    def test_without_constraint(self):
+        info = make_solver(objective, None, True).run()
+        self.assertLess(info.best_f, 1e-6)
+
+
+class CallbackErrorTest(unittest.TestCase):
+
+    def test_kept_view(self):
+        kept = []
+
+        def keeping(x):
+            kept.append(x)
+            return objective(x)
+
+        for batch in (False, True):
+            with self.subTest(batch=batch):
+                with self.assertRaisesRegex(RuntimeError,
+                                            "kept a reference"):
+                    make_solver(keeping, constraint, batch).run()
+
+    def test_copied_view(self):
+        kept = []
+
+        def copying(x):
+            kept.append(np.array(x))
+            return objective(x)
+
+        make_solver(copying, constraint, True).run()
+        self.assertTrue(kept)
+
+    def test_exception_reaches_caller(self):
+        def failing(x):
+            raise CallbackError("from the callback")
+
+        for batch in (False, True):
+            with self.subTest(batch=batch, function="objective"):
+                with self.assertRaisesRegex(CallbackError,
+                                            "from the callback"):
+                    make_solver(failing, constraint, batch).run()
+            with self.subTest(batch=batch, function="constraint"):
+                with self.assertRaises(CallbackError):
+                    make_solver(objective, failing, batch).run()
+
+    def test_wrong_objective_shape(self):
+        def too_many(x):
+            return np.zeros(x.shape[0] + 1)
+
+        with self.assertRaisesRegex(ValueError, "objective returned"):
+            make_solver(too_many, constraint, True).run()
+
+    def test_wrong_constraint_shape(self):
+        def transposed(x):
+            return constraint(x).T
+
+        with self.assertRaisesRegex(ValueError, "constraint must return"):
+            make_solver(objective, transposed, True).run()
+
+
+class InfoTest(unittest.TestCase):
+
+    def test_numpy_fields(self):
+        info = make_solver(objective, constraint, True).run()
+        for name in ("best_x", "polished_x", "lambda_history"):
+            with self.subTest(field=name):
+                self.assertIsInstance(getattr(info, name), np.ndarray)
+        self.assertEqual(info.best_x.shape, (DIMENSION,))
+        self.assertEqual(info.best_x.dtype, np.float64)
+        self.assertEqual(info.lambda_history.dtype, np.int64)
+        self.assertLessEqual(info.best_x.sum(), 1.0 + 1e-12)
+
+
+if __name__ == "__main__":
+    unittest.main()
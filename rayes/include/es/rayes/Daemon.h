@@ -0,0 +1,158 @@
+/*! \file
+ *  \brief A solver daemon that serves solve requests over a Unix domain
+ *  socket, and its client.
+ */
+
+#ifndef ES_RAYES_DAEMON_H
+#define ES_RAYES_DAEMON_H
+
+#include "es/rayes/Info.h"
+#include "es/rayes/Parameters.h"
+#include "es/rayes/RayEs.h"
+#include "es/rayes/Status.h"
+
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
+#include <string>
+
+#include <Eigen/Dense>
+
+namespace es {
+namespace core {
+class WorkerPool;
+}
+
+namespace rayes {
+
+// frames the messages of the protocol (defined in Daemon.cpp)
+class MessageChannel;
+
+/*! \brief A problem to be solved by a SolverDaemon. */
+struct SolveRequest {
+    SolveRequest();
+
+    Eigen::VectorXd lbnds;
+    Eigen::VectorXd ubnds;
+    Eigen::VectorXd rayOriginInit;
+    LineSearchAlg lineSearchAlg;
+    /*! Lines "name = value" (readParameters) that override the parameters
+     *  of the daemon for this solve. */
+    std::string parameters;
+    /*! Key of the problem (0: none). The daemon keeps the best point of
+     *  the last solve of every key that found a feasible point (of the
+     *  SolverDaemon::kMaxWarmStarts most recently used keys). */
+    std::uint64_t problemKey;
+    /*! Whether the solve starts from the best point kept under problemKey
+     *  (if there is one of the same dimension, see RayEs::setWarmStart):
+     *  the initial ray points from rayOriginInit to it, and it is the
+     *  initial best individual if it is feasible for this problem. */
+    bool warmStart;
+    /*! Whether the daemon streams the status once per generation. */
+    bool progress;
+};
+
+/*!
+ * \brief Serves solve requests over a Unix domain socket.
+ *
+ * The problem functions stay with the client: the daemon runs the solver
+ * in batch mode and sends the points of every batch to the client, which
+ * returns their values. What a short solve in a new process pays again
+ * and again is kept between the requests: the worker pool of the batch
+ * mode, the message buffers, the parameters (e.g. of a tuning run) and
+ * the best point of every problem key as a warm start.
+ *
+ * The connections are served one after the other, every connection may
+ * send any number of requests. A client that fails or disconnects during
+ * a solve only ends its own connection.
+ */
+class SolverDaemon {
+ public:
+    /*! Number of problem keys whose best points are kept; the point of
+     *  the least recently used key is dropped first. */
+    static const std::size_t kMaxWarmStarts = 1024;
+
+    /*!
+     * \brief Creates the socket. Throws std::runtime_error if it cannot be
+     * created or another daemon serves the path (a stale socket file is
+     * replaced).
+     */
+    SolverDaemon(const std::string &socketPath,
+                 const Parameters &parameters = Parameters());
+    /*! Closes and removes the socket. */
+    ~SolverDaemon();
+
+    SolverDaemon(const SolverDaemon &) = delete;
+    SolverDaemon &operator=(const SolverDaemon &) = delete;
+
+    /*! Serves the clients until one of them requests the shutdown. */
+    void serve();
+
+    /*! Number of completed solves. */
+    long getNumSolves() const;
+
+ private:
+    // serves the requests of a connection; returns false on shutdown
+    bool serveConnection(MessageChannel &channel);
+    void solve(MessageChannel &channel);
+    // keeps the best point of a problem key as its most recently used one
+    void keepWarmStart(std::uint64_t problemKey,
+                       const Eigen::VectorXd &point);
+
+    std::string m_socketPath;
+    int m_socket;
+    Parameters m_parameters;
+    std::shared_ptr<es::core::WorkerPool> m_workerPool;
+    // the best point of every kept problem key and its position in the
+    // use order (most recently used first)
+    struct WarmStart {
+        Eigen::VectorXd point;
+        std::list<std::uint64_t>::iterator use;
+    };
+    std::map<std::uint64_t, WarmStart> m_warmStarts;
+    std::list<std::uint64_t> m_warmStartUses;
+    long m_numSolves;
+};
+
+/*!
+ * \brief Connection to a SolverDaemon.
+ *
+ * Throws std::runtime_error if the daemon is not reachable, reports an
+ * error or the connection breaks. The connection cannot be used anymore
+ * after an exception of the problem functions.
+ */
+class SolverClient {
+ public:
+    explicit SolverClient(const std::string &socketPath);
+    ~SolverClient();
+
+    SolverClient(const SolverClient &) = delete;
+    SolverClient &operator=(const SolverClient &) = delete;
+
+    /*!
+     * \brief Solves the problem on the daemon, evaluating the batches it
+     * requests with the given functions.
+     *
+     * The result carries the termination criterion, the numbers of
+     * evaluations and generations, and the best and polished individuals
+     * (their f and bestOnRay).
+     */
+    Info solve(const SolveRequest &request,
+               const BatchObjectiveFun &batchObjectiveFun,
+               const BatchConstraintFun &batchConstraintFun,
+               const std::function<void(const RunStatus &)> &progressFun =
+                   std::function<void(const RunStatus &)>());
+
+    /*! Asks the daemon to stop serving. */
+    void shutdown();
+
+ private:
+    std::unique_ptr<MessageChannel> m_channel;
+};
+
+}
+}
+
+#endif
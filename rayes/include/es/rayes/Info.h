@@ -6,8 +6,14 @@
 #define ES_RAYES_INFO_H
 
 #include "es/rayes/Individual.h"
+#include "es/rayes/Parameters.h"
+
+#include "es/core/LatencyHistogram.h"
 
 #include <fstream>
+#include <map>
+#include <memory>
+#include <vector>
 
 namespace es {
 namespace rayes {
@@ -18,12 +24,31 @@ enum class TerminationCriterion {
     Unknown,
     GenerationLimitReached,
     SigmaLimitReached,
-    BestSoFarNotUpdatedTooLong
+    BestSoFarNotUpdatedTooLong,
+    LocalPolishTriggered
 };
 
 std::ostream &operator<<(std::ostream &os,
                          TerminationCriterion terminationCriterion);
 
+/*! \brief Cost and benefit of the line searches of one algorithm.
+ */
+struct LineSearchStatistics {
+    LineSearchStatistics();
+
+    /*! Number of line searches run with the algorithm. */
+    int numSelections;
+    /*! Fitness evaluations spent by these line searches. */
+    int numFitnessEvaluations;
+    /*! Probes of the Standard line search that were answered by the
+     *  evaluations of a coarser level or of the ray origin instead of being
+     *  evaluated again. */
+    int numSavedFitnessEvaluations;
+    /*! Sum of the improvements over the worst selected offspring
+     *  of the respective previous generation. */
+    double improvement;
+};
+
 /*! \brief Encapsulates information about a run of an evolution strategy.
  */
 class Info {
@@ -43,13 +68,69 @@ class Info {
     Individual getBestIndividual() const;
     void setBestIndividual(const Individual &bestIndividual);
 
+    /*! Fitness evaluations spent by the local polish (included in
+     *  getNumFitnessEvaluations()). */
+    int getNumPolishFitnessEvaluations() const;
+    void setNumPolishFitnessEvaluations(int numPolishFitnessEvaluations);
+
+    /*! The result of the local polish; the best individual is replaced by
+     *  it if it is better. */
+    Individual getPolishedIndividual() const;
+    void setPolishedIndividual(const Individual &polishedIndividual);
+
+    /*! The population size lambda used in each generation. */
+    std::vector<int> getLambdaHistory() const;
+    void setLambdaHistory(const std::vector<int> &lambdaHistory);
+
+    /*! Statistics of the line search algorithms used in the run. */
+    std::map<LineSearchAlg, LineSearchStatistics>
+    getLineSearchStatistics() const;
+    void setLineSearchStatistics(const std::map<LineSearchAlg,
+                                 LineSearchStatistics> &lineSearchStatistics);
+
+    /*! Latencies of the objective function calls (of the batch calls in
+     *  batch mode); null unless Parameters::recordLatencies is set. */
+    const std::shared_ptr<const es::core::LatencyHistogram> &
+    getObjectiveLatencies() const;
+    void setObjectiveLatencies(
+        const std::shared_ptr<const es::core::LatencyHistogram> &latencies);
+
+    /*! Latencies of the constraint function calls (of the batch calls in
+     *  batch mode). */
+    const std::shared_ptr<const es::core::LatencyHistogram> &
+    getConstraintLatencies() const;
+    void setConstraintLatencies(
+        const std::shared_ptr<const es::core::LatencyHistogram> &latencies);
+
+    /*! Latencies of the complete line searches of the offspring (including
+     *  their plane searches). */
+    const std::shared_ptr<const es::core::LatencyHistogram> &
+    getLineSearchLatencies() const;
+    void setLineSearchLatencies(
+        const std::shared_ptr<const es::core::LatencyHistogram> &latencies);
+
  private:
     TerminationCriterion m_terminationCriterion;
     int m_numFitnessEvaluations;
     int m_numGenerations;
     Individual m_bestIndividual;
+    int m_numPolishFitnessEvaluations;
+    Individual m_polishedIndividual;
+    std::vector<int> m_lambdaHistory;
+    std::map<LineSearchAlg, LineSearchStatistics> m_lineSearchStatistics;
+    // the histograms are large and shared by the copies of the Info
+    std::shared_ptr<const es::core::LatencyHistogram> m_objectiveLatencies;
+    std::shared_ptr<const es::core::LatencyHistogram> m_constraintLatencies;
+    std::shared_ptr<const es::core::LatencyHistogram> m_lineSearchLatencies;
 };
 
+/*!
+ * \brief Writes the latency histograms of the run, each preceded by a line
+ * "# objective", "# constraint" or "# lineSearch" (nothing if they were not
+ * recorded).
+ */
+void writeLatencies(std::ostream &os, const Info &info);
+
 }
 }
 
@@ -0,0 +1,264 @@
+/*! \file
+ *  \brief Parameters of the evolution strategy that evolves a ray.
+ */
+
+#ifndef ES_RAYES_PARAMETERS_H
+#define ES_RAYES_PARAMETERS_H
+
+#include <fstream>
+#include <string>
+
+namespace es {
+namespace rayes {
+
+/*! \brief Line search algorithm applied to the offspring rays. */
+enum class LineSearchAlg {
+    Standard,
+    Modified,
+    /*! A multi-armed bandit chooses between Standard and Modified based on
+     *  the improvement per fitness evaluation observed so far. */
+    Adaptive
+};
+
+std::ostream &operator<<(std::ostream &os, LineSearchAlg lineSearchAlg);
+
+/*! \brief Granularity of the choice of the Adaptive line search. */
+enum class LineSearchSelection {
+    /*! Every offspring chooses its line search separately. */
+    PerOffspring,
+    /*! All offspring of a generation use the same line search. */
+    PerGeneration
+};
+
+std::ostream &operator<<(std::ostream &os,
+                         LineSearchSelection lineSearchSelection);
+
+/*! \brief Treatment of line search probes outside of the box constraints.
+ *
+ * Reject keeps the original behavior: a probe outside of the bounds is
+ * infeasible. All other modes move the probe into the box before it is
+ * evaluated such that no line search iteration is spent on a point that
+ * violates the bounds.
+ *
+ * Clip is the recommended mode: it keeps the probe on the ray. Project and
+ * Reflect are off-ray modes. The moved probe no longer lies on the ray, but
+ * the line searches still treat its value as the value at the ray
+ * parameter, and the best point on the ray may be off the ray.
+ */
+enum class BoundHandling {
+    /*! Probes outside of the box are infeasible. */
+    Reject,
+    /*! The ray parameter is clipped to the box entry/exit of the ray
+     *  (recommended). */
+    Clip,
+    /*! The probe is projected onto the box (component-wise clamping; off
+     *  the ray). */
+    Project,
+    /*! The probe is reflected at the violated bounds (off the ray). */
+    Reflect
+};
+
+std::ostream &operator<<(std::ostream &os, BoundHandling boundHandling);
+
+/*! \brief Generation of the mutation vectors of the offspring rays.
+ *
+ * All modes generate the n x lambda perturbation matrix of a generation
+ * in one go. The variance-reduced modes cover more distinct directions
+ * per generation than independent samples.
+ */
+enum class MutationSampling {
+    /*! Independent standard normally distributed vectors. */
+    Gaussian,
+    /*! Pairs of mutually mirrored vectors z and -z. */
+    Mirrored,
+    /*! Blocks of up to n mutually orthogonal vectors (QR decomposition of
+     *  a Gaussian matrix) keeping the lengths of the Gaussian vectors. */
+    Orthogonal,
+    /*! Scrambled Sobol points mapped by the inverse normal distribution
+     *  function. */
+    Sobol,
+    /*! Gaussian vectors in a random k-dimensional subspace (k =
+     *  subspaceDimension) that is resampled every subspaceResampling
+     *  generations. Every coordinate belongs to one of k basis vectors
+     *  with disjoint supports and random signs, so a mutation needs k
+     *  normal variates and one pass over the n coordinates. */
+    Subspace,
+    /*! Every offspring mutates a random block of k consecutive
+     *  coordinates (cyclically) with k normal variates. */
+    CoordinateBlocks
+};
+
+std::ostream &operator<<(std::ostream &os, MutationSampling mutationSampling);
+
+/*! \brief Precision in which the population is stored.
+ *
+ * The mutation vectors and the offspring rays are the n x lambda buffers
+ * that are streamed through memory in every generation. In the Mixed mode
+ * they are stored in single precision, which halves the memory traffic at
+ * high dimensions; the recombination and the line searches (the positions
+ * at which the functions are evaluated) are computed in double precision.
+ */
+enum class Precision {
+    Double,
+    Mixed
+};
+
+std::ostream &operator<<(std::ostream &os, Precision precision);
+
+/*! \brief Control of the population size lambda. */
+enum class PopulationSizeControl {
+    /*! lambda = lambdaPerDimension * dimension in every generation. */
+    Fixed,
+    /*! lambda is decreased while the best-so-far improves and increased
+     *  while it stagnates. */
+    Adaptive
+};
+
+std::ostream &operator<<(std::ostream &os,
+                         PopulationSizeControl populationSizeControl);
+
+/*! \brief Optional settings of the Ray-ES.
+ *
+ * The default values yield the algorithm as described in the paper.
+ */
+struct Parameters {
+    Parameters();
+
+    /*! Population size of the fixed control in multiples of the
+     *  dimension. */
+    int lambdaPerDimension;
+    /*! Number of selected offspring relative to the population size:
+     *  mu = max(1, floor(selectionRatio * lambda)). */
+    double selectionRatio;
+    /*! Factor of the learning rate tau = tauFactor / sqrt(2 * dimension)
+     *  of the mutation strength. */
+    double tauFactor;
+    /*! The run is terminated after gLagPerDimension * dimension
+     *  generations without improvement of the best-so-far. */
+    int gLagPerDimension;
+
+    /*! Number of partitions of the ray in the Standard line search. */
+    int lineSearchPartitions;
+    /*! Number of partitions of the interval between the neighbors of the
+     *  best point in the refinement levels of the Standard line search
+     *  (0: lineSearchPartitions, at least 2). */
+    int lineSearchRefinementPartitions;
+    /*! Resolution at which the line searches stop. */
+    double lineSearchEpsilon;
+    /*! Step size increase factor of the Modified line search (> 1). */
+    double lineSearchStepSizeIncreaseFactor;
+    /*! Step size decrease factor of the Modified line search (> 1). */
+    double lineSearchStepSizeDecreaseFactor;
+    /*! Fraction of the offspring of a generation that continue their
+     *  line search with a compass search in the plane spanned by the
+     *  offspring ray and the parent ray (0: none). The offspring ray is
+     *  turned towards the best point found in the plane. */
+    double planeSearchRatio;
+    /*! Fitness evaluation budget of the plane search of an offspring. */
+    int planeSearchMaxFitnessEvaluations;
+
+    /*! Treatment of line search probes outside of the box (Clip is
+     *  recommended, see BoundHandling). */
+    BoundHandling boundHandling;
+
+    /*! Generation of the mutation vectors of the offspring rays. */
+    MutationSampling mutationSampling;
+    /*! Dimension k of the Subspace and CoordinateBlocks mutations
+     *  (0: ceil(sqrt(dimension)), at most dimension). The mutations are
+     *  scaled by sqrt(dimension / k) to the length of a full Gaussian
+     *  vector, and the learning rate is tauFactor / sqrt(2 * k). */
+    int subspaceDimension;
+    /*! Number of generations after which the subspace of the Subspace
+     *  mutations is resampled. */
+    int subspaceResampling;
+
+    /*! Storage precision of the mutation vectors and offspring rays. */
+    Precision precision;
+
+    /*! Control of the population size lambda. */
+    PopulationSizeControl populationSizeControl;
+    /*! Smallest lambda for adaptive control (0: max(4, dimension)).
+     *  The adaptive control starts with this value. */
+    int lambdaMin;
+    /*! Largest lambda for adaptive control (0: 16 * dimension). */
+    int lambdaMax;
+    /*! Factor by which lambda is increased or decreased (> 1). */
+    double lambdaChangeFactor;
+    /*! Smoothed success rate above which lambda is decreased. */
+    double targetSuccessRate;
+    /*! Weight of the current generation in the smoothed success rate. */
+    double successRateSmoothing;
+
+    /*! Granularity of the choice of the Adaptive line search. */
+    LineSearchSelection lineSearchSelection;
+    /*! Weight of the exploration term of the UCB1 bandit. */
+    double banditExploration;
+    /*! Per-generation discount of the bandit statistics (in (0, 1]). */
+    double banditDiscount;
+
+    /*! Whether to refine the best point with a local pattern search on the
+     *  active constraint set once the ES converges or stagnates. */
+    bool localPolish;
+    /*! The local polish is started when sigma falls below this value. */
+    double polishSigma;
+    /*! The local polish is started after this many generations without
+     *  improvement of the best-so-far (0: 5 * dimension). */
+    int polishStagnation;
+    /*! Fitness evaluation budget of the local polish (0: 200 * dimension). */
+    int polishMaxFitnessEvaluations;
+    /*! Constraints with values above -polishActiveTolerance (and bounds
+     *  closer than it) are considered active. */
+    double polishActiveTolerance;
+
+    /*! Number of threads that run the line searches of a generation
+     *  (1: sequentially in the calling thread). The functions must be
+     *  thread-safe if it is greater than 1; the result does not depend on
+     *  it. The batch mode of RayEs uses one thread per offspring. */
+    int numThreads;
+    /*! Whether the threads are pinned to the allowed CPUs, filling one
+     *  NUMA node before the next (see es::core::WorkerPool). */
+    bool pinThreads;
+
+    /*! Whether the latencies of the function calls and line searches are
+     *  recorded in the Info. This costs two clock reads (some 10 ns each)
+     *  per call, which only matters for very cheap functions. */
+    bool recordLatencies;
+
+    /*! Seed of the random number generator set at the start of run()
+     *  (0: the generator is not reseeded). */
+    unsigned seed;
+
+    /*! Whether run() publishes its progress in a shared-memory segment
+     *  (see Status.h). */
+    bool publishStatus;
+    /*! Label of the published status (e.g. the name of the problem, at
+     *  most 63 characters are shown). */
+    std::string statusLabel;
+};
+
+/*!
+ * \brief Writes the parameters as lines "name = value".
+ *
+ * The output can be read by readParameters (e.g. a parameter file created
+ * by a tuning run).
+ */
+void writeParameters(std::ostream &os, const Parameters &parameters);
+
+/*!
+ * \brief Reads lines "name = value" into the parameters.
+ *
+ * Parameters that are not given keep their values. Empty lines and lines
+ * starting with '#' are ignored. Throws std::runtime_error for unknown
+ * names and invalid values.
+ */
+void readParameters(std::istream &is, Parameters &parameters);
+
+/*!
+ * \brief Returns the default parameters updated by the parameter file.
+ */
+Parameters loadParameters(const std::string &path);
+
+}
+}
+
+#endif
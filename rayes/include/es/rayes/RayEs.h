@@ -6,19 +6,22 @@
 #define ES_RAYES_RAYES_H
 
 #include "es/rayes/Info.h"
+#include "es/rayes/Parameters.h"
+#include "es/rayes/Status.h"
 
+#include <atomic>
 #include <functional>
+#include <memory>
 #include <set>
 
 #include <Eigen/Dense>
 
 namespace es {
-namespace rayes {
+namespace core {
+class WorkerPool;
+}
 
-    enum class LineSearchAlg {
-        Standard,
-        Modified
-    };
+namespace rayes {
 
     namespace {
         struct LineSearchResult {
@@ -27,17 +30,55 @@ namespace rayes {
                 , f(0.0)
                 , feasibleFound(false)
                 , numFitnessEvaluations(0)
-                , bestOnRayDirection(0) {
+                , numSavedFitnessEvaluations(0)
+                , bestOnRayDirection(0)
+                , bestOnRayHandle(-1) {
             }
 
             Eigen::VectorXd bestOnRay;
             double f;
             bool feasibleFound;
             int numFitnessEvaluations;
+            int numSavedFitnessEvaluations;
             int bestOnRayDirection;
+            long bestOnRayHandle;
         };
     }
 
+/*! \brief Hints passed with every point to a ContextObjectiveFun.
+ *
+ * Every evaluation gets a handle, and the context names the nearest point
+ * evaluated before on the same ray: in the Standard line search the
+ * previous feasible grid node of the sweep (or the center of the sweep),
+ * in the Modified line search the point the probe steps from, and
+ * in the plane search and the local polish the current best point. An
+ * objective function that runs an iterative solver can store its state
+ * under the handle and start the next evaluation from the state of the
+ * neighbor. The hints do not change the evaluations of the optimizer.
+ */
+struct EvaluationContext {
+    /*! Handle of this evaluation (unique for the solver). */
+    long handle;
+    /*! Handle of the neighbor (-1 if there is none). */
+    long neighborHandle;
+    /*! The neighbor (nullptr if there is none); only valid during the
+     *  call. */
+    const Eigen::VectorXd *neighbor;
+};
+
+/*! Objective function that receives warm-start hints. */
+typedef std::function<double(const Eigen::VectorXd &,
+                             const EvaluationContext &)>
+    ContextObjectiveFun;
+
+/*! Objective function evaluated at the columns of a matrix. */
+typedef std::function<Eigen::VectorXd(const Eigen::MatrixXd &)>
+    BatchObjectiveFun;
+/*! Constraint function evaluated at the columns of a matrix; column k of
+ *  the result holds the constraint values of point k. */
+typedef std::function<Eigen::MatrixXd(const Eigen::MatrixXd &)>
+    BatchConstraintFun;
+
 /*! \brief Evolution strategy that evolves a ray.
  */
 class RayEs {
@@ -49,15 +90,96 @@ class RayEs {
           const Eigen::VectorXd &lbnds,
           const Eigen::VectorXd &ubnds,
           const Eigen::VectorXd &rayOriginInit,
-          const LineSearchAlg lineSearchAlg);
+          const LineSearchAlg lineSearchAlg,
+          const Parameters &parameters = Parameters());
+
+    /*!
+     * \brief Creates a solver that evaluates the functions in batches.
+     *
+     * The line searches of the offspring of a generation run concurrently
+     * in lockstep: whenever all of them wait for an evaluation, the
+     * requested points are passed to the batch function at once (ordered
+     * by offspring). The line searches do not depend on each other, so
+     * the run equals the run with the corresponding per-point functions.
+     * The batch functions are only called from the thread that calls
+     * run().
+     */
+    RayEs(const BatchObjectiveFun &batchObjectiveFun,
+          const BatchConstraintFun &batchConstraintFun,
+          const Eigen::VectorXd &lbnds,
+          const Eigen::VectorXd &ubnds,
+          const Eigen::VectorXd &rayOriginInit,
+          const LineSearchAlg lineSearchAlg,
+          const Parameters &parameters = Parameters());
+
+    /*!
+     * \brief Creates a solver that passes an EvaluationContext with every
+     * point to the objective function.
+     *
+     * With numThreads > 1, the function is called concurrently, so a cache
+     * of solver states keyed by the handles must be thread-safe.
+     */
+    RayEs(const ContextObjectiveFun &contextObjectiveFun,
+          const std::function<Eigen::VectorXd(
+                              const Eigen::VectorXd &)> &constraintFun,
+          const Eigen::VectorXd &lbnds,
+          const Eigen::VectorXd &ubnds,
+          const Eigen::VectorXd &rayOriginInit,
+          const LineSearchAlg lineSearchAlg,
+          const Parameters &parameters = Parameters());
 
     Info run();
 
+    /*!
+     * \brief Runs the line searches of the parallel and the batch mode on
+     * the given pool instead of a pool of their own.
+     *
+     * A pool that outlives the solver saves starting the threads of every
+     * run; run() adds workers as needed, and all workers of the pool take
+     * part in the parallel line searches.
+     */
+    void setWorkerPool(const std::shared_ptr<es::core::WorkerPool> &pool);
+
+    /*!
+     * \brief Sets a function that receives the status of the run once per
+     * generation (as published with Parameters::publishStatus).
+     *
+     * The function is called from the thread that calls run().
+     */
+    void setProgressFun(
+        const std::function<void(const RunStatus &)> &progressFun);
+
+    /*!
+     * \brief Starts the runs from the given point (e.g. the best point of a
+     * related problem) instead of a random ray.
+     *
+     * The initial ray points from the ray origin to the point, the ray
+     * mutations start at a tenth of their usual scale, and the point is
+     * the initial best individual if it is feasible. An empty point (the
+     * default) restores the random start.
+     */
+    void setWarmStart(const Eigen::VectorXd &point);
+
+    /*!
+     * \brief Returns the best individual of the last run so far, also if a
+     * problem function left run() by an exception (e.g. to stop the run).
+     */
+    Individual getBestIndividual() const;
+
  private:
+    // run() with the population stored in the given scalar type
+    // (Parameters::precision)
+    template<typename Scalar>
+    Info runWithStorage();
+
     LineSearchResult lineSearch(const Eigen::VectorXd &rayNormalized,
                                 const double lineSearchLineLength,
                                 const int lineSearchPartitions,
+                                const int lineSearchRefinementPartitions,
                                 const Eigen::VectorXd &rayOrigin,
+                                const bool isRayOriginFeasible,
+                                const double rayOriginF,
+                                const long rayOriginHandle,
                                 const double epsilon);
     LineSearchResult lineSearch2(const Eigen::VectorXd &rayNormalized,
                                  const Eigen::VectorXd &rayOrigin,
@@ -67,14 +189,53 @@ class RayEs {
                                  const double epsilon,
                                  const std::set<int> &directions);
 
+    LineSearchResult planeSearch(const LineSearchResult &lineSearchResult,
+                                 const Eigen::VectorXd &rayNormalized,
+                                 const Eigen::VectorXd &parentRay,
+                                 const double stepSizeInit,
+                                 const double stepSizeStop,
+                                 const int maxFitnessEvaluations);
+
+    LineSearchResult localPolish(const Eigen::VectorXd &x0,
+                                 const double f0,
+                                 const long x0Handle,
+                                 const double stepSizeInit,
+                                 const double stepSizeStop,
+                                 const int maxFitnessEvaluations);
+
+    Eigen::VectorXd probe(const Eigen::VectorXd &origin,
+                          const Eigen::VectorXd &rayNormalized,
+                          const double t) const;
+
     bool isFeasible(const Eigen::VectorXd &x);
 
+    // evaluates the objective function at x; with a context objective
+    // function, the neighbor is passed as hint and the handle of x is
+    // returned in handle (-1 otherwise)
+    double evaluate(const Eigen::VectorXd &x, const long neighborHandle,
+                    const Eigen::VectorXd *neighbor, long &handle);
+
+    // evaluates the constraint function at x
+    Eigen::VectorXd evaluateConstraints(const Eigen::VectorXd &x);
+
+    class LockstepEvaluator;
+    // set in batch mode; the per-point functions forward to it
+    std::shared_ptr<LockstepEvaluator> m_lockstepEvaluator;
+
     std::function<double(const Eigen::VectorXd &)> m_objectiveFun;
     std::function<Eigen::VectorXd(const Eigen::VectorXd &)> m_constraintFun;
+    // set by the constructor with the context objective function
+    ContextObjectiveFun m_contextObjectiveFun;
+    std::shared_ptr<std::atomic<long>> m_nextEvaluationHandle;
+    std::shared_ptr<es::core::WorkerPool> m_workerPool;
+    std::function<void(const RunStatus &)> m_progressFun;
+    Eigen::VectorXd m_warmStart;
+    Individual m_bestIndividual;
     Eigen::VectorXd m_lbnds;
     Eigen::VectorXd m_ubnds;
     Eigen::VectorXd m_rayOriginInit;
     LineSearchAlg m_lineSearchAlg;
+    Parameters m_parameters;
 };
 
 }
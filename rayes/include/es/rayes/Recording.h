@@ -0,0 +1,113 @@
+/*! \file
+ *  \brief Record and replay of the function evaluations of a run.
+ */
+
+#ifndef ES_RAYES_RECORDING_H
+#define ES_RAYES_RECORDING_H
+
+#include "es/rayes/Parameters.h"
+
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#include <Eigen/Dense>
+
+namespace es {
+namespace rayes {
+
+/*! \brief Records the objective and constraint evaluations of a run.
+ *
+ * The recorder writes the setup of the run (bounds, initial ray origin,
+ * line search algorithm and parameters including the seed) and every
+ * evaluation (x, f(x)) resp. (x, c(x)) in call order to a binary file.
+ * The run is set up with the functions returned by objective() and
+ * constraint(). The parameters must have a nonzero seed and numThreads = 1
+ * (the functions are called in a fixed order then) such that the run can
+ * be repeated by EvaluationReplay; the constructor throws
+ * std::runtime_error otherwise.
+ */
+class EvaluationRecorder {
+ public:
+    EvaluationRecorder(const std::string &path,
+                       const Eigen::VectorXd &lbnds,
+                       const Eigen::VectorXd &ubnds,
+                       const Eigen::VectorXd &rayOriginInit,
+                       const LineSearchAlg lineSearchAlg,
+                       const Parameters &parameters);
+
+    /*! Returns the objective function that records its evaluations. */
+    std::function<double(const Eigen::VectorXd &)> objective(
+        const std::function<double(const Eigen::VectorXd &)> &objectiveFun);
+
+    /*! Returns the constraint function that records its evaluations. */
+    std::function<Eigen::VectorXd(const Eigen::VectorXd &)> constraint(
+        const std::function<Eigen::VectorXd(
+                            const Eigen::VectorXd &)> &constraintFun);
+
+    /*! Writes the buffered evaluations to the file. Throws
+     *  std::runtime_error if the file cannot be written. */
+    void flush();
+
+ private:
+    struct Output;
+    std::shared_ptr<Output> m_output;
+};
+
+/*! \brief Thrown by a replayed function that is called after the last
+ *  recorded evaluation (e.g. if the recorded run was stopped by the
+ *  caller).
+ */
+class ReplayEndReached : public std::runtime_error {
+ public:
+    ReplayEndReached();
+};
+
+/*! \brief Replays the evaluations recorded by an EvaluationRecorder.
+ *
+ * The file is read completely on construction. The functions returned by
+ * objective() and constraint() return the recorded values by call
+ * sequence without evaluating the problem, such that a run set up with
+ * the recorded bounds, origin, line search algorithm and parameters
+ * repeats the recorded run at the speed of the optimizer alone. A call
+ * that does not match the next record (another function or another point)
+ * throws std::runtime_error, a call after the last record throws
+ * ReplayEndReached.
+ */
+class EvaluationReplay {
+ public:
+    explicit EvaluationReplay(const std::string &path);
+
+    const Eigen::VectorXd &getLbnds() const;
+    const Eigen::VectorXd &getUbnds() const;
+    const Eigen::VectorXd &getRayOriginInit() const;
+    LineSearchAlg getLineSearchAlg() const;
+    const Parameters &getParameters() const;
+
+    /*! Number of recorded evaluations. */
+    long getNumEvaluations() const;
+    /*! Number of evaluations replayed so far. */
+    long getNumReplayedEvaluations() const;
+
+    /*! Starts the replay from the first evaluation again. */
+    void rewind();
+
+    std::function<double(const Eigen::VectorXd &)> objective() const;
+    std::function<Eigen::VectorXd(const Eigen::VectorXd &)>
+    constraint() const;
+
+ private:
+    struct Input;
+    std::shared_ptr<Input> m_input;
+    Eigen::VectorXd m_lbnds;
+    Eigen::VectorXd m_ubnds;
+    Eigen::VectorXd m_rayOriginInit;
+    LineSearchAlg m_lineSearchAlg;
+    Parameters m_parameters;
+};
+
+}
+}
+
+#endif
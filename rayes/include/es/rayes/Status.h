@@ -0,0 +1,86 @@
+/*! \file
+ *  \brief Live status of runs published through POSIX shared memory.
+ */
+
+#ifndef ES_RAYES_STATUS_H
+#define ES_RAYES_STATUS_H
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace es {
+namespace rayes {
+
+/*! \brief Phase of a run. */
+enum class RunPhase {
+    Initializing,
+    /*! Generations of the evolution strategy. */
+    Evolving,
+    Polishing,
+    Finished
+};
+
+std::ostream &operator<<(std::ostream &os, RunPhase runPhase);
+
+/*! \brief Snapshot of the status of a run. */
+struct RunStatus {
+    RunStatus();
+
+    /*! Process that runs the solver. */
+    long pid;
+    /*! Label given by Parameters::statusLabel. */
+    std::string label;
+    RunPhase phase;
+    int generation;
+    double sigma;
+    /*! Best objective function value found so far. */
+    double bestF;
+    int numFitnessEvaluations;
+    double fitnessEvaluationsPerSecond;
+    /*! Time since the start of the run. */
+    double elapsedSeconds;
+};
+
+/*! \brief Publishes the status of a run in a POSIX shared-memory segment.
+ *
+ * The segment is created on construction and removed on destruction. The
+ * status is written with seqlock semantics: publish() never blocks and
+ * costs a few stores, readers retry until they got a consistent snapshot.
+ * The segments of all runs on the host are read with readRunStatuses().
+ */
+class StatusPublisher {
+ public:
+    /*! Creates the segment. Throws std::runtime_error on failure. */
+    explicit StatusPublisher(const std::string &label);
+    ~StatusPublisher();
+
+    StatusPublisher(const StatusPublisher &) = delete;
+    StatusPublisher &operator=(const StatusPublisher &) = delete;
+
+    /*! Updates the status (the pid and the label are not changed). */
+    void publish(const RunStatus &status);
+
+    /*! Name of the segment (for shm_open). */
+    const std::string &getName() const;
+
+ private:
+    friend std::vector<RunStatus> readRunStatuses(bool removeStale);
+
+    struct Segment;
+    Segment *m_segment;
+    std::string m_name;
+};
+
+/*!
+ * \brief Returns the status of all runs on the host that publish it.
+ *
+ * Segments of processes that no longer exist (e.g. killed runs) are
+ * skipped; they are removed if removeStale is set.
+ */
+std::vector<RunStatus> readRunStatuses(bool removeStale = false);
+
+}
+}
+
+#endif
@@ -0,0 +1,135 @@
+/*! \file
+ *  \brief C interface of the Ray-ES for embedding it in C and Fortran code.
+ *
+ *  The problem functions are plain C callbacks. They receive the point as a
+ *  const double array of length dimension, which is the buffer of the
+ *  solver itself, and write their results to an array owned by the
+ *  library. All functions of the interface are usable from Fortran with
+ *  bind(C).
+ *
+ *  Example:
+ *
+ *      rayes_solver_t *solver = rayes_create(n, m, lower, upper, origin,
+ *                                            objective, constraint, data);
+ *      rayes_set_parameter(solver, "seed", "1");
+ *      if (rayes_run(solver) >= 0) {
+ *          rayes_get_best_solution(solver, x);
+ *      }
+ *      rayes_destroy(solver);
+ */
+
+#ifndef ES_RAYES_RAYES_C_H
+#define ES_RAYES_RAYES_C_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*! \brief Return values of rayes_run() and the setters. */
+#define RAYES_OK 0
+/*! \brief The run was stopped by a callback (the best point of the
+ *  completed generations is available). */
+#define RAYES_STOPPED 1
+/*! \brief An error occurred (see rayes_get_last_error()). */
+#define RAYES_ERROR (-1)
+
+/*! \brief Line search algorithms (see es::rayes::LineSearchAlg). */
+#define RAYES_LINE_SEARCH_STANDARD 0
+#define RAYES_LINE_SEARCH_MODIFIED 1
+#define RAYES_LINE_SEARCH_ADAPTIVE 2
+
+/*! \brief The opaque solver type. */
+struct rayes_solver_s;
+typedef struct rayes_solver_s rayes_solver_t;
+
+/*!
+ * \brief Evaluates the objective function at x and stores the value in
+ * f[0].
+ *
+ * Returns 0 to continue and a nonzero value to stop the run (e.g. when the
+ * budget is exhausted).
+ */
+typedef int (*rayes_objective_t)(const double *x, double *f,
+                                 void *user_data);
+
+/*!
+ * \brief Evaluates the constraints at x and stores the values in c[0],
+ * ..., c[number_of_constraints - 1].
+ *
+ * The point x is feasible if all values are at most 0. Returns 0 to
+ * continue and a nonzero value to stop the run.
+ */
+typedef int (*rayes_constraint_t)(const double *x, double *c,
+                                  void *user_data);
+
+/*!
+ * \brief Creates a solver.
+ *
+ * The bounds and the initial ray origin (which should be feasible) are
+ * arrays of dimension values, they are copied. The constraint function may
+ * be NULL without constraints, user_data is passed to the callbacks.
+ * Returns NULL if the arguments are invalid or memory is exhausted.
+ */
+rayes_solver_t *rayes_create(size_t dimension,
+                             size_t number_of_constraints,
+                             const double *lower_bounds,
+                             const double *upper_bounds,
+                             const double *ray_origin,
+                             rayes_objective_t objective,
+                             rayes_constraint_t constraint,
+                             void *user_data);
+
+/*! \brief Frees the solver (NULL is ignored). */
+void rayes_destroy(rayes_solver_t *solver);
+
+/*! \brief Sets the line search algorithm (RAYES_LINE_SEARCH_MODIFIED by
+ *  default). */
+int rayes_set_line_search(rayes_solver_t *solver, int line_search);
+
+/*! \brief Sets a parameter of es::rayes::Parameters by name, e.g. ("seed",
+ *  "42"), with the syntax of the parameter files. */
+int rayes_set_parameter(rayes_solver_t *solver, const char *name,
+                        const char *value);
+
+/*! \brief Sets the parameters from a parameter file (see
+ *  es::rayes::loadParameters()). */
+int rayes_load_parameters(rayes_solver_t *solver, const char *path);
+
+/*!
+ * \brief Runs the solver from the initial ray origin.
+ *
+ * Returns RAYES_OK if the run terminated, RAYES_STOPPED if a callback
+ * stopped it and RAYES_ERROR on errors. The solver can be run again; the
+ * results refer to the last run. The callbacks are called from the calling
+ * thread only, so the parameter numThreads must be 1.
+ */
+int rayes_run(rayes_solver_t *solver);
+
+/*! \brief Returns the best objective function value of the last run
+ *  (DBL_MAX if no feasible point was found). */
+double rayes_get_best_value(const rayes_solver_t *solver);
+
+/*! \brief Copies the best point of the last run to x (dimension values). */
+int rayes_get_best_solution(const rayes_solver_t *solver, double *x);
+
+/*! \brief Returns the number of objective function evaluations of the last
+ *  run. */
+long rayes_get_evaluations(const rayes_solver_t *solver);
+
+/*! \brief Returns the number of constraint evaluations of the last run. */
+long rayes_get_constraint_evaluations(const rayes_solver_t *solver);
+
+/*! \brief Returns the termination criterion of the last run (e.g.
+ *  "SigmaLimitReached" or "Stopped"). */
+const char *rayes_get_termination_criterion(const rayes_solver_t *solver);
+
+/*! \brief Returns the message of the last error ("" if none). */
+const char *rayes_get_last_error(const rayes_solver_t *solver);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,609 @@
+#include "es/rayes/Daemon.h"
+
+#include "es/core/WorkerPool.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace es {
+namespace rayes {
+
+// Protocol (native byte order, both ends are on the same host). Every
+// message is a uint32 type, a uint32 payload size and the payload:
+//   client -> daemon
+//     SOLVE:      uint32 dimension n, uint32 line search algorithm,
+//                 uint64 problem key, uint32 flags (1 warm start,
+//                 2 progress), n doubles each for the lower bounds, the
+//                 upper bounds and the initial ray origin, uint32 length
+//                 and text of the parameters
+//     VALUES:     uint32 rows m, uint32 columns k, m * k doubles (column
+//                 major; the reply to OBJECTIVE with m = 1 and to
+//                 CONSTRAINT)
+//     SHUTDOWN:   empty
+//   daemon -> client
+//     OBJECTIVE,
+//     CONSTRAINT: uint32 n, uint32 k, n * k doubles (the points as columns)
+//     PROGRESS:   uint32 phase, int32 generation, int32 evaluations,
+//                 double sigma, double best f, double elapsed seconds
+//     RESULT:     uint32 termination criterion, int32 evaluations,
+//                 int32 generations, int32 polish evaluations, then for
+//                 the best and the polished individual: double f, uint32
+//                 size and doubles of bestOnRay
+//     ERROR:      text of the error (the connection stays usable)
+namespace {
+
+const std::uint32_t SOLVE = 1;
+const std::uint32_t VALUES = 2;
+const std::uint32_t SHUTDOWN = 3;
+const std::uint32_t OBJECTIVE = 16;
+const std::uint32_t CONSTRAINT = 17;
+const std::uint32_t PROGRESS = 18;
+const std::uint32_t RESULT = 19;
+const std::uint32_t ERROR = 20;
+
+const std::uint32_t WARM_START = 1;
+const std::uint32_t STREAM_PROGRESS = 2;
+
+// bound on the payload of a message (guards against garbage)
+const std::uint32_t MAX_PAYLOAD_SIZE = 1u << 30;
+
+sockaddr_un socketAddress(const std::string &path) {
+    sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (path.empty() || path.size() >= sizeof(address.sun_path)) {
+        throw std::runtime_error("Invalid socket path " + path);
+    }
+    std::strcpy(address.sun_path, path.c_str());
+    return address;
+}
+
+// returns a socket connected to the path or -1
+int connectSocket(const std::string &path) {
+    const sockaddr_un address = socketAddress(path);
+    const int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        throw std::runtime_error(std::string("Cannot create a socket: ") +
+                                 std::strerror(errno));
+    }
+    if (::connect(fd, reinterpret_cast<const sockaddr *>(&address),
+                  sizeof(address)) != 0) {
+        ::close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+}
+
+// Reads and writes the messages of a connection. The buffers are kept
+// between the messages, so a solve does not allocate per batch once they
+// have grown to the size of the largest batch.
+class MessageChannel {
+ public:
+    explicit MessageChannel(int fd)
+        : m_fd(fd)
+        , m_position(0)
+        , m_broken(false) {
+    }
+
+    ~MessageChannel() {
+        ::close(m_fd);
+    }
+
+    MessageChannel(const MessageChannel &) = delete;
+    MessageChannel &operator=(const MessageChannel &) = delete;
+
+    // whether a read or write failed, i.e. the connection is unusable
+    bool isBroken() const {
+        return m_broken;
+    }
+
+    void begin(std::uint32_t type) {
+        m_out.resize(2 * sizeof(std::uint32_t));
+        std::memcpy(m_out.data(), &type, sizeof(type));
+    }
+
+    template<typename T>
+    void put(const T &value) {
+        const char *p = reinterpret_cast<const char *>(&value);
+        m_out.insert(m_out.end(), p, p + sizeof(T));
+    }
+
+    void put(const double *values, std::size_t size) {
+        const char *p = reinterpret_cast<const char *>(values);
+        m_out.insert(m_out.end(), p, p + size * sizeof(double));
+    }
+
+    void putString(const std::string &text) {
+        m_out.insert(m_out.end(), text.begin(), text.end());
+    }
+
+    void send() {
+        const std::uint32_t size = static_cast<std::uint32_t>(
+            m_out.size() - 2 * sizeof(std::uint32_t));
+        std::memcpy(m_out.data() + sizeof(std::uint32_t), &size,
+                    sizeof(size));
+        std::size_t sent = 0;
+        while (sent < m_out.size()) {
+            const ssize_t n = ::send(m_fd, m_out.data() + sent,
+                                     m_out.size() - sent, MSG_NOSIGNAL);
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n <= 0) {
+                fail(std::string("Cannot send: ") + std::strerror(errno));
+            }
+            sent += static_cast<std::size_t>(n);
+        }
+    }
+
+    // receives the next message and returns its type; returns false if
+    // the peer closed the connection between two messages
+    bool receive(std::uint32_t &type) {
+        std::uint32_t header[2];
+        if (!readAll(reinterpret_cast<char *>(header), sizeof(header),
+                     true)) {
+            return false;
+        }
+        if (header[1] > MAX_PAYLOAD_SIZE) {
+            fail("Invalid message size");
+        }
+        type = header[0];
+        m_in.resize(header[1]);
+        readAll(m_in.data(), m_in.size(), false);
+        m_position = 0;
+        return true;
+    }
+
+    std::uint32_t receive() {
+        std::uint32_t type;
+        if (!receive(type)) {
+            fail("Connection closed");
+        }
+        return type;
+    }
+
+    template<typename T>
+    T get() {
+        T value;
+        std::memcpy(&value, take(sizeof(T)), sizeof(T));
+        return value;
+    }
+
+    // throws unless the rest of the payload holds size doubles (checked
+    // before the doubles are allocated)
+    void expectDoubles(std::uint64_t size) {
+        if (size > (m_in.size() - m_position) / sizeof(double)) {
+            fail("Truncated message");
+        }
+    }
+
+    void get(double *values, std::size_t size) {
+        std::memcpy(values, take(size * sizeof(double)),
+                    size * sizeof(double));
+    }
+
+    std::string getString(std::size_t size) {
+        const char *p = take(size);
+        return std::string(p, size);
+    }
+
+    // the rest of the payload as text
+    std::string getRest() {
+        return getString(m_in.size() - m_position);
+    }
+
+    [[noreturn]] void fail(const std::string &message) {
+        m_broken = true;
+        throw std::runtime_error(message);
+    }
+
+    // gives up the connection such that the peer sees its end at once
+    void abandon() {
+        m_broken = true;
+        ::shutdown(m_fd, SHUT_RDWR);
+    }
+
+ private:
+    const char *take(std::size_t size) {
+        if (size > m_in.size() - m_position) {
+            fail("Truncated message");
+        }
+        const char *p = m_in.data() + m_position;
+        m_position += size;
+        return p;
+    }
+
+    bool readAll(char *data, std::size_t size, bool endAllowed) {
+        std::size_t received = 0;
+        while (received < size) {
+            const ssize_t n = ::recv(m_fd, data + received,
+                                     size - received, 0);
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n == 0 && received == 0 && endAllowed) {
+                return false;
+            }
+            if (n <= 0) {
+                fail(n == 0 ? std::string("Connection closed") :
+                     std::string("Cannot receive: ") + std::strerror(errno));
+            }
+            received += static_cast<std::size_t>(n);
+        }
+        return true;
+    }
+
+    int m_fd;
+    std::vector<char> m_out;
+    std::vector<char> m_in;
+    std::size_t m_position;
+    bool m_broken;
+};
+
+namespace {
+
+void putMatrix(MessageChannel &channel, std::uint32_t type,
+               const Eigen::MatrixXd &x) {
+    channel.begin(type);
+    channel.put(static_cast<std::uint32_t>(x.rows()));
+    channel.put(static_cast<std::uint32_t>(x.cols()));
+    channel.put(x.data(), static_cast<std::size_t>(x.size()));
+    channel.send();
+}
+
+Eigen::MatrixXd getMatrix(MessageChannel &channel) {
+    const std::uint32_t rows = channel.get<std::uint32_t>();
+    const std::uint32_t cols = channel.get<std::uint32_t>();
+    channel.expectDoubles(static_cast<std::uint64_t>(rows) * cols);
+    Eigen::MatrixXd x(rows, cols);
+    channel.get(x.data(), static_cast<std::size_t>(x.size()));
+    return x;
+}
+
+Eigen::VectorXd getVector(MessageChannel &channel, std::uint32_t size) {
+    channel.expectDoubles(size);
+    Eigen::VectorXd x(size);
+    channel.get(x.data(), size);
+    return x;
+}
+
+void putIndividual(MessageChannel &channel, const Individual &individual) {
+    const Eigen::VectorXd x = individual.bestOnRay();
+    channel.put(individual.f());
+    channel.put(static_cast<std::uint32_t>(x.size()));
+    channel.put(x.data(), static_cast<std::size_t>(x.size()));
+}
+
+Individual getIndividual(MessageChannel &channel) {
+    Individual individual;
+    individual.f(channel.get<double>());
+    individual.bestOnRay(
+        getVector(channel, channel.get<std::uint32_t>()));
+    return individual;
+}
+
+}
+
+SolveRequest::SolveRequest()
+    : lbnds()
+    , ubnds()
+    , rayOriginInit()
+    , lineSearchAlg(LineSearchAlg::Modified)
+    , parameters()
+    , problemKey(0)
+    , warmStart(false)
+    , progress(false) {
+}
+
+SolverDaemon::SolverDaemon(const std::string &socketPath,
+                           const Parameters &parameters)
+    : m_socketPath(socketPath)
+    , m_socket(-1)
+    , m_parameters(parameters)
+    , m_workerPool()
+    , m_warmStarts()
+    , m_warmStartUses()
+    , m_numSolves(0) {
+    const sockaddr_un address = socketAddress(socketPath);
+    const int running = connectSocket(socketPath);
+    if (running >= 0) {
+        ::close(running);
+        throw std::runtime_error("A daemon is serving " + socketPath);
+    }
+    // the file of a daemon that did not exit cleanly
+    ::unlink(socketPath.c_str());
+
+    m_socket = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (m_socket < 0) {
+        throw std::runtime_error(std::string("Cannot create a socket: ") +
+                                 std::strerror(errno));
+    }
+    if (::bind(m_socket, reinterpret_cast<const sockaddr *>(&address),
+               sizeof(address)) != 0 ||
+        ::listen(m_socket, 16) != 0) {
+        const std::string error = std::strerror(errno);
+        ::close(m_socket);
+        throw std::runtime_error("Cannot listen on " + socketPath + ": " +
+                                 error);
+    }
+    m_workerPool = std::make_shared<es::core::WorkerPool>(
+        std::max(1, m_parameters.numThreads), m_parameters.pinThreads);
+}
+
+SolverDaemon::~SolverDaemon() {
+    ::close(m_socket);
+    ::unlink(m_socketPath.c_str());
+}
+
+void SolverDaemon::serve() {
+    for (;;) {
+        const int fd = ::accept(m_socket, nullptr, nullptr);
+        if (fd < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) {
+                continue;
+            }
+            throw std::runtime_error(std::string("Cannot accept: ") +
+                                     std::strerror(errno));
+        }
+        MessageChannel channel(fd);
+        try {
+            if (!serveConnection(channel)) {
+                return;
+            }
+        } catch (const std::exception &e) {
+            std::cerr << "Connection closed: " << e.what() << std::endl;
+        }
+    }
+}
+
+long SolverDaemon::getNumSolves() const {
+    return m_numSolves;
+}
+
+bool SolverDaemon::serveConnection(MessageChannel &channel) {
+    std::uint32_t type;
+    while (channel.receive(type)) {
+        if (type == SOLVE) {
+            solve(channel);
+        } else if (type == SHUTDOWN) {
+            return false;
+        } else {
+            channel.fail("Unexpected message");
+        }
+    }
+    return true;
+}
+
+void SolverDaemon::keepWarmStart(std::uint64_t problemKey,
+                                 const Eigen::VectorXd &point) {
+    const auto warmStart = m_warmStarts.find(problemKey);
+    if (warmStart != m_warmStarts.end()) {
+        warmStart->second.point = point;
+        m_warmStartUses.splice(m_warmStartUses.begin(), m_warmStartUses,
+                               warmStart->second.use);
+        return;
+    }
+    if (m_warmStarts.size() >= kMaxWarmStarts) {
+        m_warmStarts.erase(m_warmStartUses.back());
+        m_warmStartUses.pop_back();
+    }
+    m_warmStartUses.push_front(problemKey);
+    WarmStart &kept = m_warmStarts[problemKey];
+    kept.point = point;
+    kept.use = m_warmStartUses.begin();
+}
+
+void SolverDaemon::solve(MessageChannel &channel) {
+    try {
+        const std::uint32_t n = channel.get<std::uint32_t>();
+        const std::uint32_t lineSearchAlg = channel.get<std::uint32_t>();
+        const std::uint64_t problemKey = channel.get<std::uint64_t>();
+        const std::uint32_t flags = channel.get<std::uint32_t>();
+        const Eigen::VectorXd lbnds = getVector(channel, n);
+        const Eigen::VectorXd ubnds = getVector(channel, n);
+        const Eigen::VectorXd rayOriginInit = getVector(channel, n);
+        std::istringstream text(
+            channel.getString(channel.get<std::uint32_t>()));
+
+        if (lineSearchAlg > static_cast<std::uint32_t>(
+                LineSearchAlg::Adaptive)) {
+            throw std::runtime_error("Unknown line search algorithm");
+        }
+        Parameters parameters = m_parameters;
+        readParameters(text, parameters);
+
+        auto evaluate = [&channel](std::uint32_t type,
+                                      const Eigen::MatrixXd &x) {
+            putMatrix(channel, type, x);
+            if (channel.receive() != VALUES) {
+                channel.fail("Unexpected message");
+            }
+            Eigen::MatrixXd values = getMatrix(channel);
+            if (values.cols() != x.cols()) {
+                channel.fail("Wrong number of values");
+            }
+            return values;
+        };
+        RayEs solver(
+            [&evaluate](const Eigen::MatrixXd &x) -> Eigen::VectorXd {
+                const Eigen::MatrixXd f = evaluate(OBJECTIVE, x);
+                if (f.rows() != 1) {
+                    throw std::runtime_error(
+                        "The objective function must return one value "
+                        "per point");
+                }
+                return f.row(0).transpose();
+            },
+            [&evaluate](const Eigen::MatrixXd &x) {
+                return evaluate(CONSTRAINT, x);
+            },
+            lbnds, ubnds, rayOriginInit,
+            static_cast<LineSearchAlg>(lineSearchAlg), parameters);
+        solver.setWorkerPool(m_workerPool);
+        const auto warmStart = m_warmStarts.find(problemKey);
+        if ((flags & WARM_START) && problemKey != 0 &&
+            warmStart != m_warmStarts.end() &&
+            warmStart->second.point.size() == n) {
+            solver.setWarmStart(warmStart->second.point);
+            m_warmStartUses.splice(m_warmStartUses.begin(), m_warmStartUses,
+                                   warmStart->second.use);
+        }
+        if (flags & STREAM_PROGRESS) {
+            solver.setProgressFun([&channel](const RunStatus &status) {
+                channel.begin(PROGRESS);
+                channel.put(static_cast<std::uint32_t>(status.phase));
+                channel.put(static_cast<std::int32_t>(status.generation));
+                channel.put(static_cast<std::int32_t>(
+                    status.numFitnessEvaluations));
+                channel.put(status.sigma);
+                channel.put(status.bestF);
+                channel.put(status.elapsedSeconds);
+                channel.send();
+            });
+        }
+        const Info info = solver.run();
+
+        const Individual best = info.getBestIndividual();
+        if (problemKey != 0 &&
+            best.f() < std::numeric_limits<double>::max()) {
+            keepWarmStart(problemKey, best.bestOnRay());
+        }
+        ++m_numSolves;
+
+        channel.begin(RESULT);
+        channel.put(static_cast<std::uint32_t>(
+            info.getTerminationCriterion()));
+        channel.put(static_cast<std::int32_t>(
+            info.getNumFitnessEvaluations()));
+        channel.put(static_cast<std::int32_t>(info.getNumGenerations()));
+        channel.put(static_cast<std::int32_t>(
+            info.getNumPolishFitnessEvaluations()));
+        putIndividual(channel, best);
+        putIndividual(channel, info.getPolishedIndividual());
+        channel.send();
+    } catch (const std::exception &e) {
+        if (channel.isBroken()) {
+            throw;
+        }
+        // e.g. invalid parameters: the client may send the next request
+        channel.begin(ERROR);
+        channel.putString(e.what());
+        channel.send();
+    }
+}
+
+SolverClient::SolverClient(const std::string &socketPath) {
+    const int fd = connectSocket(socketPath);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot connect to " + socketPath + ": " +
+                                 std::strerror(errno));
+    }
+    m_channel.reset(new MessageChannel(fd));
+}
+
+SolverClient::~SolverClient() {
+}
+
+Info SolverClient::solve(
+        const SolveRequest &request,
+        const BatchObjectiveFun &batchObjectiveFun,
+        const BatchConstraintFun &batchConstraintFun,
+        const std::function<void(const RunStatus &)> &progressFun) {
+    MessageChannel &channel = *m_channel;
+    if (channel.isBroken()) {
+        throw std::runtime_error("The connection to the daemon is broken");
+    }
+    const Eigen::Index n = request.lbnds.size();
+    if (request.ubnds.size() != n || request.rayOriginInit.size() != n) {
+        throw std::runtime_error("SolveRequest: dimensions do not match");
+    }
+    channel.begin(SOLVE);
+    channel.put(static_cast<std::uint32_t>(n));
+    channel.put(static_cast<std::uint32_t>(request.lineSearchAlg));
+    channel.put(request.problemKey);
+    channel.put((request.warmStart ? WARM_START : 0) |
+                (request.progress ? STREAM_PROGRESS : 0));
+    channel.put(request.lbnds.data(), static_cast<std::size_t>(n));
+    channel.put(request.ubnds.data(), static_cast<std::size_t>(n));
+    channel.put(request.rayOriginInit.data(), static_cast<std::size_t>(n));
+    channel.put(static_cast<std::uint32_t>(request.parameters.size()));
+    channel.putString(request.parameters);
+    channel.send();
+
+    for (;;) {
+        const std::uint32_t type = channel.receive();
+        if (type == OBJECTIVE || type == CONSTRAINT) {
+            const Eigen::MatrixXd x = getMatrix(channel);
+            Eigen::MatrixXd values;
+            try {
+                if (type == OBJECTIVE) {
+                    values = batchObjectiveFun(x).transpose();
+                } else {
+                    values = batchConstraintFun(x);
+                }
+            } catch (...) {
+                // the daemon waits for the values; ending the connection
+                // ends the solve
+                channel.abandon();
+                throw;
+            }
+            putMatrix(channel, VALUES, values);
+        } else if (type == PROGRESS) {
+            RunStatus status;
+            const std::uint32_t phase = channel.get<std::uint32_t>();
+            if (phase > static_cast<std::uint32_t>(RunPhase::Finished)) {
+                channel.fail("Unknown run phase");
+            }
+            status.phase = static_cast<RunPhase>(phase);
+            status.generation = channel.get<std::int32_t>();
+            status.numFitnessEvaluations = channel.get<std::int32_t>();
+            status.sigma = channel.get<double>();
+            status.bestF = channel.get<double>();
+            status.elapsedSeconds = channel.get<double>();
+            status.fitnessEvaluationsPerSecond = status.elapsedSeconds > 0.0 ?
+                status.numFitnessEvaluations / status.elapsedSeconds : 0.0;
+            if (progressFun) {
+                progressFun(status);
+            }
+        } else if (type == RESULT) {
+            Info info;
+            const std::uint32_t criterion = channel.get<std::uint32_t>();
+            if (criterion > static_cast<std::uint32_t>(
+                    TerminationCriterion::LocalPolishTriggered)) {
+                channel.fail("Unknown termination criterion");
+            }
+            info.setTerminationCriterion(
+                static_cast<TerminationCriterion>(criterion));
+            info.setNumFitnessEvaluations(channel.get<std::int32_t>());
+            info.setNumGenerations(channel.get<std::int32_t>());
+            info.setNumPolishFitnessEvaluations(channel.get<std::int32_t>());
+            info.setBestIndividual(getIndividual(channel));
+            info.setPolishedIndividual(getIndividual(channel));
+            return info;
+        } else if (type == ERROR) {
+            throw std::runtime_error("Daemon: " + channel.getRest());
+        } else {
+            channel.fail("Unexpected message");
+        }
+    }
+}
+
+void SolverClient::shutdown() {
+    m_channel->begin(SHUTDOWN);
+    m_channel->send();
+}
+
+}
+}
@@ -16,16 +16,28 @@ std::ostream &operator<<(std::ostream &os,
     } else if (TerminationCriterion::BestSoFarNotUpdatedTooLong ==
                terminationCriterion) {
         os << "BestSoFarNotUpdatedTooLong";
+    } else if (TerminationCriterion::LocalPolishTriggered ==
+               terminationCriterion) {
+        os << "LocalPolishTriggered";
     } else {
         throw std::runtime_error("Unknown termination criterion");
     }
     return os;
 }
 
+LineSearchStatistics::LineSearchStatistics()
+    : numSelections(0)
+    , numFitnessEvaluations(0)
+    , numSavedFitnessEvaluations(0)
+    , improvement(0.0)
+{
+}
+
 Info::Info()
     : m_terminationCriterion()
     , m_numFitnessEvaluations(0)
     , m_numGenerations(0)
+    , m_numPolishFitnessEvaluations(0)
 {
 }
 
@@ -62,5 +74,82 @@ void Info::setBestIndividual(const Individual &bestIndividual) {
     m_bestIndividual = bestIndividual;
 }
 
+int Info::getNumPolishFitnessEvaluations() const {
+    return m_numPolishFitnessEvaluations;
+}
+
+void Info::setNumPolishFitnessEvaluations(int numPolishFitnessEvaluations) {
+    m_numPolishFitnessEvaluations = numPolishFitnessEvaluations;
+}
+
+Individual Info::getPolishedIndividual() const {
+    return m_polishedIndividual;
+}
+
+void Info::setPolishedIndividual(const Individual &polishedIndividual) {
+    m_polishedIndividual = polishedIndividual;
+}
+
+std::vector<int> Info::getLambdaHistory() const {
+    return m_lambdaHistory;
+}
+
+void Info::setLambdaHistory(const std::vector<int> &lambdaHistory) {
+    m_lambdaHistory = lambdaHistory;
+}
+
+std::map<LineSearchAlg, LineSearchStatistics>
+Info::getLineSearchStatistics() const {
+    return m_lineSearchStatistics;
+}
+
+void Info::setLineSearchStatistics(const std::map<LineSearchAlg,
+                                   LineSearchStatistics>
+                                   &lineSearchStatistics) {
+    m_lineSearchStatistics = lineSearchStatistics;
+}
+
+const std::shared_ptr<const es::core::LatencyHistogram> &
+Info::getObjectiveLatencies() const {
+    return m_objectiveLatencies;
+}
+
+void Info::setObjectiveLatencies(
+        const std::shared_ptr<const es::core::LatencyHistogram> &latencies) {
+    m_objectiveLatencies = latencies;
+}
+
+const std::shared_ptr<const es::core::LatencyHistogram> &
+Info::getConstraintLatencies() const {
+    return m_constraintLatencies;
+}
+
+void Info::setConstraintLatencies(
+        const std::shared_ptr<const es::core::LatencyHistogram> &latencies) {
+    m_constraintLatencies = latencies;
+}
+
+const std::shared_ptr<const es::core::LatencyHistogram> &
+Info::getLineSearchLatencies() const {
+    return m_lineSearchLatencies;
+}
+
+void Info::setLineSearchLatencies(
+        const std::shared_ptr<const es::core::LatencyHistogram> &latencies) {
+    m_lineSearchLatencies = latencies;
+}
+
+void writeLatencies(std::ostream &os, const Info &info) {
+    if (!info.getObjectiveLatencies()) {
+        return;
+    }
+    os << "# objective\n";
+    info.getObjectiveLatencies()->write(os);
+    os << "# constraint\n";
+    info.getConstraintLatencies()->write(os);
+    os << "# lineSearch\n";
+    info.getLineSearchLatencies()->write(os);
+}
+
 }
 }
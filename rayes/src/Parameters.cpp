@@ -0,0 +1,351 @@
+#include "es/rayes/Parameters.h"
+
+#include "es/core/util.h"
+
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+namespace es {
+namespace rayes {
+
+std::ostream &operator<<(std::ostream &os, LineSearchAlg lineSearchAlg) {
+    if (LineSearchAlg::Standard == lineSearchAlg) {
+        os << "Standard";
+    } else if (LineSearchAlg::Modified == lineSearchAlg) {
+        os << "Modified";
+    } else if (LineSearchAlg::Adaptive == lineSearchAlg) {
+        os << "Adaptive";
+    } else {
+        throw std::runtime_error("Unknown line search algorithm");
+    }
+    return os;
+}
+
+std::ostream &operator<<(std::ostream &os,
+                         LineSearchSelection lineSearchSelection) {
+    if (LineSearchSelection::PerOffspring == lineSearchSelection) {
+        os << "PerOffspring";
+    } else if (LineSearchSelection::PerGeneration == lineSearchSelection) {
+        os << "PerGeneration";
+    } else {
+        throw std::runtime_error("Unknown line search selection");
+    }
+    return os;
+}
+
+std::ostream &operator<<(std::ostream &os, BoundHandling boundHandling) {
+    if (BoundHandling::Reject == boundHandling) {
+        os << "Reject";
+    } else if (BoundHandling::Clip == boundHandling) {
+        os << "Clip";
+    } else if (BoundHandling::Project == boundHandling) {
+        os << "Project";
+    } else if (BoundHandling::Reflect == boundHandling) {
+        os << "Reflect";
+    } else {
+        throw std::runtime_error("Unknown bound handling");
+    }
+    return os;
+}
+
+std::ostream &operator<<(std::ostream &os,
+                         MutationSampling mutationSampling) {
+    if (MutationSampling::Gaussian == mutationSampling) {
+        os << "Gaussian";
+    } else if (MutationSampling::Mirrored == mutationSampling) {
+        os << "Mirrored";
+    } else if (MutationSampling::Orthogonal == mutationSampling) {
+        os << "Orthogonal";
+    } else if (MutationSampling::Sobol == mutationSampling) {
+        os << "Sobol";
+    } else if (MutationSampling::Subspace == mutationSampling) {
+        os << "Subspace";
+    } else if (MutationSampling::CoordinateBlocks == mutationSampling) {
+        os << "CoordinateBlocks";
+    } else {
+        throw std::runtime_error("Unknown mutation sampling");
+    }
+    return os;
+}
+
+std::ostream &operator<<(std::ostream &os, Precision precision) {
+    if (Precision::Double == precision) {
+        os << "Double";
+    } else if (Precision::Mixed == precision) {
+        os << "Mixed";
+    } else {
+        throw std::runtime_error("Unknown precision");
+    }
+    return os;
+}
+
+std::ostream &operator<<(std::ostream &os,
+                         PopulationSizeControl populationSizeControl) {
+    if (PopulationSizeControl::Fixed == populationSizeControl) {
+        os << "Fixed";
+    } else if (PopulationSizeControl::Adaptive == populationSizeControl) {
+        os << "Adaptive";
+    } else {
+        throw std::runtime_error("Unknown population size control");
+    }
+    return os;
+}
+
+Parameters::Parameters()
+    : lambdaPerDimension(4)
+    , selectionRatio(0.25)
+    , tauFactor(1.0)
+    , gLagPerDimension(50)
+    , lineSearchPartitions(2)
+    , lineSearchRefinementPartitions(0)
+    , lineSearchEpsilon(1e-10)
+    , lineSearchStepSizeIncreaseFactor(1.5)
+    , lineSearchStepSizeDecreaseFactor(10.0)
+    , planeSearchRatio(0.0)
+    , planeSearchMaxFitnessEvaluations(20)
+    , boundHandling(BoundHandling::Reject)
+    , mutationSampling(MutationSampling::Gaussian)
+    , subspaceDimension(0)
+    , subspaceResampling(10)
+    , precision(Precision::Double)
+    , populationSizeControl(PopulationSizeControl::Fixed)
+    , lambdaMin(0)
+    , lambdaMax(0)
+    , lambdaChangeFactor(1.2)
+    , targetSuccessRate(0.2)
+    , successRateSmoothing(0.2)
+    , lineSearchSelection(LineSearchSelection::PerOffspring)
+    , banditExploration(0.5)
+    , banditDiscount(0.9)
+    , localPolish(false)
+    , polishSigma(1e-4)
+    , polishStagnation(0)
+    , polishMaxFitnessEvaluations(0)
+    , polishActiveTolerance(1e-6)
+    , numThreads(1)
+    , pinThreads(false)
+    , recordLatencies(false)
+    , seed(0)
+    , publishStatus(false)
+    , statusLabel()
+{
+}
+
+namespace {
+
+// Calls visitor(name, member) for every parameter such that writing and
+// reading share the list of names.
+template<typename P, typename Visitor>
+void visitParameters(P &parameters, Visitor &visitor) {
+    visitor("lambdaPerDimension", parameters.lambdaPerDimension);
+    visitor("selectionRatio", parameters.selectionRatio);
+    visitor("tauFactor", parameters.tauFactor);
+    visitor("gLagPerDimension", parameters.gLagPerDimension);
+    visitor("lineSearchPartitions", parameters.lineSearchPartitions);
+    visitor("lineSearchRefinementPartitions",
+            parameters.lineSearchRefinementPartitions);
+    visitor("lineSearchEpsilon", parameters.lineSearchEpsilon);
+    visitor("lineSearchStepSizeIncreaseFactor",
+            parameters.lineSearchStepSizeIncreaseFactor);
+    visitor("lineSearchStepSizeDecreaseFactor",
+            parameters.lineSearchStepSizeDecreaseFactor);
+    visitor("planeSearchRatio", parameters.planeSearchRatio);
+    visitor("planeSearchMaxFitnessEvaluations",
+            parameters.planeSearchMaxFitnessEvaluations);
+    visitor("boundHandling", parameters.boundHandling);
+    visitor("mutationSampling", parameters.mutationSampling);
+    visitor("subspaceDimension", parameters.subspaceDimension);
+    visitor("subspaceResampling", parameters.subspaceResampling);
+    visitor("precision", parameters.precision);
+    visitor("populationSizeControl", parameters.populationSizeControl);
+    visitor("lambdaMin", parameters.lambdaMin);
+    visitor("lambdaMax", parameters.lambdaMax);
+    visitor("lambdaChangeFactor", parameters.lambdaChangeFactor);
+    visitor("targetSuccessRate", parameters.targetSuccessRate);
+    visitor("successRateSmoothing", parameters.successRateSmoothing);
+    visitor("lineSearchSelection", parameters.lineSearchSelection);
+    visitor("banditExploration", parameters.banditExploration);
+    visitor("banditDiscount", parameters.banditDiscount);
+    visitor("localPolish", parameters.localPolish);
+    visitor("polishSigma", parameters.polishSigma);
+    visitor("polishStagnation", parameters.polishStagnation);
+    visitor("polishMaxFitnessEvaluations",
+            parameters.polishMaxFitnessEvaluations);
+    visitor("polishActiveTolerance", parameters.polishActiveTolerance);
+    visitor("numThreads", parameters.numThreads);
+    visitor("pinThreads", parameters.pinThreads);
+    visitor("recordLatencies", parameters.recordLatencies);
+    visitor("seed", parameters.seed);
+    visitor("publishStatus", parameters.publishStatus);
+    visitor("statusLabel", parameters.statusLabel);
+}
+
+struct ParameterWriter {
+    explicit ParameterWriter(std::ostream &osVal) : os(osVal) {
+    }
+
+    template<typename T>
+    void operator()(const char *name, const T &value) {
+        os << name << " = " << value << "\n";
+    }
+
+    void operator()(const char *name, double value) {
+        const std::streamsize precision =
+            os.precision(std::numeric_limits<double>::max_digits10);
+        os << name << " = " << value << "\n";
+        os.precision(precision);
+    }
+
+    void operator()(const char *name, bool value) {
+        os << name << " = " << (value ? "true" : "false") << "\n";
+    }
+
+    std::ostream &os;
+};
+
+template<typename T>
+bool parseValue(const std::string &text, T &value) {
+    std::istringstream is(text);
+    T parsed;
+    if (!(is >> parsed) || !(is >> std::ws).eof()) {
+        return false;
+    }
+    value = parsed;
+    return true;
+}
+
+// the value of a string is the rest of the line (possibly empty)
+bool parseValue(const std::string &text, std::string &value) {
+    value = text;
+    return true;
+}
+
+bool parseValue(const std::string &text, bool &value) {
+    if (text == "true" || text == "1") {
+        value = true;
+    } else if (text == "false" || text == "0") {
+        value = false;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// enumerations are parsed by comparing with the names written by
+// operator<< of all enumerators
+template<typename E>
+bool parseEnum(const std::string &text, E &value,
+               std::initializer_list<E> enumerators) {
+    for (E enumerator : enumerators) {
+        if (es::core::toString(enumerator) == text) {
+            value = enumerator;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool parseValue(const std::string &text, LineSearchSelection &value) {
+    return parseEnum(text, value, {LineSearchSelection::PerOffspring,
+                                   LineSearchSelection::PerGeneration});
+}
+
+bool parseValue(const std::string &text, BoundHandling &value) {
+    return parseEnum(text, value, {BoundHandling::Reject,
+                                   BoundHandling::Clip,
+                                   BoundHandling::Project,
+                                   BoundHandling::Reflect});
+}
+
+bool parseValue(const std::string &text, MutationSampling &value) {
+    return parseEnum(text, value, {MutationSampling::Gaussian,
+                                   MutationSampling::Mirrored,
+                                   MutationSampling::Orthogonal,
+                                   MutationSampling::Sobol,
+                                   MutationSampling::Subspace,
+                                   MutationSampling::CoordinateBlocks});
+}
+
+bool parseValue(const std::string &text, Precision &value) {
+    return parseEnum(text, value, {Precision::Double, Precision::Mixed});
+}
+
+bool parseValue(const std::string &text, PopulationSizeControl &value) {
+    return parseEnum(text, value, {PopulationSizeControl::Fixed,
+                                   PopulationSizeControl::Adaptive});
+}
+
+struct ParameterReader {
+    ParameterReader(const std::string &nameVal, const std::string &textVal)
+        : name(nameVal)
+        , text(textVal)
+        , found(false) {
+    }
+
+    template<typename T>
+    void operator()(const char *parameterName, T &value) {
+        if (name != parameterName) {
+            return;
+        }
+        found = true;
+        if (!parseValue(text, value)) {
+            throw std::runtime_error("Invalid value of parameter " + name +
+                                     ": " + text);
+        }
+    }
+
+    const std::string &name;
+    const std::string &text;
+    bool found;
+};
+
+std::string trim(const std::string &text) {
+    const std::size_t begin = text.find_first_not_of(" \t\r");
+    if (begin == std::string::npos) {
+        return std::string();
+    }
+    const std::size_t end = text.find_last_not_of(" \t\r");
+    return text.substr(begin, end - begin + 1);
+}
+
+}
+
+void writeParameters(std::ostream &os, const Parameters &parameters) {
+    ParameterWriter writer(os);
+    visitParameters(parameters, writer);
+}
+
+void readParameters(std::istream &is, Parameters &parameters) {
+    std::string line;
+    while (std::getline(is, line)) {
+        line = trim(line);
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        const std::size_t pos = line.find('=');
+        if (pos == std::string::npos) {
+            throw std::runtime_error("Invalid parameter line: " + line);
+        }
+        const std::string name = trim(line.substr(0, pos));
+        const std::string text = trim(line.substr(pos + 1));
+        ParameterReader reader(name, text);
+        visitParameters(parameters, reader);
+        if (!reader.found) {
+            throw std::runtime_error("Unknown parameter: " + name);
+        }
+    }
+}
+
+Parameters loadParameters(const std::string &path) {
+    std::ifstream is(path.c_str());
+    if (!is) {
+        throw std::runtime_error("Cannot read parameter file " + path);
+    }
+    Parameters parameters;
+    readParameters(is, parameters);
+    return parameters;
+}
+
+}
+}
@@ -1,16 +1,411 @@
 #include "es/rayes/RayEs.h"
 #include "es/rayes/Individual.h"
+#include "es/rayes/Status.h"
 
 #include "es/core/util.h"
+#include "es/core/Sobol.h"
+#include "es/core/WorkerPool.h"
 
 #include <iostream>
 #include <vector>
+#include <array>
+#include <map>
+#include <algorithm>
+#include <limits>
+#include <memory>
 #include <cassert>
+#include <chrono>
 #include <cmath>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
 
 namespace es {
 namespace rayes {
 
+namespace {
+
+// Outcome of one line search of a generation.
+struct LineSearchPull {
+    LineSearchPull(LineSearchAlg algVal, int numFitnessEvaluationsVal,
+                   int numSavedFitnessEvaluationsVal, double fVal,
+                   bool feasibleFoundVal)
+        : alg(algVal)
+        , numFitnessEvaluations(numFitnessEvaluationsVal)
+        , numSavedFitnessEvaluations(numSavedFitnessEvaluationsVal)
+        , f(fVal)
+        , feasibleFound(feasibleFoundVal) {
+    }
+
+    LineSearchAlg alg;
+    int numFitnessEvaluations;
+    int numSavedFitnessEvaluations;
+    double f;
+    bool feasibleFound;
+};
+
+// Discounted UCB1 bandit choosing between the standard and the modified
+// line search. The value of an arm is its improvement per fitness
+// evaluation relative to the best arm, such that the choice does not
+// depend on the scale of the objective function.
+class LineSearchBandit {
+ public:
+    LineSearchBandit(double exploration, double discount)
+        : m_exploration(exploration)
+        , m_discount(discount)
+        , m_numSelections({0.0, 0.0})
+        , m_numFitnessEvaluations({0.0, 0.0})
+        , m_improvement({0.0, 0.0}) {
+    }
+
+    LineSearchAlg select() const {
+        double numSelectionsTotal = 0.0;
+        double efficiencyMax = 0.0;
+        for (int i = 0; i < 2; ++i) {
+            if (!(m_numSelections[i] > 0.0)) {
+                return alg(i);
+            }
+            numSelectionsTotal += m_numSelections[i];
+            efficiencyMax = std::max(efficiencyMax, efficiency(i));
+        }
+        int best = 0;
+        double bestScore = -std::numeric_limits<double>::max();
+        for (int i = 0; i < 2; ++i) {
+            const double value = efficiencyMax > 0.0 ?
+                efficiency(i) / efficiencyMax : 0.0;
+            const double score = value + m_exploration *
+                std::sqrt(std::log(std::max(numSelectionsTotal, 1.0)) /
+                          m_numSelections[i]);
+            if (score > bestScore) {
+                bestScore = score;
+                best = i;
+            }
+        }
+        return alg(best);
+    }
+
+    void countSelection(LineSearchAlg lineSearchAlg) {
+        m_numSelections[index(lineSearchAlg)] += 1.0;
+    }
+
+    void reward(LineSearchAlg lineSearchAlg, int numFitnessEvaluations,
+                double improvement) {
+        m_numFitnessEvaluations[index(lineSearchAlg)] +=
+            numFitnessEvaluations;
+        m_improvement[index(lineSearchAlg)] += improvement;
+    }
+
+    // forget old observations such that the choice can follow
+    // the phases of a run
+    void discount() {
+        for (int i = 0; i < 2; ++i) {
+            m_numSelections[i] *= m_discount;
+            m_numFitnessEvaluations[i] *= m_discount;
+            m_improvement[i] *= m_discount;
+        }
+    }
+
+ private:
+    static int index(LineSearchAlg lineSearchAlg) {
+        return lineSearchAlg == LineSearchAlg::Standard ? 0 : 1;
+    }
+
+    static LineSearchAlg alg(int i) {
+        return i == 0 ? LineSearchAlg::Standard : LineSearchAlg::Modified;
+    }
+
+    double efficiency(int i) const {
+        return m_numFitnessEvaluations[i] > 0.0 ?
+            m_improvement[i] / m_numFitnessEvaluations[i] : 0.0;
+    }
+
+    double m_exploration;
+    double m_discount;
+    std::array<double, 2> m_numSelections;
+    std::array<double, 2> m_numFitnessEvaluations;
+    std::array<double, 2> m_improvement;
+};
+
+// records the time from its construction to its destruction in the
+// histogram (if any)
+class LatencyTimer {
+ public:
+    explicit LatencyTimer(es::core::LatencyHistogram *histogram)
+        : m_histogram(histogram) {
+        if (m_histogram) {
+            m_start = std::chrono::steady_clock::now();
+        }
+    }
+
+    ~LatencyTimer() {
+        if (m_histogram) {
+            m_histogram->record(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - m_start).count());
+        }
+    }
+
+    LatencyTimer(const LatencyTimer &) = delete;
+    LatencyTimer &operator=(const LatencyTimer &) = delete;
+
+ private:
+    es::core::LatencyHistogram *m_histogram;
+    std::chrono::steady_clock::time_point m_start;
+};
+
+// the latency histograms of one thread of a run; every thread records into
+// its own ones, which are merged at the end of the run
+struct ThreadLatencies {
+    es::core::LatencyHistogram objective;
+    es::core::LatencyHistogram constraint;
+    es::core::LatencyHistogram lineSearch;
+};
+
+// the histograms the current thread records into (null: not recorded)
+thread_local ThreadLatencies *t_latencies = nullptr;
+
+// sets the histograms of the current thread for its lifetime
+class ThreadLatenciesScope {
+ public:
+    explicit ThreadLatenciesScope(ThreadLatencies *latencies)
+        : m_previous(t_latencies) {
+        t_latencies = latencies;
+    }
+
+    ~ThreadLatenciesScope() {
+        t_latencies = m_previous;
+    }
+
+    ThreadLatenciesScope(const ThreadLatenciesScope &) = delete;
+    ThreadLatenciesScope &operator=(const ThreadLatenciesScope &) = delete;
+
+ private:
+    ThreadLatencies *m_previous;
+};
+
+}
+
+// Runs tasks (the line searches of a generation) on separate workers in
+// lockstep. A task that calls objective() or constraint() waits until every
+// unfinished task waits; then the thread that called run() evaluates all
+// requested points with one call of the batch function per kind, ordered
+// by task, and resumes the tasks.
+class RayEs::LockstepEvaluator {
+ public:
+    LockstepEvaluator(const BatchObjectiveFun &batchObjectiveFun,
+                      const BatchConstraintFun &batchConstraintFun)
+        : m_batchObjectiveFun(batchObjectiveFun)
+        , m_batchConstraintFun(batchConstraintFun)
+        , m_numRunning(0)
+        , m_numWaiting(0)
+        , m_numBatches(0)
+        , m_abort(false)
+        , m_objectiveLatencies(nullptr)
+        , m_constraintLatencies(nullptr) {
+    }
+
+    // histograms of the latencies of the batch calls (null: not recorded)
+    void setLatencies(es::core::LatencyHistogram *objectiveLatencies,
+                      es::core::LatencyHistogram *constraintLatencies) {
+        m_objectiveLatencies = objectiveLatencies;
+        m_constraintLatencies = constraintLatencies;
+    }
+
+    double objective(const Eigen::VectorXd &x) {
+        if (t_evaluator != this) {
+            return evaluateObjective(x)(0);
+        }
+        return request(Kind::Objective, x).f;
+    }
+
+    Eigen::VectorXd constraint(const Eigen::VectorXd &x) {
+        if (t_evaluator != this) {
+            return evaluateConstraint(x).col(0);
+        }
+        return request(Kind::Constraint, x).c;
+    }
+
+    // Calls task(k, worker) for k = 0, ..., numTasks - 1 on the workers of
+    // the pool (one per task, as the tasks block each other) and rethrows
+    // the first exception (of a batch function or of the task with the
+    // smallest k).
+    void run(es::core::WorkerPool &workerPool, int numTasks,
+             const std::function<void(int, int)> &task) {
+        m_requests.assign(numTasks, Request());
+        std::vector<std::exception_ptr> errors(numTasks);
+        std::exception_ptr batchError;
+        m_numRunning = numTasks;
+        m_numWaiting = 0;
+        m_abort = false;
+
+        workerPool.reserveWorkers(numTasks);
+        workerPool.start(numTasks, [this, &task, &errors](int k, int worker) {
+            t_evaluator = this;
+            t_slot = k;
+            try {
+                task(k, worker);
+            } catch (const Aborted &) {
+            } catch (...) {
+                errors[k] = std::current_exception();
+            }
+            t_evaluator = nullptr;
+            std::lock_guard<std::mutex> lock(m_mutex);
+            --m_numRunning;
+            m_coordinator.notify_one();
+        });
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (true) {
+            m_coordinator.wait(lock, [this]() {
+                return m_numRunning == 0 ||
+                    (!m_abort && m_numWaiting == m_numRunning);
+            });
+            if (m_numRunning == 0) {
+                break;
+            }
+            // all unfinished tasks wait and do not touch the requests
+            lock.unlock();
+            try {
+                evaluateRequests();
+            } catch (...) {
+                batchError = std::current_exception();
+            }
+            lock.lock();
+            m_abort = batchError != nullptr;
+            m_numWaiting = 0;
+            ++m_numBatches;
+            m_workers.notify_all();
+        }
+        lock.unlock();
+        workerPool.wait();
+
+        if (batchError) {
+            std::rethrow_exception(batchError);
+        }
+        for (const std::exception_ptr &error : errors) {
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
+    }
+
+ private:
+    enum class Kind { None, Objective, Constraint };
+
+    struct Request {
+        Request()
+            : kind(Kind::None)
+            , x(nullptr)
+            , f(0.0) {
+        }
+
+        Kind kind;
+        const Eigen::VectorXd *x;
+        double f;
+        Eigen::VectorXd c;
+    };
+
+    // Thrown in the waiting tasks if a batch function failed.
+    class Aborted {
+    };
+
+    const Request &request(Kind kind, const Eigen::VectorXd &x) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (m_abort) {
+            throw Aborted();
+        }
+        Request &request = m_requests[t_slot];
+        request.kind = kind;
+        request.x = &x;
+        ++m_numWaiting;
+        const unsigned long numBatches = m_numBatches;
+        m_coordinator.notify_one();
+        m_workers.wait(lock, [this, numBatches]() {
+            return m_numBatches != numBatches;
+        });
+        if (m_abort) {
+            throw Aborted();
+        }
+        return request;
+    }
+
+    void evaluateRequests() {
+        for (Kind kind : {Kind::Objective, Kind::Constraint}) {
+            std::vector<Request *> batch;
+            for (Request &request : m_requests) {
+                if (request.kind == kind) {
+                    batch.push_back(&request);
+                }
+            }
+            if (batch.empty()) {
+                continue;
+            }
+            Eigen::MatrixXd x(batch[0]->x->size(), batch.size());
+            for (std::size_t i = 0; i < batch.size(); ++i) {
+                x.col(i) = *batch[i]->x;
+            }
+            if (kind == Kind::Objective) {
+                const Eigen::VectorXd f = evaluateObjective(x);
+                for (std::size_t i = 0; i < batch.size(); ++i) {
+                    batch[i]->f = f(i);
+                }
+            } else {
+                const Eigen::MatrixXd c = evaluateConstraint(x);
+                for (std::size_t i = 0; i < batch.size(); ++i) {
+                    batch[i]->c = c.col(i);
+                }
+            }
+            for (Request *request : batch) {
+                request->kind = Kind::None;
+            }
+        }
+    }
+
+    Eigen::VectorXd evaluateObjective(const Eigen::MatrixXd &x) const {
+        LatencyTimer timer(m_objectiveLatencies);
+        Eigen::VectorXd f = m_batchObjectiveFun(x);
+        if (f.size() != x.cols()) {
+            throw std::runtime_error(
+                "batch objective function returned a wrong number of values");
+        }
+        return f;
+    }
+
+    Eigen::MatrixXd evaluateConstraint(const Eigen::MatrixXd &x) const {
+        LatencyTimer timer(m_constraintLatencies);
+        Eigen::MatrixXd c = m_batchConstraintFun(x);
+        if (c.cols() != x.cols()) {
+            throw std::runtime_error(
+                "batch constraint function returned a wrong number of "
+                "columns");
+        }
+        return c;
+    }
+
+    BatchObjectiveFun m_batchObjectiveFun;
+    BatchConstraintFun m_batchConstraintFun;
+
+    std::mutex m_mutex;
+    std::condition_variable m_coordinator;
+    std::condition_variable m_workers;
+    std::vector<Request> m_requests;
+    int m_numRunning;
+    int m_numWaiting;
+    unsigned long m_numBatches;
+    bool m_abort;
+    es::core::LatencyHistogram *m_objectiveLatencies;
+    es::core::LatencyHistogram *m_constraintLatencies;
+
+    // the evaluator and the task of a task thread
+    static thread_local LockstepEvaluator *t_evaluator;
+    static thread_local int t_slot;
+};
+
+thread_local RayEs::LockstepEvaluator *RayEs::LockstepEvaluator::t_evaluator =
+    nullptr;
+thread_local int RayEs::LockstepEvaluator::t_slot = -1;
+
 RayEs::RayEs(
        const std::function<double(const Eigen::VectorXd &)> &objectiveFun,
        const std::function<Eigen::VectorXd(
@@ -18,44 +413,256 @@ RayEs::RayEs(
        const Eigen::VectorXd &lbnds,
        const Eigen::VectorXd &ubnds,
        const Eigen::VectorXd &rayOriginInit,
-       const LineSearchAlg lineSearchAlg)
+       const LineSearchAlg lineSearchAlg,
+       const Parameters &parameters)
     : m_objectiveFun(objectiveFun)
     , m_constraintFun(constraintFun)
     , m_lbnds(lbnds)
     , m_ubnds(ubnds)
     , m_rayOriginInit(rayOriginInit)
     , m_lineSearchAlg(lineSearchAlg)
+    , m_parameters(parameters)
+{
+}
+
+RayEs::RayEs(const BatchObjectiveFun &batchObjectiveFun,
+             const BatchConstraintFun &batchConstraintFun,
+             const Eigen::VectorXd &lbnds,
+             const Eigen::VectorXd &ubnds,
+             const Eigen::VectorXd &rayOriginInit,
+             const LineSearchAlg lineSearchAlg,
+             const Parameters &parameters)
+    : m_lockstepEvaluator(std::make_shared<LockstepEvaluator>(
+                              batchObjectiveFun, batchConstraintFun))
+    , m_lbnds(lbnds)
+    , m_ubnds(ubnds)
+    , m_rayOriginInit(rayOriginInit)
+    , m_lineSearchAlg(lineSearchAlg)
+    , m_parameters(parameters)
+{
+    std::shared_ptr<LockstepEvaluator> evaluator = m_lockstepEvaluator;
+    m_objectiveFun = [evaluator](const Eigen::VectorXd &x) {
+        return evaluator->objective(x);
+    };
+    m_constraintFun = [evaluator](const Eigen::VectorXd &x) {
+        return evaluator->constraint(x);
+    };
+}
+
+RayEs::RayEs(const ContextObjectiveFun &contextObjectiveFun,
+             const std::function<Eigen::VectorXd(
+                                const Eigen::VectorXd &)> &constraintFun,
+             const Eigen::VectorXd &lbnds,
+             const Eigen::VectorXd &ubnds,
+             const Eigen::VectorXd &rayOriginInit,
+             const LineSearchAlg lineSearchAlg,
+             const Parameters &parameters)
+    : m_constraintFun(constraintFun)
+    , m_contextObjectiveFun(contextObjectiveFun)
+    , m_nextEvaluationHandle(std::make_shared<std::atomic<long>>(0))
+    , m_lbnds(lbnds)
+    , m_ubnds(ubnds)
+    , m_rayOriginInit(rayOriginInit)
+    , m_lineSearchAlg(lineSearchAlg)
+    , m_parameters(parameters)
 {
+    // evaluations without a neighbor (the initial ray origin)
+    std::shared_ptr<std::atomic<long>> nextHandle = m_nextEvaluationHandle;
+    m_objectiveFun = [contextObjectiveFun, nextHandle](
+            const Eigen::VectorXd &x) {
+        EvaluationContext context;
+        context.handle = (*nextHandle)++;
+        context.neighborHandle = -1;
+        context.neighbor = nullptr;
+        return contextObjectiveFun(x, context);
+    };
 }
 
 Info RayEs::run() {
+    if (m_parameters.precision == Precision::Mixed) {
+        return runWithStorage<float>();
+    } else if (m_parameters.precision == Precision::Double) {
+        return runWithStorage<double>();
+    } else {
+        throw std::runtime_error("unknown precision");
+    }
+}
+
+void RayEs::setWorkerPool(
+        const std::shared_ptr<es::core::WorkerPool> &pool) {
+    m_workerPool = pool;
+}
+
+void RayEs::setProgressFun(
+        const std::function<void(const RunStatus &)> &progressFun) {
+    m_progressFun = progressFun;
+}
+
+Individual RayEs::getBestIndividual() const {
+    return m_bestIndividual;
+}
+
+void RayEs::setWarmStart(const Eigen::VectorXd &point) {
+    if (point.size() != 0 && point.size() != m_rayOriginInit.size()) {
+        throw std::runtime_error("The warm start must have the dimension "
+                                 "of the problem");
+    }
+    m_warmStart = point;
+}
+
+template<typename Scalar>
+Info RayEs::runWithStorage() {
+    typedef Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic>
+        StorageMatrix;
+
     Info info;
+    m_bestIndividual = Individual();
+    m_bestIndividual.f(std::numeric_limits<double>::max());
 
     const int dimension = m_lbnds.rows();
     assert(dimension == m_ubnds.rows());
 
-    const int lambda = 4 * dimension;
-    const int mu = lambda / 4;
+    const bool adaptPopulationSize =
+        m_parameters.populationSizeControl == PopulationSizeControl::Adaptive;
+    const int lambdaFixed = m_parameters.lambdaPerDimension * dimension;
+    const int lambdaMin = !adaptPopulationSize ? lambdaFixed :
+        m_parameters.lambdaMin > 0 ? m_parameters.lambdaMin :
+        std::max(4, dimension);
+    const int lambdaMax = !adaptPopulationSize ? lambdaFixed :
+        m_parameters.lambdaMax > 0 ? m_parameters.lambdaMax :
+        16 * dimension;
+    int lambda = lambdaMin;
+    int mu = std::max(1, static_cast<int>(
+        std::floor(m_parameters.selectionRatio * lambda)));
     const double sigmaInit = 1.0 / sqrt(static_cast<double>(dimension));
-    const double tau = 1 / sqrt(2.0 * static_cast<double>(dimension));
-    const int gLag = 50 * dimension;
+    // the subspace mutations change k coordinates of freedom per offspring,
+    // which sets the learning rate of sigma
+    const bool subspaceMutations =
+        m_parameters.mutationSampling == MutationSampling::Subspace ||
+        m_parameters.mutationSampling == MutationSampling::CoordinateBlocks;
+    const int subspaceDimension = !subspaceMutations ? dimension :
+        m_parameters.subspaceDimension > 0 ?
+        std::min(m_parameters.subspaceDimension, dimension) :
+        static_cast<int>(std::ceil(sqrt(static_cast<double>(dimension))));
+    const double tau = m_parameters.tauFactor /
+        sqrt(2.0 * static_cast<double>(subspaceDimension));
+    const int gLag = m_parameters.gLagPerDimension * dimension;
     const int gStop = 100000;
     const double sigmaStop = 1e-6;
     const double lineSearchLineLength =
         2.0 * std::abs(m_ubnds.maxCoeff() - m_lbnds.minCoeff());
-    const int lineSearchPartitions = 2;
-    const double lineSearchEpsilon = 1e-10;
-    const double lineSearchStepSizeIncreaseFactor = 1.5;
-    const double lineSearchStepSizeDecreaseFactor = 10.0;
+    const int lineSearchPartitions = m_parameters.lineSearchPartitions;
+    const int lineSearchRefinementPartitions =
+        m_parameters.lineSearchRefinementPartitions > 0 ?
+        m_parameters.lineSearchRefinementPartitions :
+        std::max(2, lineSearchPartitions);
+    const double lineSearchEpsilon = m_parameters.lineSearchEpsilon;
+    const double lineSearchStepSizeIncreaseFactor =
+        m_parameters.lineSearchStepSizeIncreaseFactor;
+    const double lineSearchStepSizeDecreaseFactor =
+        m_parameters.lineSearchStepSizeDecreaseFactor;
+    if (!(lambda >= 1)) {
+        throw std::runtime_error("lambda must be positive");
+    }
+    if (!(m_parameters.selectionRatio > 0.0 &&
+          m_parameters.selectionRatio <= 1.0)) {
+        throw std::runtime_error("selectionRatio must be in (0, 1]");
+    }
     if (!(lambda >= mu)) {
         throw std::runtime_error("lambda must be greater or equal to mu");
     }
+    if (!(lineSearchPartitions >= 1)) {
+        throw std::runtime_error("lineSearchPartitions must be positive");
+    }
+    if (!(lineSearchRefinementPartitions >= 2)) {
+        throw std::runtime_error(
+            "lineSearchRefinementPartitions must be 0 or at least 2");
+    }
+    if (!(lineSearchEpsilon > 0.0)) {
+        throw std::runtime_error("lineSearchEpsilon must be positive");
+    }
+    if (!(lineSearchStepSizeIncreaseFactor > 1.0 &&
+          lineSearchStepSizeDecreaseFactor > 1.0)) {
+        throw std::runtime_error(
+            "lineSearchStepSize factors must be greater than 1");
+    }
+    if (!(lambdaMax >= lambdaMin)) {
+        throw std::runtime_error(
+            "lambdaMax must be greater or equal to lambdaMin");
+    }
+    if (adaptPopulationSize && !(m_parameters.lambdaChangeFactor > 1.0)) {
+        throw std::runtime_error("lambdaChangeFactor must be greater than 1");
+    }
+
+    if (!(m_parameters.numThreads >= 1)) {
+        throw std::runtime_error("numThreads must be positive");
+    }
+    if (!(m_parameters.planeSearchRatio >= 0.0 &&
+          m_parameters.planeSearchRatio <= 1.0)) {
+        throw std::runtime_error("planeSearchRatio must be in [0, 1]");
+    }
+    if (!(m_parameters.planeSearchMaxFitnessEvaluations >= 1)) {
+        throw std::runtime_error(
+            "planeSearchMaxFitnessEvaluations must be positive");
+    }
+    if (subspaceMutations && !(m_parameters.subspaceDimension >= 0)) {
+        throw std::runtime_error("subspaceDimension must not be negative");
+    }
+    if (subspaceMutations && !(m_parameters.subspaceResampling >= 1)) {
+        throw std::runtime_error("subspaceResampling must be positive");
+    }
+
+    if (m_parameters.seed != 0) {
+        es::core::seedRandom(m_parameters.seed);
+    }
+
+    // the line searches run on the workers in the parallel modes; the
+    // lockstep evaluation adds workers up to lambda
+    std::shared_ptr<es::core::WorkerPool> workerPool;
+    if (m_lockstepEvaluator || m_parameters.numThreads > 1) {
+        const int numWorkers =
+            m_lockstepEvaluator ? lambda : m_parameters.numThreads;
+        if (m_workerPool) {
+            workerPool = m_workerPool;
+            workerPool->reserveWorkers(numWorkers);
+        } else {
+            workerPool = std::make_shared<es::core::WorkerPool>(
+                numWorkers, m_parameters.pinThreads);
+        }
+    }
+
+    std::unique_ptr<StatusPublisher> statusPublisher;
+    if (m_parameters.publishStatus) {
+        statusPublisher.reset(new StatusPublisher(m_parameters.statusLabel));
+    }
+    const std::chrono::steady_clock::time_point startTime =
+        std::chrono::steady_clock::now();
 
     info.setNumFitnessEvaluations(0);
 
+    // the histograms of the calling thread (first) and of the workers
+    // (worker w records into threadLatencies[w + 1]); the deque keeps them
+    // in place when the pool grows
+    std::deque<ThreadLatencies> threadLatencies;
+    if (m_parameters.recordLatencies) {
+        threadLatencies.resize(1);
+    }
+    ThreadLatenciesScope latenciesScope(
+        threadLatencies.empty() ? nullptr : &threadLatencies.front());
+    if (m_lockstepEvaluator) {
+        m_lockstepEvaluator->setLatencies(
+            t_latencies ? &t_latencies->objective : nullptr,
+            t_latencies ? &t_latencies->constraint : nullptr);
+    }
+    auto workerLatencies = [&threadLatencies](int worker) {
+        return threadLatencies.empty() ? nullptr :
+            &threadLatencies[worker + 1];
+    };
+
     auto fEvalHelper = [&info, this](const Eigen::VectorXd &x) {
         info.setNumFitnessEvaluations(info.getNumFitnessEvaluations() + 1);
-        return m_objectiveFun(x);
+        long handle = -1;
+        return evaluate(x, -1, nullptr, handle);
     };
 
     auto isFirstFitterThanSecond = [](const Individual &a,
@@ -70,13 +677,25 @@ Info RayEs::run() {
     if (std::abs(rayInitNorm) > 1e-6) {
         rayInit /= std::abs(rayInitNorm);
     }
+    const bool warmStart = m_warmStart.size() == dimension &&
+        (m_warmStart - m_rayOriginInit).norm() > 1e-6;
+    if (warmStart) {
+        // the ray is close already
+        rayInit = (m_warmStart - m_rayOriginInit).normalized();
+        sigma = 0.1 * sigmaInit;
+    }
     Eigen::VectorXd ray = rayInit;
     Eigen::VectorXd rayOrigin = m_rayOriginInit;
     Eigen::VectorXd bestOnRayPrev = rayOrigin;
 
+    // the line searches start at the origin; they take over its
+    // feasibility, f and handle
+    const bool isRayOriginFeasible = isFeasible(rayOrigin);
+    long rayOriginHandle = -1;
     Individual a;
-    if (isFeasible(rayOrigin)) {
-        a.f(fEvalHelper(rayOrigin));
+    if (isRayOriginFeasible) {
+        info.setNumFitnessEvaluations(info.getNumFitnessEvaluations() + 1);
+        a.f(evaluate(rayOrigin, -1, nullptr, rayOriginHandle));
     } else {
         a.f(std::numeric_limits<double>::max());
     }
@@ -86,97 +705,355 @@ Info RayEs::run() {
     a.rayOrigin(rayOrigin);
     a.sigmaRayOrigin(sigmaRayOrigin);
 
-    Individual aBest = a;
+    // kept in the solver, such that it is available if a problem function
+    // leaves run() by an exception
+    Individual &aBest = m_bestIndividual;
+    aBest = a;
+    if (warmStart && isFeasible(m_warmStart)) {
+        const double f = fEvalHelper(m_warmStart);
+        if (f < aBest.f()) {
+            aBest.f(f);
+            aBest.ray(rayInit);
+            aBest.bestOnRay(m_warmStart);
+            bestOnRayPrev = m_warmStart;
+        }
+    }
     int aBestG = 0;
+    // handle of the evaluation of the best point (warm-start hint of the
+    // local polish)
+    long aBestHandle = -1;
 
     std::set<int> bestDirections({-1, 1});
 
     // create a wrapper function for the line search depending on the type
-    // configured in the constructor
+    // configured in the constructor (or chosen by the bandit)
     auto lineSearchFunction =
-        [&]() -> std::function<LineSearchResult(const Individual &individual)> {
-        if (m_lineSearchAlg == LineSearchAlg::Standard) {
-            return [&](const Individual &individual) -> LineSearchResult {
-                return lineSearch(individual.rayNormalized(),
-                                  lineSearchLineLength,
-                                  lineSearchPartitions,
-                                  m_rayOriginInit,
-                                  lineSearchEpsilon);
-            };
-        } else if (m_lineSearchAlg == LineSearchAlg::Modified) {
-            return [&](const Individual &individual) -> LineSearchResult {
-                LineSearchResult lineSearchResult;
-                // yields 1 for ray in same direction
-                // and 0 for ray in orthogonal direction
-                const double similarityByDotProduct =
-                    std::abs(individual.ray().dot(ray));
-                // if parent and offspring have almost the same direction...
-                if (std::abs(similarityByDotProduct - 1.0) < 1e-3) {
-                    // ... take the parental bestOnRay point as a good initial
-                    // guess and search around this one
-                    // for this, project the parental bestOnRay point onto
-                    // the current ray and compute the step size and a new
-                    // origin
-                    Eigen::VectorXd bestOnRayPrevProjectedOntoOffspringRay =
-                        m_rayOriginInit +
-                        individual.ray() *
-                        (bestOnRayPrev -
-                         m_rayOriginInit).dot(individual.ray());
-                    Eigen::VectorXd originToUse = m_rayOriginInit;
-                    if (bestDirections.size() == 1) {
-                        // origin is slightly in opposite direction of search
-                        // direction to include possible improvements
-                        // missed in previous iterations due to the step size
-                        const int d = *bestDirections.begin();
-                        originToUse =
-                            bestOnRayPrevProjectedOntoOffspringRay -
-                            d * 1e-1 * individual.ray();
-                    }
-                    const double stepSizeGuess =
-                        (bestOnRayPrevProjectedOntoOffspringRay -
-                         originToUse)
-                        .norm() / (individual.ray().norm());
-                    lineSearchResult =
-                        lineSearch2(individual.rayNormalized(),
-                                    originToUse,
-                                    stepSizeGuess,
-                                    lineSearchStepSizeIncreaseFactor,
-                                    lineSearchStepSizeDecreaseFactor,
-                                    lineSearchEpsilon,
-                                    bestDirections);
-                } else {
-                    lineSearchResult =
-                    lineSearch2(individual.rayNormalized(),
-                                m_rayOriginInit,
-                                lineSearchLineLength,
+        [&](LineSearchAlg alg,
+            const Eigen::VectorXd &offspringRay) -> LineSearchResult {
+        if (alg == LineSearchAlg::Standard) {
+            return lineSearch(offspringRay.normalized(),
+                              lineSearchLineLength,
+                              lineSearchPartitions,
+                              lineSearchRefinementPartitions,
+                              m_rayOriginInit,
+                              isRayOriginFeasible,
+                              a.f(),
+                              rayOriginHandle,
+                              lineSearchEpsilon);
+        } else if (alg == LineSearchAlg::Modified) {
+            LineSearchResult lineSearchResult;
+            // yields 1 for ray in same direction
+            // and 0 for ray in orthogonal direction
+            const double similarityByDotProduct =
+                std::abs(offspringRay.dot(ray));
+            // if parent and offspring have almost the same direction...
+            if (std::abs(similarityByDotProduct - 1.0) < 1e-3) {
+                // ... take the parental bestOnRay point as a good initial
+                // guess and search around this one
+                // for this, project the parental bestOnRay point onto
+                // the current ray and compute the step size and a new
+                // origin
+                Eigen::VectorXd bestOnRayPrevProjectedOntoOffspringRay =
+                    m_rayOriginInit +
+                    offspringRay *
+                    (bestOnRayPrev -
+                     m_rayOriginInit).dot(offspringRay);
+                Eigen::VectorXd originToUse = m_rayOriginInit;
+                if (bestDirections.size() == 1) {
+                    // origin is slightly in opposite direction of search
+                    // direction to include possible improvements
+                    // missed in previous iterations due to the step size
+                    const int d = *bestDirections.begin();
+                    originToUse =
+                        bestOnRayPrevProjectedOntoOffspringRay -
+                        d * 1e-1 * offspringRay;
+                }
+                const double stepSizeGuess =
+                    (bestOnRayPrevProjectedOntoOffspringRay -
+                     originToUse)
+                    .norm() / (offspringRay.norm());
+                lineSearchResult =
+                    lineSearch2(offspringRay.normalized(),
+                                originToUse,
+                                stepSizeGuess,
                                 lineSearchStepSizeIncreaseFactor,
                                 lineSearchStepSizeDecreaseFactor,
                                 lineSearchEpsilon,
                                 bestDirections);
-                }
-                return lineSearchResult;
-            };
+            } else {
+                lineSearchResult =
+                lineSearch2(offspringRay.normalized(),
+                            m_rayOriginInit,
+                            lineSearchLineLength,
+                            lineSearchStepSizeIncreaseFactor,
+                            lineSearchStepSizeDecreaseFactor,
+                            lineSearchEpsilon,
+                            bestDirections);
+            }
+            return lineSearchResult;
         } else {
             throw std::runtime_error("unknown line search algorithm type");
         }
-    }();
+    };
+
+    const bool selectLineSearch = m_lineSearchAlg == LineSearchAlg::Adaptive;
+    const bool selectPerGeneration = m_parameters.lineSearchSelection ==
+        LineSearchSelection::PerGeneration;
+    LineSearchBandit bandit(m_parameters.banditExploration,
+                            m_parameters.banditDiscount);
+    std::map<LineSearchAlg, LineSearchStatistics> lineSearchStatistics;
+    std::vector<LineSearchPull> pulls;
+    pulls.reserve(lambdaMax);
+    // f of the worst selected offspring of the previous generation;
+    // improvements of the line searches are measured against it
+    double fSelectionPrev = a.f();
+
+    std::unique_ptr<es::core::Sobol> sobol;
+    if (m_parameters.mutationSampling == MutationSampling::Sobol) {
+        sobol.reset(new es::core::Sobol(dimension, true));
+    }
+
+    // basis of the Subspace mutations: coordinate i has the weight
+    // subspaceWeights(i) in basis vector subspaceIndices[i]; the weights
+    // are the random signs scaled by sqrt(dimension / (k * |support|))
+    std::vector<int> subspaceIndices;
+    Eigen::VectorXd subspaceWeights;
+    Eigen::MatrixXd subspaceCoefficients;
+    if (subspaceMutations) {
+        subspaceIndices.resize(dimension);
+        subspaceWeights.resize(dimension);
+        subspaceCoefficients.resize(subspaceDimension, lambdaMax);
+    }
+    auto sampleSubspace = [&]() {
+        const Eigen::MatrixXd u = es::core::rand(dimension, 2, 0.0, 1.0);
+        std::vector<int> supportSizes(subspaceDimension, 0);
+        for (int i = 0; i < dimension; ++i) {
+            subspaceIndices[i] = std::min(subspaceDimension - 1,
+                static_cast<int>(u(i, 0) * subspaceDimension));
+            ++supportSizes[subspaceIndices[i]];
+        }
+        for (int i = 0; i < dimension; ++i) {
+            subspaceWeights(i) = (u(i, 1) < 0.5 ? -1.0 : 1.0) * sqrt(
+                static_cast<double>(dimension) /
+                (static_cast<double>(subspaceDimension) *
+                 supportSizes[subspaceIndices[i]]));
+        }
+    };
+
+    // the buffers are sized for the largest population such that
+    // changing lambda does not reallocate them; the mutation vectors and
+    // the offspring rays are kept in the storage precision
+    StorageMatrix mutations(dimension, lambdaMax);
+    StorageMatrix offspringRays(dimension, lambdaMax);
+    Eigen::VectorXd sigmas(lambdaMax);
+    // indices of the feasible offspring, sorted by f after the line searches
+    std::vector<int> offspring;
+    offspring.reserve(lambdaMax);
+    std::vector<Individual> candidates;
+    candidates.reserve(lambdaMax);
+    std::vector<LineSearchAlg> algs;
+    algs.reserve(lambdaMax);
+    std::vector<LineSearchResult> lineSearchResults;
+    lineSearchResults.reserve(lambdaMax);
 
+    // creates the mutation vectors (first lambda columns of mutations) and
+    // the mutated sigmas of all offspring of generation g at once
+    auto sampleMutations = [&](int g) {
+        sigmas.head(lambda) = sigma *
+            (tau * es::core::randn(lambda, 1)).array().exp().matrix();
+        if (m_parameters.mutationSampling == MutationSampling::Gaussian) {
+            es::core::randn(mutations.leftCols(lambda));
+        } else if (m_parameters.mutationSampling ==
+                   MutationSampling::Mirrored) {
+            es::core::randn(mutations.leftCols(lambda));
+            for (int k = 1; k < lambda; k += 2) {
+                mutations.col(k) = -mutations.col(k - 1);
+                sigmas(k) = sigmas(k - 1);
+            }
+        } else if (m_parameters.mutationSampling ==
+                   MutationSampling::Orthogonal) {
+            for (int start = 0; start < lambda; start += dimension) {
+                const int blockSize = std::min(dimension, lambda - start);
+                const Eigen::MatrixXd gaussian =
+                    es::core::randn(dimension, blockSize);
+                Eigen::HouseholderQR<Eigen::MatrixXd> qr(gaussian);
+                const Eigen::MatrixXd q = qr.householderQ() *
+                    Eigen::MatrixXd::Identity(dimension, blockSize);
+                // keep the (chi distributed) lengths of the Gaussian vectors
+                mutations.middleCols(start, blockSize) =
+                    (q * gaussian.colwise().norm().asDiagonal())
+                    .template cast<Scalar>();
+            }
+        } else if (m_parameters.mutationSampling ==
+                   MutationSampling::Sobol) {
+            mutations.leftCols(lambda) = sobol->next(lambda).unaryExpr(
+                [](double u) { return es::core::normInv(u); })
+                .template cast<Scalar>();
+        } else if (m_parameters.mutationSampling ==
+                   MutationSampling::Subspace) {
+            if (g % m_parameters.subspaceResampling == 0) {
+                sampleSubspace();
+            }
+            es::core::randn(subspaceCoefficients.leftCols(lambda));
+            for (int k = 0; k < lambda; ++k) {
+                for (int i = 0; i < dimension; ++i) {
+                    mutations(i, k) = static_cast<Scalar>(
+                        subspaceWeights(i) *
+                        subspaceCoefficients(subspaceIndices[i], k));
+                }
+            }
+        } else if (m_parameters.mutationSampling ==
+                   MutationSampling::CoordinateBlocks) {
+            es::core::randn(subspaceCoefficients.leftCols(lambda));
+            const Eigen::MatrixXd starts =
+                es::core::rand(lambda, 1, 0.0, dimension);
+            const double scale = sqrt(static_cast<double>(dimension) /
+                                      subspaceDimension);
+            mutations.leftCols(lambda).setZero();
+            for (int k = 0; k < lambda; ++k) {
+                const int start = std::min(dimension - 1,
+                                           static_cast<int>(starts(k)));
+                for (int j = 0; j < subspaceDimension; ++j) {
+                    mutations((start + j) % dimension, k) =
+                        static_cast<Scalar>(scale *
+                                            subspaceCoefficients(j, k));
+                }
+            }
+        } else {
+            throw std::runtime_error("unknown mutation sampling");
+        }
+    };
+
+    const int polishStagnation = m_parameters.polishStagnation > 0 ?
+        m_parameters.polishStagnation : 5 * dimension;
+    bool polishTriggered = false;
+    double successRate = m_parameters.targetSuccessRate;
+    std::vector<int> lambdaHistory;
     int g = 0;
+
+    // publishes the progress once per generation, which is negligible
+    // compared to the line searches
+    auto publishStatus = [&](RunPhase phase) {
+        if (!statusPublisher && !m_progressFun) {
+            return;
+        }
+        RunStatus status;
+        status.phase = phase;
+        status.generation = g;
+        status.sigma = sigma;
+        status.bestF = aBest.f();
+        status.numFitnessEvaluations = info.getNumFitnessEvaluations();
+        status.elapsedSeconds = std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - startTime).count();
+        status.fitnessEvaluationsPerSecond = status.elapsedSeconds > 0.0 ?
+            status.numFitnessEvaluations / status.elapsedSeconds : 0.0;
+        if (statusPublisher) {
+            statusPublisher->publish(status);
+        }
+        if (m_progressFun) {
+            m_progressFun(status);
+        }
+    };
+
     do {
         // std::cout << "g: " << g << "\n";
         // std::cout << "sigma: " << sigma << "\n";
         // std::cout << "f: " << aBest.f() << "\n";
 
-        std::vector<Individual> offspring;
+        sampleMutations(g);
+
+        offspring.clear();
+        pulls.clear();
+        bool bestImproved = false;
+        LineSearchAlg generationAlg = m_lineSearchAlg;
+        if (selectLineSearch && selectPerGeneration) {
+            generationAlg = bandit.select();
+            bandit.countSelection(generationAlg);
+        }
+        candidates.clear();
+        algs.clear();
         for (int k = 0; k < lambda; ++k) {
             Individual currOffspring;
-            currOffspring.sigma(sigma *
-                                std::exp(tau * es::core::randn(1, 1)(0)));
-            currOffspring.ray(ray + currOffspring.sigma() *
-                              es::core::randn(dimension, 1));
-            currOffspring.ray(currOffspring.rayNormalized());
-            LineSearchResult lineSearchResult =
-                lineSearchFunction(currOffspring);
+            currOffspring.sigma(sigmas(k));
+            offspringRays.col(k) = (ray + currOffspring.sigma() *
+                mutations.col(k).template cast<double>()).normalized()
+                .template cast<Scalar>();
+            LineSearchAlg alg = generationAlg;
+            if (selectLineSearch && !selectPerGeneration) {
+                alg = bandit.select();
+                bandit.countSelection(alg);
+            }
+            candidates.push_back(currOffspring);
+            algs.push_back(alg);
+        }
+        // the line searches only read the state of the generation (and
+        // the plane searches write the ray of their own offspring)
+        lineSearchResults.resize(lambda);
+        const int numPlaneSearches = static_cast<int>(
+            std::round(m_parameters.planeSearchRatio * lambda));
+        auto lineSearchTask = [&](int k) {
+            LatencyTimer timer(t_latencies ? &t_latencies->lineSearch :
+                               nullptr);
+            const Eigen::VectorXd offspringRay =
+                offspringRays.col(k).template cast<double>();
+            lineSearchResults[k] = lineSearchFunction(algs[k], offspringRay);
+            if (k >= numPlaneSearches) {
+                return;
+            }
+            LineSearchResult &lineSearchResult = lineSearchResults[k];
+            const Eigen::VectorXd bestOnRay = lineSearchResult.bestOnRay;
+            // the initial step size is the scale of the ray mutation at the
+            // distance of the best point on the ray from the origin
+            lineSearchResult = planeSearch(lineSearchResult, offspringRay,
+                ray, std::max(sigma *
+                              (bestOnRay - m_rayOriginInit).norm(),
+                              lineSearchEpsilon),
+                lineSearchEpsilon,
+                m_parameters.planeSearchMaxFitnessEvaluations);
+            const Eigen::VectorXd offset =
+                lineSearchResult.bestOnRay - m_rayOriginInit;
+            if (lineSearchResult.bestOnRay != bestOnRay &&
+                    offset.norm() > 0.0) {
+                // keep the orientation of the ray for the recombination
+                const int direction =
+                    offset.dot(offspringRay) < 0.0 ? -1 : 1;
+                const Eigen::VectorXd planeRay =
+                    direction * offset.normalized();
+                offspringRays.col(k) = planeRay.template cast<Scalar>();
+                lineSearchResult.bestOnRayDirection = direction;
+                // the sigma of the offspring is the one that yields the
+                // turned ray (mutations have the expected length
+                // sqrt(dimension)) such that the selection adapts sigma
+                candidates[k].sigma((planeRay - ray).norm() /
+                                    sqrt(static_cast<double>(dimension)));
+            }
+        };
+        if (workerPool && !threadLatencies.empty()) {
+            threadLatencies.resize(std::max<std::size_t>(
+                threadLatencies.size(),
+                std::max(lambda, workerPool->getNumWorkers()) + 1));
+        }
+        auto workerTask = [&](int k, int worker) {
+            ThreadLatenciesScope scope(workerLatencies(worker));
+            lineSearchTask(k);
+        };
+        if (m_lockstepEvaluator) {
+            m_lockstepEvaluator->run(*workerPool, lambda, workerTask);
+        } else if (workerPool) {
+            workerPool->run(lambda, workerTask);
+        } else {
+            for (int k = 0; k < lambda; ++k) {
+                lineSearchTask(k);
+            }
+        }
+        for (int k = 0; k < lambda; ++k) {
+            Individual &currOffspring = candidates[k];
+            const LineSearchResult &lineSearchResult = lineSearchResults[k];
+            pulls.push_back(LineSearchPull(algs[k],
+                                    lineSearchResult.numFitnessEvaluations,
+                                    lineSearchResult.numSavedFitnessEvaluations,
+                                    lineSearchResult.f,
+                                    lineSearchResult.feasibleFound));
             info.setNumFitnessEvaluations(info.getNumFitnessEvaluations() +
                                       lineSearchResult.numFitnessEvaluations);
             currOffspring.bestOnRay(lineSearchResult.bestOnRay);
@@ -186,13 +1063,18 @@ Info RayEs::run() {
             if (lineSearchResult.feasibleFound) {
                 if (isFirstFitterThanSecond(currOffspring, aBest)) {
                     aBest = currOffspring;
+                    aBestHandle = lineSearchResult.bestOnRayHandle;
+                    aBest.ray(offspringRays.col(k).template cast<double>());
                     aBestG = g + 1;
+                    bestImproved = true;
                 }
-                offspring.push_back(currOffspring);
+                offspring.push_back(k);
             }
         }
 
-        std::sort(offspring.begin(), offspring.end(), isFirstFitterThanSecond);
+        std::sort(offspring.begin(), offspring.end(), [&](int i, int j) {
+            return isFirstFitterThanSecond(candidates[i], candidates[j]);
+        });
 
         int nFeasible = static_cast<int>(offspring.size());
         int div = std::min(mu, nFeasible);
@@ -202,12 +1084,14 @@ Info RayEs::run() {
             double sigmaCentroid = 0;
             Eigen::VectorXd bestOnRayCentroid =
                 Eigen::MatrixXd::Zero(dimension, 1);
-            if (m_lineSearchAlg == LineSearchAlg::Modified) {
+            if (m_lineSearchAlg != LineSearchAlg::Standard) {
                 bestDirections.clear();
             }
             for (int k = 0; k < div; ++k) {
-                const auto &currOffspring = offspring.at(k);
-                rayCentroid = rayCentroid + weight * currOffspring.ray();
+                const auto &currOffspring = candidates[offspring.at(k)];
+                // accumulated in double precision
+                rayCentroid = rayCentroid + weight *
+                    offspringRays.col(offspring.at(k)).template cast<double>();
                 sigmaCentroid = sigmaCentroid + weight * currOffspring.sigma();
                 bestOnRayCentroid += weight * currOffspring.bestOnRay();
                 if (m_lineSearchAlg == LineSearchAlg::Modified) {
@@ -216,8 +1100,17 @@ Info RayEs::run() {
                         throw std::runtime_error("unexpected direction");
                     }
                     bestDirections.insert(d);
+                } else if (m_lineSearchAlg == LineSearchAlg::Adaptive) {
+                    // the standard line search may end on the origin
+                    const int d = currOffspring.bestOnRayDirection();
+                    if (1 == d || -1 == d) {
+                        bestDirections.insert(d);
+                    }
                 }
             }
+            if (bestDirections.empty()) {
+                bestDirections = {-1, 1};
+            }
             bestOnRayPrev = bestOnRayCentroid;
             ray = rayCentroid;
             double norm = ray.norm();
@@ -227,10 +1120,65 @@ Info RayEs::run() {
             sigma = sigmaCentroid;
         }
 
+        for (const LineSearchPull &pull : pulls) {
+            double improvement = 0.0;
+            if (pull.feasibleFound) {
+                // without a feasible reference, finding a feasible point
+                // counts as unit improvement
+                improvement =
+                    fSelectionPrev == std::numeric_limits<double>::max() ?
+                    1.0 : std::max(0.0, fSelectionPrev - pull.f);
+            }
+            LineSearchStatistics &statistics = lineSearchStatistics[pull.alg];
+            statistics.numSelections += 1;
+            statistics.numFitnessEvaluations += pull.numFitnessEvaluations;
+            statistics.numSavedFitnessEvaluations +=
+                pull.numSavedFitnessEvaluations;
+            statistics.improvement += improvement;
+            if (selectLineSearch) {
+                bandit.reward(pull.alg, pull.numFitnessEvaluations,
+                              improvement);
+            }
+        }
+        if (selectLineSearch) {
+            bandit.discount();
+        }
+        if (nFeasible > 0) {
+            fSelectionPrev = candidates[offspring.at(div - 1)].f();
+        }
+
+        lambdaHistory.push_back(lambda);
+        if (adaptPopulationSize) {
+            // smoothed rate of generations improving the best-so-far:
+            // while progress is made, a smaller population suffices;
+            // otherwise more offspring are needed
+            successRate = (1.0 - m_parameters.successRateSmoothing) *
+                successRate + m_parameters.successRateSmoothing *
+                (bestImproved ? 1.0 : 0.0);
+            if (successRate > m_parameters.targetSuccessRate) {
+                lambda = static_cast<int>(std::floor(
+                    lambda / m_parameters.lambdaChangeFactor));
+            } else {
+                lambda = static_cast<int>(std::ceil(
+                    lambda * m_parameters.lambdaChangeFactor));
+            }
+            lambda = std::min(std::max(lambda, lambdaMin), lambdaMax);
+            mu = std::max(1, static_cast<int>(
+                std::floor(m_parameters.selectionRatio * lambda)));
+        }
+
         g += 1;
-    } while (!(sigma < sigmaStop || g > gStop || g - aBestG >= gLag));
+        publishStatus(RunPhase::Evolving);
+        polishTriggered = m_parameters.localPolish &&
+            (sigma < m_parameters.polishSigma ||
+             g - aBestG >= polishStagnation);
+    } while (!(polishTriggered ||
+               sigma < sigmaStop || g > gStop || g - aBestG >= gLag));
 
-    if (g > gStop) {
+    if (polishTriggered) {
+        info.setTerminationCriterion(
+                     TerminationCriterion::LocalPolishTriggered);
+    } else if (g > gStop) {
         info.setTerminationCriterion(
                         TerminationCriterion::GenerationLimitReached);
     } else if (sigma < sigmaStop) {
@@ -241,7 +1189,55 @@ Info RayEs::run() {
     }
 
     info.setNumGenerations(g);
+    info.setLambdaHistory(lambdaHistory);
+    info.setLineSearchStatistics(lineSearchStatistics);
+
+    if (m_parameters.localPolish &&
+            aBest.f() < std::numeric_limits<double>::max()) {
+        publishStatus(RunPhase::Polishing);
+        // the initial step size is the scale of the ray mutations
+        // at the distance of the best point from the ray origin
+        const double polishStepSizeInit = std::max(
+            sigma * (aBest.bestOnRay() - m_rayOriginInit).norm(),
+            sigmaStop);
+        const int polishMaxFitnessEvaluations =
+            m_parameters.polishMaxFitnessEvaluations > 0 ?
+            m_parameters.polishMaxFitnessEvaluations : 200 * dimension;
+        LineSearchResult polishResult =
+            localPolish(aBest.bestOnRay(), aBest.f(), aBestHandle,
+                        polishStepSizeInit, lineSearchEpsilon,
+                        polishMaxFitnessEvaluations);
+        info.setNumFitnessEvaluations(info.getNumFitnessEvaluations() +
+                                      polishResult.numFitnessEvaluations);
+        info.setNumPolishFitnessEvaluations(
+                                      polishResult.numFitnessEvaluations);
+        Individual polished = aBest;
+        polished.bestOnRay(polishResult.bestOnRay);
+        polished.f(polishResult.f);
+        info.setPolishedIndividual(polished);
+        if (isFirstFitterThanSecond(polished, aBest)) {
+            aBest = polished;
+        }
+    }
+
     info.setBestIndividual(aBest);
+    if (m_parameters.recordLatencies) {
+        auto objectiveLatencies =
+            std::make_shared<es::core::LatencyHistogram>();
+        auto constraintLatencies =
+            std::make_shared<es::core::LatencyHistogram>();
+        auto lineSearchLatencies =
+            std::make_shared<es::core::LatencyHistogram>();
+        for (const ThreadLatencies &latencies : threadLatencies) {
+            objectiveLatencies->merge(latencies.objective);
+            constraintLatencies->merge(latencies.constraint);
+            lineSearchLatencies->merge(latencies.lineSearch);
+        }
+        info.setObjectiveLatencies(objectiveLatencies);
+        info.setConstraintLatencies(constraintLatencies);
+        info.setLineSearchLatencies(lineSearchLatencies);
+    }
+    publishStatus(RunPhase::Finished);
 
     return info;
 }
@@ -249,46 +1245,117 @@ Info RayEs::run() {
 LineSearchResult RayEs::lineSearch(const Eigen::VectorXd &rayNormalized,
                                    const double initialLength,
                                    const int nPartitions,
+                                   const int nRefinementPartitions,
                                    const Eigen::VectorXd &rayOrigin,
+                                   const bool isRayOriginFeasible,
+                                   const double rayOriginF,
+                                   const long rayOriginHandle,
                                    const double epsilon) {
-    const int dimension = m_lbnds.rows();
     LineSearchResult lineSearchResult;
-    auto fEvalHelper = [&lineSearchResult, this](const Eigen::VectorXd &x) {
+    auto fEvalHelper = [&lineSearchResult, this](
+            const Eigen::VectorXd &x, const long neighborHandle,
+            const Eigen::VectorXd *neighbor, long &handle) {
         lineSearchResult.numFitnessEvaluations += 1;
-        return m_objectiveFun(x);
+        return evaluate(x, neighborHandle, neighbor, handle);
     };
     lineSearchResult.feasibleFound = false;
-    Eigen::VectorXd rayOriginCurr = rayOrigin;
-    double rayOriginCurrFitness = fEvalHelper(rayOriginCurr);
-    double deltaPartition = initialLength / static_cast<double>(nPartitions);
+
+    // A node of the grid on the ray at rayOrigin + t * rayNormalized (after
+    // the bound handling). Level l sweeps the 2 * n + 1 nodes t = tCenter
+    // + k * delta, k = -n, ..., n, around the best node of level l - 1;
+    // delta is divided by the number of refinement partitions from level
+    // to level, so the center and the outermost nodes of a refinement are
+    // the best node of the previous level and its neighbors there. They
+    // are taken over instead of being probed again.
+    struct GridNode {
+        double t;
+        Eigen::VectorXd pos;
+        bool isFeasible;
+        double f;
+        long handle;
+    };
+    // the origin is known from run()
+    GridNode center;
+    center.t = 0.0;
+    center.pos = rayOrigin;
+    center.f = rayOriginF;
+    center.isFeasible = isRayOriginFeasible;
+    center.handle = rayOriginHandle;
+    ++lineSearchResult.numSavedFitnessEvaluations;
+    GridNode lower, upper;
+    bool hasLower = false, hasUpper = false;
+    std::vector<GridNode> level;
+
+    int n = nPartitions;
+    double deltaPartition = initialLength / static_cast<double>(n);
     while (deltaPartition > epsilon) {
-        int nFeasible = 0;
-        double bestFitness = std::numeric_limits<double>::max();
-        Eigen::VectorXd bestPos = Eigen::VectorXd::Zero(dimension);
-        for (int p = 1; p <= 2 * nPartitions + 1; ++p) {
-            Eigen::VectorXd pos = rayOriginCurr +
-                deltaPartition *
-                static_cast<double>((p - nPartitions - 1)) * rayNormalized;
-            if (isFeasible(pos)) {
-                ++nFeasible;
-                double fitness = fEvalHelper(pos);
-                if (fitness < bestFitness) {
-                    bestFitness = fitness;
-                    bestPos = pos;
+        level.resize(2 * n + 1);
+        int best = -1;
+        // the neighbor of a probe is the previous feasible node of the
+        // sweep or, for the first one, the center of the sweep
+        const GridNode *neighbor = &center;
+        for (int k = -n; k <= n; ++k) {
+            GridNode &node = level[k + n];
+            const GridNode *known = k == 0 ? &center :
+                (k == -n && hasLower) ? &lower :
+                (k == n && hasUpper) ? &upper : nullptr;
+            if (known) {
+                node = *known;
+            } else {
+                node.t = center.t + deltaPartition * static_cast<double>(k);
+                node.pos = probe(rayOrigin, rayNormalized, node.t);
+            }
+            // neighboring nodes beyond the box can be mapped onto the same
+            // point by the bound handling
+            if (k > -n && node.pos == level[k + n - 1].pos) {
+                const double t = node.t;
+                node = level[k + n - 1];
+                node.t = t;
+                continue;
+            }
+            if (known) {
+                if (node.isFeasible) {
+                    ++lineSearchResult.numSavedFitnessEvaluations;
+                }
+            } else {
+                node.isFeasible = isFeasible(node.pos);
+                node.handle = -1;
+                if (node.isFeasible) {
+                    node.f = fEvalHelper(node.pos, neighbor->handle,
+                                         &neighbor->pos, node.handle);
+                }
+            }
+            if (node.isFeasible) {
+                if (node.f < (best >= 0 ? level[best].f :
+                              std::numeric_limits<double>::max())) {
+                    best = k + n;
                 }
+                neighbor = &node;
             }
         }
-        if (nFeasible > 0) {
-            rayOriginCurr = bestPos;
-            rayOriginCurrFitness = bestFitness;
+        const int next = best >= 0 ? best : n;
+        if (best >= 0) {
+            center = level[best];
             lineSearchResult.feasibleFound = true;
         }
+        hasLower = next > 0;
+        if (hasLower) {
+            lower = level[next - 1];
+        }
+        hasUpper = next < 2 * n;
+        if (hasUpper) {
+            upper = level[next + 1];
+        }
 
-        deltaPartition = deltaPartition / static_cast<double>(nPartitions);
+        n = nRefinementPartitions;
+        deltaPartition = deltaPartition / static_cast<double>(n);
     }
 
-    lineSearchResult.bestOnRay = rayOriginCurr;
-    lineSearchResult.f = rayOriginCurrFitness;
+    lineSearchResult.bestOnRay = center.pos;
+    lineSearchResult.f = center.f;
+    lineSearchResult.bestOnRayHandle = center.handle;
+    const double offset = (center.pos - rayOrigin).dot(rayNormalized);
+    lineSearchResult.bestOnRayDirection = (offset > 0.0) - (offset < 0.0);
 
     return lineSearchResult;
 }
@@ -302,37 +1369,55 @@ LineSearchResult RayEs::lineSearch2(const Eigen::VectorXd &rayNormalized,
                                     const std::set<int> &directions) {
     const int dimension = m_lbnds.rows();
     LineSearchResult lineSearchResult;
-    auto fEvalHelper = [&lineSearchResult, this](const Eigen::VectorXd &x) {
+    auto fEvalHelper = [&lineSearchResult, this](
+            const Eigen::VectorXd &x, const long neighborHandle,
+            const Eigen::VectorXd *neighbor, long &handle) {
         lineSearchResult.numFitnessEvaluations += 1;
-        return m_objectiveFun(x);
+        return evaluate(x, neighborHandle, neighbor, handle);
     };
     lineSearchResult.feasibleFound = false;
     lineSearchResult.bestOnRay = Eigen::VectorXd::Zero(dimension);
     lineSearchResult.f = std::numeric_limits<double>::max();
     lineSearchResult.bestOnRayDirection = 0;
-    const double rayOriginFitness = fEvalHelper(rayOrigin);
+    long rayOriginHandle = -1;
+    const double rayOriginFitness =
+        fEvalHelper(rayOrigin, -1, nullptr, rayOriginHandle);
     const bool isRayOriginFeasible = isFeasible(rayOrigin);
     for (int direction : directions) {
         Eigen::VectorXd rayOriginCurr = rayOrigin;
         double rayOriginCurrFitness = rayOriginFitness;
+        long rayOriginCurrHandle = rayOriginHandle;
         bool isRayOriginCurrFeasible = isRayOriginFeasible;
         Eigen::VectorXd rayOriginPrev = rayOriginCurr;
         double rayOriginPrevFitness = rayOriginCurrFitness;
+        long rayOriginPrevHandle = rayOriginCurrHandle;
         double stepSize = stepSizeInit;
         int iter = 0;
         while (iter < 100 && stepSize >= epsilon) {
             rayOriginCurr = rayOriginPrev;
             rayOriginCurrFitness = rayOriginPrevFitness;
+            rayOriginCurrHandle = rayOriginPrevHandle;
             do {
                 rayOriginPrev = rayOriginCurr;
                 rayOriginPrevFitness = rayOriginCurrFitness;
+                rayOriginPrevHandle = rayOriginCurrHandle;
 
-                rayOriginCurr = rayOriginCurr +
-                    static_cast<double>(direction) * stepSize *
-                    rayNormalized;
-                isRayOriginCurrFeasible = isFeasible(rayOriginCurr);
+                const Eigen::VectorXd pos =
+                    probe(rayOriginCurr, rayNormalized,
+                          static_cast<double>(direction) * stepSize);
+                // a probe that the bound handling maps back onto the
+                // current point yields no progress; treat it like an
+                // infeasible one without spending an evaluation
+                const bool isStuck = pos == rayOriginCurr;
+                rayOriginCurr = pos;
+                rayOriginCurrHandle = -1;
+                isRayOriginCurrFeasible =
+                    !isStuck && isFeasible(rayOriginCurr);
                 if (isRayOriginCurrFeasible) {
-                    rayOriginCurrFitness = fEvalHelper(rayOriginCurr);
+                    // the probe steps from rayOriginPrev
+                    rayOriginCurrFitness =
+                        fEvalHelper(rayOriginCurr, rayOriginPrevHandle,
+                                    &rayOriginPrev, rayOriginCurrHandle);
                 }
 
                 if (isRayOriginCurrFeasible &&
@@ -342,6 +1427,7 @@ LineSearchResult RayEs::lineSearch2(const Eigen::VectorXd &rayNormalized,
                     lineSearchResult.bestOnRay = rayOriginCurr;
                     lineSearchResult.f = rayOriginCurrFitness;
                     lineSearchResult.bestOnRayDirection = direction;
+                    lineSearchResult.bestOnRayHandle = rayOriginCurrHandle;
                 } else {
                     stepSize /= stepSizeDecreaseFactor;
                 }
@@ -356,8 +1442,292 @@ LineSearchResult RayEs::lineSearch2(const Eigen::VectorXd &rayNormalized,
     return lineSearchResult;
 }
 
+LineSearchResult RayEs::planeSearch(const LineSearchResult &lineSearchResult,
+                                    const Eigen::VectorXd &rayNormalized,
+                                    const Eigen::VectorXd &parentRay,
+                                    const double stepSizeInit,
+                                    const double stepSizeStop,
+                                    const int maxFitnessEvaluations) {
+    LineSearchResult planeSearchResult = lineSearchResult;
+    // orthonormal basis of the plane: the offspring ray and the part of
+    // the parent ray orthogonal to it
+    Eigen::VectorXd normal =
+        parentRay - parentRay.dot(rayNormalized) * rayNormalized;
+    const double normalNorm = normal.norm();
+    if (!lineSearchResult.feasibleFound || !(normalNorm > 1e-12)) {
+        return planeSearchResult;
+    }
+    normal /= normalNorm;
+    const Eigen::VectorXd *directions[] = {&normal, &rayNormalized};
+
+    // compass search: the first improving poll is accepted and doubles the
+    // step size, a poll without improvement halves it
+    int numFitnessEvaluations = 0;
+    double stepSize = stepSizeInit;
+    while (stepSize > stepSizeStop &&
+           numFitnessEvaluations < maxFitnessEvaluations) {
+        bool improved = false;
+        for (int i = 0; i < 4 && !improved &&
+                 numFitnessEvaluations < maxFitnessEvaluations; ++i) {
+            const Eigen::VectorXd pos =
+                probe(planeSearchResult.bestOnRay, *directions[i / 2],
+                      (i % 2 == 0 ? 1.0 : -1.0) * stepSize);
+            if (pos == planeSearchResult.bestOnRay || !isFeasible(pos)) {
+                continue;
+            }
+            ++numFitnessEvaluations;
+            long handle = -1;
+            const double f = evaluate(pos, planeSearchResult.bestOnRayHandle,
+                                      &planeSearchResult.bestOnRay, handle);
+            if (f < planeSearchResult.f) {
+                planeSearchResult.bestOnRay = pos;
+                planeSearchResult.f = f;
+                planeSearchResult.bestOnRayHandle = handle;
+                improved = true;
+            }
+        }
+        if (improved) {
+            stepSize *= 2.0;
+        } else {
+            stepSize /= 2.0;
+        }
+    }
+    planeSearchResult.numFitnessEvaluations += numFitnessEvaluations;
+
+    return planeSearchResult;
+}
+
+LineSearchResult RayEs::localPolish(const Eigen::VectorXd &x0,
+                                    const double f0,
+                                    const long x0Handle,
+                                    const double stepSizeInit,
+                                    const double stepSizeStop,
+                                    const int maxFitnessEvaluations) {
+    const int dimension = m_lbnds.rows();
+    const double activeTolerance = m_parameters.polishActiveTolerance;
+    LineSearchResult lineSearchResult;
+    auto fEvalHelper = [&lineSearchResult, this](
+            const Eigen::VectorXd &x, const long neighborHandle,
+            const Eigen::VectorXd *neighbor, long &handle) {
+        lineSearchResult.numFitnessEvaluations += 1;
+        return evaluate(x, neighborHandle, neighbor, handle);
+    };
+    lineSearchResult.feasibleFound = true;
+    lineSearchResult.bestOnRay = x0;
+    lineSearchResult.f = f0;
+    lineSearchResult.bestOnRayHandle = x0Handle;
+
+    // active constraints are restored to c = -margin
+    const double margin = 1e-6 * activeTolerance;
+    std::vector<int> activeConstraints;
+    Eigen::MatrixXd activeGradientsPinv;
+    Eigen::MatrixXd directions;
+    bool updateDirections = true;
+    double stepSize = stepSizeInit;
+    while (stepSize > stepSizeStop &&
+           lineSearchResult.numFitnessEvaluations < maxFitnessEvaluations) {
+        const Eigen::VectorXd &x = lineSearchResult.bestOnRay;
+        if (updateDirections) {
+            // identify the active set at the current point and estimate
+            // the gradients of the active constraints by forward differences
+            const Eigen::VectorXd c = evaluateConstraints(x);
+            activeConstraints.clear();
+            for (int i = 0; i < c.rows(); ++i) {
+                if (c(i) > -activeTolerance) {
+                    activeConstraints.push_back(i);
+                }
+            }
+            std::vector<int> activeBounds;
+            for (int j = 0; j < dimension; ++j) {
+                if (x(j) - m_lbnds(j) < activeTolerance ||
+                        m_ubnds(j) - x(j) < activeTolerance) {
+                    activeBounds.push_back(j);
+                }
+            }
+            const int nActive = static_cast<int>(activeConstraints.size());
+            Eigen::MatrixXd activeGradients(nActive, dimension);
+            for (int j = 0; j < dimension && nActive > 0; ++j) {
+                const double h = 1e-7 * std::max(1.0, std::abs(x(j)));
+                Eigen::VectorXd xh = x;
+                xh(j) += h;
+                const Eigen::VectorXd ch = evaluateConstraints(xh);
+                for (int i = 0; i < nActive; ++i) {
+                    activeGradients(i, j) =
+                        (ch(activeConstraints[i]) - c(activeConstraints[i])) /
+                        h;
+                }
+            }
+            // poll the tangent space of the active set as well as the
+            // coordinate directions (the latter can leave the active set)
+            Eigen::MatrixXd activeJacobian =
+                Eigen::MatrixXd::Zero(nActive + activeBounds.size(),
+                                      dimension);
+            activeJacobian.topRows(nActive) = activeGradients;
+            for (std::size_t i = 0; i < activeBounds.size(); ++i) {
+                activeJacobian(nActive + i, activeBounds[i]) = 1.0;
+            }
+            int rank = 0;
+            Eigen::MatrixXd tangents;
+            if (activeJacobian.rows() > 0) {
+                Eigen::JacobiSVD<Eigen::MatrixXd> svd(activeJacobian,
+                                                      Eigen::ComputeFullV);
+                const Eigen::VectorXd singular = svd.singularValues();
+                for (int i = 0; i < singular.rows(); ++i) {
+                    if (singular(i) > 1e-10 * singular(0)) {
+                        ++rank;
+                    }
+                }
+                tangents = svd.matrixV().rightCols(dimension - rank);
+            }
+            if (nActive > 0) {
+                activeGradientsPinv = activeGradients
+                    .completeOrthogonalDecomposition().pseudoInverse();
+            }
+            directions.resize(dimension, tangents.cols() + dimension);
+            directions.leftCols(tangents.cols()) = tangents;
+            directions.rightCols(dimension) =
+                Eigen::MatrixXd::Identity(dimension, dimension);
+            updateDirections = false;
+        }
+
+        bool improved = false;
+        for (int k = 0; k < directions.cols() && !improved; ++k) {
+            for (const double sign : {1.0, -1.0}) {
+                if (lineSearchResult.numFitnessEvaluations >=
+                        maxFitnessEvaluations) {
+                    break;
+                }
+                Eigen::VectorXd y = x + sign * stepSize * directions.col(k);
+                // restore the active constraints (minimum norm Newton steps
+                // with the gradients of the current point) such that moves
+                // along curved constraint boundaries stay feasible
+                for (int iter = 0;
+                     iter < 3 && !activeConstraints.empty(); ++iter) {
+                    const Eigen::VectorXd cy = evaluateConstraints(y);
+                    Eigen::VectorXd violation(activeConstraints.size());
+                    for (std::size_t i = 0; i < activeConstraints.size();
+                         ++i) {
+                        violation(i) = cy(activeConstraints[i]) + margin;
+                    }
+                    if ((violation.array() <= 0.0).all()) {
+                        break;
+                    }
+                    y -= activeGradientsPinv * violation;
+                }
+                y = y.cwiseMax(m_lbnds).cwiseMin(m_ubnds);
+                if (y == x || !isFeasible(y)) {
+                    continue;
+                }
+                long handle = -1;
+                const double fy =
+                    fEvalHelper(y, lineSearchResult.bestOnRayHandle, &x,
+                                handle);
+                if (fy < lineSearchResult.f) {
+                    lineSearchResult.bestOnRay = y;
+                    lineSearchResult.f = fy;
+                    lineSearchResult.bestOnRayHandle = handle;
+                    improved = true;
+                    break;
+                }
+            }
+        }
+        if (improved) {
+            stepSize *= 2.0;
+            updateDirections = true;
+        } else {
+            stepSize /= 2.0;
+        }
+    }
+
+    return lineSearchResult;
+}
+
+Eigen::VectorXd RayEs::probe(const Eigen::VectorXd &origin,
+                             const Eigen::VectorXd &rayNormalized,
+                             const double t) const {
+    Eigen::VectorXd pos = origin + t * rayNormalized;
+    if (m_parameters.boundHandling == BoundHandling::Reject) {
+        return pos;
+    } else if (m_parameters.boundHandling == BoundHandling::Clip) {
+        // intersect the line origin + s * rayNormalized with the box
+        double sLo = -std::numeric_limits<double>::infinity();
+        double sHi = std::numeric_limits<double>::infinity();
+        for (int i = 0; i < origin.rows(); ++i) {
+            const double r = rayNormalized(i);
+            if (std::abs(r) < 1e-300) {
+                if (origin(i) < m_lbnds(i) || origin(i) > m_ubnds(i)) {
+                    return pos;
+                }
+                continue;
+            }
+            const double s1 = (m_lbnds(i) - origin(i)) / r;
+            const double s2 = (m_ubnds(i) - origin(i)) / r;
+            sLo = std::max(sLo, std::min(s1, s2));
+            sHi = std::min(sHi, std::max(s1, s2));
+        }
+        if (sLo > sHi) {
+            // the line misses the box; nothing sensible to clip to
+            return pos;
+        }
+        const double tClipped = std::min(std::max(t, sLo), sHi);
+        if (tClipped == t) {
+            return pos;
+        }
+        // the clamping only removes rounding errors at the box face
+        return (origin + tClipped * rayNormalized)
+            .cwiseMax(m_lbnds).cwiseMin(m_ubnds);
+    } else if (m_parameters.boundHandling == BoundHandling::Project) {
+        return pos.cwiseMax(m_lbnds).cwiseMin(m_ubnds);
+    } else if (m_parameters.boundHandling == BoundHandling::Reflect) {
+        for (int i = 0; i < pos.rows(); ++i) {
+            const double width = m_ubnds(i) - m_lbnds(i);
+            if (!(width > 0.0)) {
+                pos(i) = m_lbnds(i);
+                continue;
+            }
+            if (pos(i) < m_lbnds(i) || pos(i) > m_ubnds(i)) {
+                // fold into one period of the reflection [lb, lb + 2w)
+                double y = std::fmod(pos(i) - m_lbnds(i), 2.0 * width);
+                if (y < 0.0) {
+                    y += 2.0 * width;
+                }
+                pos(i) = y <= width ?
+                    m_lbnds(i) + y :
+                    m_lbnds(i) + 2.0 * width - y;
+                pos(i) = std::min(std::max(pos(i), m_lbnds(i)), m_ubnds(i));
+            }
+        }
+        return pos;
+    } else {
+        throw std::runtime_error("unknown bound handling");
+    }
+}
+
+double RayEs::evaluate(const Eigen::VectorXd &x, const long neighborHandle,
+                       const Eigen::VectorXd *neighbor, long &handle) {
+    // in batch mode, the batch calls are timed by the evaluator
+    LatencyTimer timer(m_lockstepEvaluator || !t_latencies ? nullptr :
+                       &t_latencies->objective);
+    if (!m_contextObjectiveFun) {
+        handle = -1;
+        return m_objectiveFun(x);
+    }
+    EvaluationContext context;
+    context.handle = (*m_nextEvaluationHandle)++;
+    context.neighborHandle = neighbor ? neighborHandle : -1;
+    context.neighbor = neighborHandle >= 0 ? neighbor : nullptr;
+    handle = context.handle;
+    return m_contextObjectiveFun(x, context);
+}
+
+Eigen::VectorXd RayEs::evaluateConstraints(const Eigen::VectorXd &x) {
+    LatencyTimer timer(m_lockstepEvaluator || !t_latencies ? nullptr :
+                       &t_latencies->constraint);
+    return m_constraintFun(x);
+}
+
 bool RayEs::isFeasible(const Eigen::VectorXd &x) {
-    return ((m_constraintFun(x).array() <= 1e-20).all() &&
+    return ((evaluateConstraints(x).array() <= 1e-20).all() &&
             ((m_lbnds - x).array() <= 1e-20).all() &&
             ((x - m_ubnds).array() <= 1e-20).all());
 }
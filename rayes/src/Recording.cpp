@@ -0,0 +1,314 @@
+#include "es/rayes/Recording.h"
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <vector>
+
+namespace es {
+namespace rayes {
+
+// File format (native byte order):
+//   header:  "RAYESREC", uint32 version, uint32 dimension n,
+//            uint32 line search algorithm, n doubles each for the lower
+//            bounds, the upper bounds and the initial ray origin,
+//            uint32 length and text of the parameters (writeParameters)
+//   records: uint8 kind (0 objective, 1 constraint), n doubles x,
+//            objective: double f(x),
+//            constraint: uint32 m and m doubles c(x)
+namespace {
+
+const char MAGIC[8] = {'R', 'A', 'Y', 'E', 'S', 'R', 'E', 'C'};
+const std::uint32_t VERSION = 1;
+const std::uint8_t OBJECTIVE = 0;
+const std::uint8_t CONSTRAINT = 1;
+
+template<typename T>
+void write(std::ostream &os, const T &value) {
+    os.write(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+void write(std::ostream &os, const Eigen::VectorXd &x) {
+    os.write(reinterpret_cast<const char *>(x.data()),
+             static_cast<std::streamsize>(x.size() * sizeof(double)));
+}
+
+// Reads from the file contents with bounds checks.
+class Reader {
+ public:
+    Reader(const std::vector<char> &data, const std::string &path)
+        : m_data(data)
+        , m_path(path)
+        , m_position(0) {
+    }
+
+    const char *take(std::size_t size) {
+        if (size > m_data.size() - m_position) {
+            throw std::runtime_error("Truncated recording " + m_path);
+        }
+        const char *p = m_data.data() + m_position;
+        m_position += size;
+        return p;
+    }
+
+    template<typename T>
+    T read() {
+        T value;
+        std::memcpy(&value, take(sizeof(T)), sizeof(T));
+        return value;
+    }
+
+    Eigen::VectorXd readVector(std::uint32_t size) {
+        Eigen::VectorXd x(size);
+        std::memcpy(x.data(), take(size * sizeof(double)),
+                    size * sizeof(double));
+        return x;
+    }
+
+    std::size_t position() const {
+        return m_position;
+    }
+
+    bool atEnd() const {
+        return m_position == m_data.size();
+    }
+
+ private:
+    const std::vector<char> &m_data;
+    const std::string &m_path;
+    std::size_t m_position;
+};
+
+}
+
+struct EvaluationRecorder::Output {
+    std::ofstream file;
+    std::string path;
+};
+
+EvaluationRecorder::EvaluationRecorder(const std::string &path,
+                                       const Eigen::VectorXd &lbnds,
+                                       const Eigen::VectorXd &ubnds,
+                                       const Eigen::VectorXd &rayOriginInit,
+                                       const LineSearchAlg lineSearchAlg,
+                                       const Parameters &parameters)
+    : m_output(std::make_shared<Output>()) {
+    if (parameters.seed == 0) {
+        throw std::runtime_error("Recording requires a nonzero seed");
+    }
+    // concurrent calls would interleave in the file in an order the replay
+    // cannot repeat
+    if (parameters.numThreads != 1) {
+        throw std::runtime_error("Recording requires numThreads = 1");
+    }
+    if (lbnds.size() != ubnds.size() ||
+        lbnds.size() != rayOriginInit.size()) {
+        throw std::runtime_error("Recording: dimensions do not match");
+    }
+    m_output->path = path;
+    m_output->file.open(path.c_str(), std::ios::binary | std::ios::trunc);
+    if (!m_output->file) {
+        throw std::runtime_error("Cannot write recording " + path);
+    }
+    std::ostringstream text;
+    writeParameters(text, parameters);
+    const std::string parametersText = text.str();
+
+    std::ostream &os = m_output->file;
+    os.write(MAGIC, sizeof(MAGIC));
+    write(os, VERSION);
+    write(os, static_cast<std::uint32_t>(lbnds.size()));
+    write(os, static_cast<std::uint32_t>(lineSearchAlg));
+    write(os, lbnds);
+    write(os, ubnds);
+    write(os, rayOriginInit);
+    write(os, static_cast<std::uint32_t>(parametersText.size()));
+    os.write(parametersText.data(),
+             static_cast<std::streamsize>(parametersText.size()));
+}
+
+std::function<double(const Eigen::VectorXd &)> EvaluationRecorder::objective(
+    const std::function<double(const Eigen::VectorXd &)> &objectiveFun) {
+    std::shared_ptr<Output> output = m_output;
+    return [output, objectiveFun](const Eigen::VectorXd &x) {
+        const double f = objectiveFun(x);
+        write(output->file, OBJECTIVE);
+        write(output->file, x);
+        write(output->file, f);
+        return f;
+    };
+}
+
+std::function<Eigen::VectorXd(const Eigen::VectorXd &)>
+EvaluationRecorder::constraint(
+    const std::function<Eigen::VectorXd(
+                        const Eigen::VectorXd &)> &constraintFun) {
+    std::shared_ptr<Output> output = m_output;
+    return [output, constraintFun](const Eigen::VectorXd &x) {
+        Eigen::VectorXd c = constraintFun(x);
+        write(output->file, CONSTRAINT);
+        write(output->file, x);
+        write(output->file, static_cast<std::uint32_t>(c.size()));
+        write(output->file, c);
+        return c;
+    };
+}
+
+void EvaluationRecorder::flush() {
+    if (!m_output->file.flush()) {
+        throw std::runtime_error("Cannot write recording " + m_output->path);
+    }
+}
+
+ReplayEndReached::ReplayEndReached()
+    : std::runtime_error("Replay: end of the recording reached") {
+}
+
+struct EvaluationReplay::Input {
+    std::vector<char> data;
+    // Offset of the first record
+    std::size_t start;
+    std::size_t position;
+    std::size_t dimension;
+    long numEvaluations;
+    long numReplayedEvaluations;
+
+    // Checks that the next record is of the given kind at x and returns
+    // a pointer to its values.
+    const char *next(std::uint8_t kind, const Eigen::VectorXd &x) {
+        const std::size_t size = dimension * sizeof(double);
+        if (position == data.size()) {
+            throw ReplayEndReached();
+        }
+        const char *p = data.data() + position;
+        if (static_cast<std::uint8_t>(p[0]) != kind ||
+            static_cast<std::size_t>(x.size()) != dimension ||
+            std::memcmp(p + 1, x.data(), size) != 0) {
+            std::ostringstream os;
+            os << "Replay diverged from the recording at evaluation "
+               << numReplayedEvaluations + 1;
+            throw std::runtime_error(os.str());
+        }
+        ++numReplayedEvaluations;
+        return p + 1 + size;
+    }
+};
+
+EvaluationReplay::EvaluationReplay(const std::string &path)
+    : m_input(std::make_shared<Input>())
+    , m_lineSearchAlg(LineSearchAlg::Modified) {
+    std::ifstream file(path.c_str(), std::ios::binary);
+    if (!file) {
+        throw std::runtime_error("Cannot read recording " + path);
+    }
+    m_input->data.assign(std::istreambuf_iterator<char>(file),
+                         std::istreambuf_iterator<char>());
+
+    Reader reader(m_input->data, path);
+    if (std::memcmp(reader.take(sizeof(MAGIC)), MAGIC, sizeof(MAGIC)) != 0 ||
+        reader.read<std::uint32_t>() != VERSION) {
+        throw std::runtime_error("Not a recording (or unsupported version): " +
+                                 path);
+    }
+    const std::uint32_t dimension = reader.read<std::uint32_t>();
+    const std::uint32_t lineSearchAlg = reader.read<std::uint32_t>();
+    if (lineSearchAlg > static_cast<std::uint32_t>(LineSearchAlg::Adaptive)) {
+        throw std::runtime_error("Invalid line search algorithm in " + path);
+    }
+    m_lineSearchAlg = static_cast<LineSearchAlg>(lineSearchAlg);
+    m_lbnds = reader.readVector(dimension);
+    m_ubnds = reader.readVector(dimension);
+    m_rayOriginInit = reader.readVector(dimension);
+    const std::uint32_t parametersSize = reader.read<std::uint32_t>();
+    std::istringstream parametersText(
+        std::string(reader.take(parametersSize), parametersSize));
+    readParameters(parametersText, m_parameters);
+    if (m_parameters.numThreads != 1) {
+        throw std::runtime_error("Recorded with several threads, the order "
+                                 "of the evaluations is unknown: " + path);
+    }
+
+    m_input->start = reader.position();
+    m_input->position = m_input->start;
+    m_input->dimension = dimension;
+    m_input->numEvaluations = 0;
+    m_input->numReplayedEvaluations = 0;
+    while (!reader.atEnd()) {
+        const std::uint8_t kind = reader.read<std::uint8_t>();
+        reader.take(dimension * sizeof(double));
+        if (kind == OBJECTIVE) {
+            reader.take(sizeof(double));
+        } else if (kind == CONSTRAINT) {
+            reader.take(reader.read<std::uint32_t>() * sizeof(double));
+        } else {
+            throw std::runtime_error("Invalid record in " + path);
+        }
+        ++m_input->numEvaluations;
+    }
+}
+
+const Eigen::VectorXd &EvaluationReplay::getLbnds() const {
+    return m_lbnds;
+}
+
+const Eigen::VectorXd &EvaluationReplay::getUbnds() const {
+    return m_ubnds;
+}
+
+const Eigen::VectorXd &EvaluationReplay::getRayOriginInit() const {
+    return m_rayOriginInit;
+}
+
+LineSearchAlg EvaluationReplay::getLineSearchAlg() const {
+    return m_lineSearchAlg;
+}
+
+const Parameters &EvaluationReplay::getParameters() const {
+    return m_parameters;
+}
+
+long EvaluationReplay::getNumEvaluations() const {
+    return m_input->numEvaluations;
+}
+
+long EvaluationReplay::getNumReplayedEvaluations() const {
+    return m_input->numReplayedEvaluations;
+}
+
+void EvaluationReplay::rewind() {
+    m_input->position = m_input->start;
+    m_input->numReplayedEvaluations = 0;
+}
+
+std::function<double(const Eigen::VectorXd &)>
+EvaluationReplay::objective() const {
+    std::shared_ptr<Input> input = m_input;
+    return [input](const Eigen::VectorXd &x) {
+        const char *p = input->next(OBJECTIVE, x);
+        double f;
+        std::memcpy(&f, p, sizeof(double));
+        input->position = static_cast<std::size_t>(
+            p + sizeof(double) - input->data.data());
+        return f;
+    };
+}
+
+std::function<Eigen::VectorXd(const Eigen::VectorXd &)>
+EvaluationReplay::constraint() const {
+    std::shared_ptr<Input> input = m_input;
+    return [input](const Eigen::VectorXd &x) {
+        const char *p = input->next(CONSTRAINT, x);
+        std::uint32_t size;
+        std::memcpy(&size, p, sizeof(size));
+        Eigen::VectorXd c(size);
+        std::memcpy(c.data(), p + sizeof(size), size * sizeof(double));
+        input->position = static_cast<std::size_t>(
+            p + sizeof(size) + size * sizeof(double) - input->data.data());
+        return c;
+    };
+}
+
+}
+}
@@ -0,0 +1,240 @@
+#include "es/rayes/Status.h"
+
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <sstream>
+#include <stdexcept>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static_assert(ATOMIC_INT_LOCK_FREE == 2 && ATOMIC_LLONG_LOCK_FREE == 2,
+              "the status segment requires lock-free atomics");
+
+namespace es {
+namespace rayes {
+
+namespace {
+
+// The segments are named /es_rayes_status.<pid>.<number> and appear in
+// SHM_DIRECTORY on Linux.
+const char SEGMENT_PREFIX[] = "es_rayes_status.";
+const char SHM_DIRECTORY[] = "/dev/shm";
+const std::uint32_t MAGIC = 0x52455331;
+const int LABEL_SIZE = 64;
+
+std::uint64_t toBits(double value) {
+    std::uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+double fromBits(std::uint64_t bits) {
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+}
+
+// Layout of the shared memory. The fields are atomics (written and read
+// with relaxed order) such that the concurrent accesses of the seqlock are
+// well-defined; the sequence number is odd while the writer updates them.
+struct StatusPublisher::Segment {
+    std::atomic<std::uint32_t> magic;
+    std::atomic<std::uint32_t> sequence;
+    std::int64_t pid;
+    char label[LABEL_SIZE];
+    std::atomic<std::uint64_t> phase;
+    std::atomic<std::uint64_t> generation;
+    std::atomic<std::uint64_t> sigma;
+    std::atomic<std::uint64_t> bestF;
+    std::atomic<std::uint64_t> numFitnessEvaluations;
+    std::atomic<std::uint64_t> fitnessEvaluationsPerSecond;
+    std::atomic<std::uint64_t> elapsedSeconds;
+};
+
+std::ostream &operator<<(std::ostream &os, RunPhase runPhase) {
+    if (RunPhase::Initializing == runPhase) {
+        os << "Initializing";
+    } else if (RunPhase::Evolving == runPhase) {
+        os << "Evolving";
+    } else if (RunPhase::Polishing == runPhase) {
+        os << "Polishing";
+    } else if (RunPhase::Finished == runPhase) {
+        os << "Finished";
+    } else {
+        throw std::runtime_error("Unknown run phase");
+    }
+    return os;
+}
+
+RunStatus::RunStatus()
+    : pid(0)
+    , label()
+    , phase(RunPhase::Initializing)
+    , generation(0)
+    , sigma(0.0)
+    , bestF(0.0)
+    , numFitnessEvaluations(0)
+    , fitnessEvaluationsPerSecond(0.0)
+    , elapsedSeconds(0.0)
+{
+}
+
+StatusPublisher::StatusPublisher(const std::string &label)
+    : m_segment(nullptr) {
+    static std::atomic<unsigned> numSegments(0);
+    std::ostringstream name;
+    name << "/" << SEGMENT_PREFIX << getpid() << "." << numSegments++;
+    m_name = name.str();
+
+    const int fd = shm_open(m_name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot create the status segment " +
+                                 m_name + ": " + std::strerror(errno));
+    }
+    void *memory = MAP_FAILED;
+    if (ftruncate(fd, sizeof(Segment)) == 0) {
+        memory = mmap(nullptr, sizeof(Segment), PROT_READ | PROT_WRITE,
+                      MAP_SHARED, fd, 0);
+    }
+    close(fd);
+    if (memory == MAP_FAILED) {
+        shm_unlink(m_name.c_str());
+        throw std::runtime_error("Cannot map the status segment " + m_name);
+    }
+
+    m_segment = new (memory) Segment();
+    m_segment->sequence.store(0, std::memory_order_relaxed);
+    m_segment->pid = getpid();
+    std::strncpy(m_segment->label, label.c_str(), LABEL_SIZE - 1);
+    m_segment->label[LABEL_SIZE - 1] = '\0';
+    publish(RunStatus());
+    // readers ignore the segment until it is initialized
+    m_segment->magic.store(MAGIC, std::memory_order_release);
+}
+
+StatusPublisher::~StatusPublisher() {
+    munmap(m_segment, sizeof(Segment));
+    shm_unlink(m_name.c_str());
+}
+
+void StatusPublisher::publish(const RunStatus &status) {
+    const std::uint32_t sequence =
+        m_segment->sequence.load(std::memory_order_relaxed);
+    m_segment->sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    const std::memory_order order = std::memory_order_relaxed;
+    m_segment->phase.store(static_cast<std::uint64_t>(status.phase), order);
+    m_segment->generation.store(
+        static_cast<std::uint64_t>(status.generation), order);
+    m_segment->sigma.store(toBits(status.sigma), order);
+    m_segment->bestF.store(toBits(status.bestF), order);
+    m_segment->numFitnessEvaluations.store(
+        static_cast<std::uint64_t>(status.numFitnessEvaluations), order);
+    m_segment->fitnessEvaluationsPerSecond.store(
+        toBits(status.fitnessEvaluationsPerSecond), order);
+    m_segment->elapsedSeconds.store(toBits(status.elapsedSeconds), order);
+    m_segment->sequence.store(sequence + 2, std::memory_order_release);
+}
+
+const std::string &StatusPublisher::getName() const {
+    return m_name;
+}
+
+namespace {
+
+// Reads a consistent snapshot; returns false if the segment is not
+// initialized or the writer kept it busy.
+template<typename Segment>
+bool readSegment(const Segment &segment, RunStatus &status) {
+    if (segment.magic.load(std::memory_order_acquire) != MAGIC) {
+        return false;
+    }
+    const std::memory_order order = std::memory_order_relaxed;
+    for (int attempt = 0; attempt < 1000; ++attempt) {
+        const std::uint32_t sequence =
+            segment.sequence.load(std::memory_order_acquire);
+        if (sequence % 2 != 0) {
+            continue;
+        }
+        status.phase = static_cast<RunPhase>(segment.phase.load(order));
+        status.generation = static_cast<int>(segment.generation.load(order));
+        status.sigma = fromBits(segment.sigma.load(order));
+        status.bestF = fromBits(segment.bestF.load(order));
+        status.numFitnessEvaluations =
+            static_cast<int>(segment.numFitnessEvaluations.load(order));
+        status.fitnessEvaluationsPerSecond =
+            fromBits(segment.fitnessEvaluationsPerSecond.load(order));
+        status.elapsedSeconds = fromBits(segment.elapsedSeconds.load(order));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (segment.sequence.load(std::memory_order_relaxed) == sequence) {
+            status.pid = static_cast<long>(segment.pid);
+            status.label = std::string(segment.label,
+                                       strnlen(segment.label, LABEL_SIZE));
+            return true;
+        }
+    }
+    return false;
+}
+
+}
+
+std::vector<RunStatus> readRunStatuses(bool removeStale) {
+    std::vector<RunStatus> statuses;
+    DIR *directory = opendir(SHM_DIRECTORY);
+    if (directory == nullptr) {
+        return statuses;
+    }
+    const std::size_t prefixLength = sizeof(SEGMENT_PREFIX) - 1;
+    while (dirent *entry = readdir(directory)) {
+        const std::string fileName = entry->d_name;
+        if (fileName.compare(0, prefixLength, SEGMENT_PREFIX) != 0) {
+            continue;
+        }
+        const std::string name = "/" + fileName;
+        const long pid = std::atol(fileName.c_str() + prefixLength);
+        if (pid <= 0 || (kill(static_cast<pid_t>(pid), 0) != 0 &&
+                         errno == ESRCH)) {
+            if (removeStale) {
+                shm_unlink(name.c_str());
+            }
+            continue;
+        }
+        const int fd = shm_open(name.c_str(), O_RDONLY, 0);
+        if (fd < 0) {
+            continue;
+        }
+        struct stat st;
+        void *memory = MAP_FAILED;
+        const std::size_t size = sizeof(StatusPublisher::Segment);
+        if (fstat(fd, &st) == 0 && static_cast<std::size_t>(st.st_size) >=
+            size) {
+            memory = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+        }
+        close(fd);
+        if (memory == MAP_FAILED) {
+            continue;
+        }
+        RunStatus status;
+        if (readSegment(*static_cast<const StatusPublisher::Segment *>(
+                            memory), status)) {
+            statuses.push_back(status);
+        }
+        munmap(memory, size);
+    }
+    closedir(directory);
+    return statuses;
+}
+
+}
+}
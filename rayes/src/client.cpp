@@ -0,0 +1,191 @@
+#include "es/rayes/Daemon.h"
+#include "es/rayes/RayEs.h"
+#include "es/core/util.h"
+
+#include <Eigen/Dense>
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <string>
+
+namespace {
+
+// A shifted sphere whose optimum is cut off by the linear constraint
+// sum(x) <= 1; the shift moves a little from solve to solve such that
+// consecutive problems are related.
+struct Problem {
+    explicit Problem(int n)
+        : shift(Eigen::VectorXd::Ones(n)) {
+    }
+
+    es::rayes::BatchObjectiveFun objective() const {
+        const Eigen::VectorXd center = shift;
+        return [center](const Eigen::MatrixXd &x) -> Eigen::VectorXd {
+            return (x.colwise() - center).colwise().squaredNorm()
+                .transpose();
+        };
+    }
+
+    es::rayes::BatchConstraintFun constraint() const {
+        return [](const Eigen::MatrixXd &x) -> Eigen::MatrixXd {
+            return x.colwise().sum().array() - 1.0;
+        };
+    }
+
+    Eigen::VectorXd shift;
+};
+
+double seconds(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count();
+}
+
+}
+
+// Exercises a daemon started with es_rayestool --daemon SOCKET end to end:
+// a solve on the daemon must equal the same solve in the process, a
+// request with invalid parameters must fail without breaking the
+// connection, and a series of related problems is solved cold and with
+// warm starts, which must start from the best point of the previous
+// solve. The exit status is nonzero if a check fails.
+int main(int argc, char *argv[]) {
+    std::string socketPath;
+    int dimension = 4;
+    int repetitions = 10;
+    bool shutdown = false;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--dimension" && i + 1 < argc) {
+            dimension = std::max(2, std::atoi(argv[++i]));
+        } else if (arg == "--repetitions" && i + 1 < argc) {
+            repetitions = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--shutdown") {
+            shutdown = true;
+        } else if (socketPath.empty() && arg[0] != '-') {
+            socketPath = arg;
+        } else {
+            socketPath.clear();
+            break;
+        }
+    }
+    if (socketPath.empty()) {
+        std::cerr << "Usage: " << argv[0] << " SOCKET [--dimension N]"
+                  << " [--repetitions N] [--shutdown]" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    try {
+        es::rayes::SolverClient client(socketPath);
+        Problem problem(dimension);
+        es::rayes::SolveRequest request;
+        request.lbnds = -5.0 * Eigen::VectorXd::Ones(dimension);
+        request.ubnds = 5.0 * Eigen::VectorXd::Ones(dimension);
+        request.rayOriginInit = Eigen::VectorXd::Zero(dimension);
+        // the full parameters, such that tuned parameters of the daemon
+        // do not apply
+        es::rayes::Parameters parameters;
+        parameters.seed = 1;
+        std::ostringstream text;
+        es::rayes::writeParameters(text, parameters);
+        request.parameters = text.str();
+        request.progress = true;
+
+        int exitStatus = EXIT_SUCCESS;
+        int numProgress = 0;
+        const es::rayes::Info remote = client.solve(
+            request, problem.objective(), problem.constraint(),
+            [&numProgress](const es::rayes::RunStatus &) {
+                ++numProgress;
+            });
+        es::rayes::RayEs local(problem.objective(), problem.constraint(),
+                               request.lbnds, request.ubnds,
+                               request.rayOriginInit, request.lineSearchAlg,
+                               parameters);
+        const es::rayes::Info reference = local.run();
+        const bool equal =
+            remote.getBestIndividual().f() ==
+            reference.getBestIndividual().f() &&
+            remote.getBestIndividual().bestOnRay() ==
+            reference.getBestIndividual().bestOnRay() &&
+            remote.getNumFitnessEvaluations() ==
+            reference.getNumFitnessEvaluations();
+        std::cout << "Daemon solve: f " << remote.getBestIndividual().f()
+                  << ", " << remote.getNumFitnessEvaluations()
+                  << " evaluations, " << numProgress << " progress reports, "
+                  << (equal ? "equal to" : "DIFFERENT from")
+                  << " the local solve" << std::endl;
+        if (!equal || numProgress == 0) {
+            exitStatus = EXIT_FAILURE;
+        }
+
+        es::rayes::SolveRequest invalid = request;
+        invalid.parameters = "noSuchParameter = 1\n";
+        try {
+            client.solve(invalid, problem.objective(), problem.constraint());
+            std::cout << "Invalid request: NOT rejected" << std::endl;
+            exitStatus = EXIT_FAILURE;
+        } catch (const std::runtime_error &e) {
+            std::cout << "Invalid request: " << e.what() << std::endl;
+        }
+
+        // related problems, solved cold and warm-started from the best
+        // point of the previous one; a warm solve starts from that point,
+        // so its best f after the first generation must be at least as
+        // good as the point on the new problem
+        request.parameters.clear();
+        request.problemKey = 1;
+        Eigen::VectorXd previousBest;
+        int numColdStarts = 0;
+        for (int warm = 0; warm < 2; ++warm) {
+            request.warmStart = warm == 1;
+            request.progress = request.warmStart;
+            Problem related = problem;
+            long numEvaluations = 0;
+            double sumF = 0.0;
+            const auto start = std::chrono::steady_clock::now();
+            for (int repetition = 0; repetition < repetitions; ++repetition) {
+                related.shift.array() += 0.01;
+                double firstBestF = std::numeric_limits<double>::max();
+                bool first = true;
+                const es::rayes::Info info = client.solve(
+                    request, related.objective(), related.constraint(),
+                    [&](const es::rayes::RunStatus &status) {
+                        if (first) {
+                            firstBestF = status.bestF;
+                            first = false;
+                        }
+                    });
+                numEvaluations += info.getNumFitnessEvaluations();
+                sumF += info.getBestIndividual().f();
+                if (request.warmStart && previousBest.size() == dimension &&
+                        firstBestF > related.objective()(previousBest)(0)) {
+                    ++numColdStarts;
+                }
+                previousBest = info.getBestIndividual().bestOnRay();
+            }
+            const double time = seconds(start);
+            std::cout << (warm ? "Warm" : "Cold") << " solves: "
+                      << repetitions << " in " << time << " s, "
+                      << 1e3 * time / repetitions << " ms and "
+                      << numEvaluations / repetitions
+                      << " evaluations per solve, mean f "
+                      << sumF / repetitions << std::endl;
+        }
+        if (numColdStarts > 0) {
+            std::cout << "Warm solves: " << numColdStarts
+                      << " did NOT start from the stored point" << std::endl;
+            exitStatus = EXIT_FAILURE;
+        }
+
+        if (shutdown) {
+            client.shutdown();
+        }
+        return exitStatus;
+    } catch (const std::exception &e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+}
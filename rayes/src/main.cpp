@@ -1,29 +1,135 @@
 #include "es/rayes/RayEs.h"
+#include "es/rayes/Daemon.h"
 #include "es/rayes/Info.h"
+#include "es/rayes/Recording.h"
 #include "es/core/util.h"
 
 #include <Eigen/Dense>
 
+#include <chrono>
+#include <fstream>
 #include <iostream>
 #include <cstdlib>
+#include <memory>
+#include <string>
+
+namespace {
+
+// Repeats a recorded run without evaluating the problem and reports the
+// time spent in the optimizer.
+int replay(const std::string &path, int repetitions) {
+    es::rayes::EvaluationReplay recording(path);
+    std::cout << "Replaying " << recording.getNumEvaluations()
+              << " evaluations (seed " << recording.getParameters().seed
+              << ")" << std::endl;
+    double timeMin = 0.0;
+    for (int repetition = 0; repetition < repetitions; ++repetition) {
+        recording.rewind();
+        es::rayes::RayEs
+            solver(recording.objective(), recording.constraint(),
+                   recording.getLbnds(), recording.getUbnds(),
+                   recording.getRayOriginInit(),
+                   recording.getLineSearchAlg(),
+                   recording.getParameters());
+        const auto start = std::chrono::steady_clock::now();
+        try {
+            solver.run();
+        } catch (const es::rayes::ReplayEndReached &) {
+            // the recorded run was stopped by the caller
+        }
+        const double time = std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - start).count();
+        if (recording.getNumReplayedEvaluations() !=
+            recording.getNumEvaluations()) {
+            std::cerr << "The replay stopped after "
+                      << recording.getNumReplayedEvaluations()
+                      << " evaluations" << std::endl;
+            return EXIT_FAILURE;
+        }
+        timeMin = repetition == 0 ? time : std::min(timeMin, time);
+    }
+    std::cout << "Optimizer time: " << timeMin << " s ("
+              << 1e6 * timeMin / std::max(1L, recording.getNumEvaluations())
+              << " us per evaluation, best of " << repetitions << ")"
+              << std::endl;
+    return EXIT_SUCCESS;
+}
+
+}
+
+int main(int argc, char *argv[]) {
+    std::string recordPath, replayPath, latenciesPath, daemonPath,
+        parametersPath;
+    unsigned seed = 0;
+    int repetitions = 1;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--record" && i + 1 < argc) {
+            recordPath = argv[++i];
+        } else if (arg == "--replay" && i + 1 < argc) {
+            replayPath = argv[++i];
+        } else if (arg == "--seed" && i + 1 < argc) {
+            seed = static_cast<unsigned>(std::atol(argv[++i]));
+        } else if (arg == "--daemon" && i + 1 < argc) {
+            daemonPath = argv[++i];
+        } else if (arg == "--parameters" && i + 1 < argc) {
+            parametersPath = argv[++i];
+        } else if (arg == "--latencies" && i + 1 < argc) {
+            latenciesPath = argv[++i];
+        } else if (arg == "--repetitions" && i + 1 < argc) {
+            repetitions = std::max(1, std::atoi(argv[++i]));
+        } else {
+            std::cerr << "Usage: " << argv[0]
+                      << " [--seed N] [--record FILE] [--latencies FILE]"
+                      << " | --replay FILE [--repetitions N]"
+                      << " | --daemon SOCKET [--parameters FILE]"
+                      << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+    if (!daemonPath.empty()) {
+        // serves solve requests until a client asks for the shutdown
+        try {
+            es::rayes::SolverDaemon daemon(
+                daemonPath, parametersPath.empty() ? es::rayes::Parameters() :
+                es::rayes::loadParameters(parametersPath));
+            std::cout << "Serving " << daemonPath << std::endl;
+            daemon.serve();
+            std::cout << "Served " << daemon.getNumSolves() << " solves"
+                      << std::endl;
+            return EXIT_SUCCESS;
+        } catch (const std::exception &e) {
+            std::cerr << "Error: " << e.what() << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+    if (!replayPath.empty()) {
+        try {
+            return replay(replayPath, repetitions);
+        } catch (const std::exception &e) {
+            std::cerr << "Error: " << e.what() << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
 
-int main() {
     Eigen::MatrixXd A(1, 2);
     A << -1, 1;
     Eigen::VectorXd b(1);
     b << -5;
-    auto fitnessFun = [](const Eigen::VectorXd &x) {
-        return x.transpose() * x;
-    };
+    std::function<double(const Eigen::VectorXd &)> fitnessFun =
+        [](const Eigen::VectorXd &x) -> double {
+            return x.transpose() * x;
+        };
 
     Eigen::VectorXd lbnds =
         -5 * Eigen::MatrixXd::Ones(A.cols(), 1);
     Eigen::VectorXd ubnds =
         5 * Eigen::MatrixXd::Ones(A.cols(), 1);
 
-    auto constraintFun = [A, b](const Eigen::VectorXd &x) -> Eigen::VectorXd {
-        return A * x - b;
-    };
+    std::function<Eigen::VectorXd(const Eigen::VectorXd &)> constraintFun =
+        [A, b](const Eigen::VectorXd &x) -> Eigen::VectorXd {
+            return A * x - b;
+        };
 
     const double fBest = 12.5;
 
@@ -31,11 +137,33 @@ int main() {
     Eigen::VectorXd originInit = Eigen::VectorXd::Zero(lbnds.rows());
     originInit(0) = 5;
     originInit(1) = -1;
+    es::rayes::Parameters parameters;
+    parameters.seed = seed;
+    parameters.recordLatencies = !latenciesPath.empty();
+    std::unique_ptr<es::rayes::EvaluationRecorder> recorder;
+    if (!recordPath.empty()) {
+        // a recording is only replayable with a fixed seed
+        if (parameters.seed == 0) {
+            parameters.seed = 1;
+        }
+        recorder.reset(new es::rayes::EvaluationRecorder(
+            recordPath, lbnds, ubnds, originInit,
+            es::rayes::LineSearchAlg::Modified, parameters));
+        fitnessFun = recorder->objective(fitnessFun);
+        constraintFun = recorder->constraint(constraintFun);
+    }
     es::rayes::RayEs
         solver(fitnessFun, constraintFun, lbnds, ubnds,
                originInit,
-               es::rayes::LineSearchAlg::Modified);
+               es::rayes::LineSearchAlg::Modified, parameters);
     es::rayes::Info info = solver.run();
+    if (recorder) {
+        recorder->flush();
+    }
+    if (!latenciesPath.empty()) {
+        std::ofstream latencies(latenciesPath);
+        es::rayes::writeLatencies(latencies, info);
+    }
     std::cout << "Termination criterion: "
               << es::core::toString(info.getTerminationCriterion())
               << "."
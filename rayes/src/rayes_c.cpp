@@ -0,0 +1,221 @@
+#include "es/rayes/rayes_c.h"
+
+#include "es/rayes/RayEs.h"
+#include "es/rayes/Individual.h"
+#include "es/core/util.h"
+
+#include <exception>
+#include <limits>
+#include <memory>
+#include <new>
+#include <sstream>
+#include <string>
+
+#include <Eigen/Dense>
+
+struct rayes_solver_s {
+    Eigen::VectorXd lbnds;
+    Eigen::VectorXd ubnds;
+    Eigen::VectorXd rayOrigin;
+    Eigen::Index numConstraints;
+    rayes_objective_t objective;
+    rayes_constraint_t constraint;
+    void *userData;
+    es::rayes::LineSearchAlg lineSearchAlg;
+    es::rayes::Parameters parameters;
+
+    // the constraint callback writes to this buffer (allocated once)
+    Eigen::VectorXd constraintValues;
+
+    // results of the last run
+    Eigen::VectorXd best;
+    double bestF;
+    long numEvaluations;
+    long numConstraintEvaluations;
+    std::string terminationCriterion;
+    std::string lastError;
+};
+
+namespace {
+
+// Thrown by the function wrappers when a callback requests to stop.
+class StopRunException : public std::exception {
+};
+
+int fail(rayes_solver_t *solver, const std::string &message) {
+    solver->lastError = message;
+    return RAYES_ERROR;
+}
+
+}
+
+extern "C" {
+
+rayes_solver_t *rayes_create(size_t dimension,
+                             size_t number_of_constraints,
+                             const double *lower_bounds,
+                             const double *upper_bounds,
+                             const double *ray_origin,
+                             rayes_objective_t objective,
+                             rayes_constraint_t constraint,
+                             void *user_data) {
+    if (dimension == 0 || lower_bounds == nullptr ||
+        upper_bounds == nullptr || ray_origin == nullptr ||
+        objective == nullptr ||
+        (constraint == nullptr && number_of_constraints > 0)) {
+        return nullptr;
+    }
+    rayes_solver_t *solver = new (std::nothrow) rayes_solver_t();
+    if (solver == nullptr) {
+        return nullptr;
+    }
+    try {
+        const Eigen::Index n = static_cast<Eigen::Index>(dimension);
+        solver->lbnds = Eigen::Map<const Eigen::VectorXd>(lower_bounds, n);
+        solver->ubnds = Eigen::Map<const Eigen::VectorXd>(upper_bounds, n);
+        solver->rayOrigin = Eigen::Map<const Eigen::VectorXd>(ray_origin, n);
+        solver->best = solver->rayOrigin;
+    } catch (const std::bad_alloc &) {
+        delete solver;
+        return nullptr;
+    }
+    solver->numConstraints =
+        static_cast<Eigen::Index>(number_of_constraints);
+    try {
+        solver->constraintValues.resize(solver->numConstraints);
+    } catch (const std::bad_alloc &) {
+        delete solver;
+        return nullptr;
+    }
+    solver->objective = objective;
+    solver->constraint = constraint;
+    solver->userData = user_data;
+    solver->lineSearchAlg = es::rayes::LineSearchAlg::Modified;
+    solver->bestF = std::numeric_limits<double>::max();
+    solver->numEvaluations = 0;
+    solver->numConstraintEvaluations = 0;
+    return solver;
+}
+
+void rayes_destroy(rayes_solver_t *solver) {
+    delete solver;
+}
+
+int rayes_set_line_search(rayes_solver_t *solver, int line_search) {
+    if (line_search == RAYES_LINE_SEARCH_STANDARD) {
+        solver->lineSearchAlg = es::rayes::LineSearchAlg::Standard;
+    } else if (line_search == RAYES_LINE_SEARCH_MODIFIED) {
+        solver->lineSearchAlg = es::rayes::LineSearchAlg::Modified;
+    } else if (line_search == RAYES_LINE_SEARCH_ADAPTIVE) {
+        solver->lineSearchAlg = es::rayes::LineSearchAlg::Adaptive;
+    } else {
+        return fail(solver, "Unknown line search algorithm");
+    }
+    return RAYES_OK;
+}
+
+int rayes_set_parameter(rayes_solver_t *solver, const char *name,
+                        const char *value) {
+    try {
+        std::istringstream is(std::string(name) + " = " + value);
+        es::rayes::readParameters(is, solver->parameters);
+    } catch (const std::exception &e) {
+        return fail(solver, e.what());
+    }
+    return RAYES_OK;
+}
+
+int rayes_load_parameters(rayes_solver_t *solver, const char *path) {
+    try {
+        solver->parameters = es::rayes::loadParameters(path);
+    } catch (const std::exception &e) {
+        return fail(solver, e.what());
+    }
+    return RAYES_OK;
+}
+
+int rayes_run(rayes_solver_t *solver) {
+    if (solver->parameters.numThreads != 1) {
+        return fail(solver, "The C interface requires numThreads = 1");
+    }
+    solver->best = solver->rayOrigin;
+    solver->bestF = std::numeric_limits<double>::max();
+    solver->numEvaluations = 0;
+    solver->numConstraintEvaluations = 0;
+    solver->terminationCriterion.clear();
+    solver->lastError.clear();
+
+    // the points are passed to the callbacks without copies, and the
+    // constraint callback writes to the buffer of the solver (RayEs takes
+    // the values by value)
+    auto objective = [solver](const Eigen::VectorXd &x) {
+        double f = 0.0;
+        ++solver->numEvaluations;
+        if (solver->objective(x.data(), &f, solver->userData) != 0) {
+            throw StopRunException();
+        }
+        return f;
+    };
+    auto constraint = [solver](const Eigen::VectorXd &x) {
+        ++solver->numConstraintEvaluations;
+        if (solver->numConstraints > 0 &&
+            solver->constraint(x.data(), solver->constraintValues.data(),
+                               solver->userData) != 0) {
+            throw StopRunException();
+        }
+        return solver->constraintValues;
+    };
+
+    // the best point is taken from the solver, after a stop the best one
+    // of the completed generations
+    std::unique_ptr<es::rayes::RayEs> rayEs;
+    int status = RAYES_OK;
+    try {
+        rayEs.reset(new es::rayes::RayEs(objective, constraint,
+                                         solver->lbnds, solver->ubnds,
+                                         solver->rayOrigin,
+                                         solver->lineSearchAlg,
+                                         solver->parameters));
+        const es::rayes::Info info = rayEs->run();
+        solver->terminationCriterion =
+            es::core::toString(info.getTerminationCriterion());
+    } catch (const StopRunException &) {
+        solver->terminationCriterion = "Stopped";
+        status = RAYES_STOPPED;
+    } catch (const std::exception &e) {
+        return fail(solver, e.what());
+    }
+    const es::rayes::Individual best = rayEs->getBestIndividual();
+    if (best.f() < std::numeric_limits<double>::max()) {
+        solver->bestF = best.f();
+        solver->best = best.bestOnRay();
+    }
+    return status;
+}
+
+double rayes_get_best_value(const rayes_solver_t *solver) {
+    return solver->bestF;
+}
+
+int rayes_get_best_solution(const rayes_solver_t *solver, double *x) {
+    Eigen::Map<Eigen::VectorXd>(x, solver->best.size()) = solver->best;
+    return RAYES_OK;
+}
+
+long rayes_get_evaluations(const rayes_solver_t *solver) {
+    return solver->numEvaluations;
+}
+
+long rayes_get_constraint_evaluations(const rayes_solver_t *solver) {
+    return solver->numConstraintEvaluations;
+}
+
+const char *rayes_get_termination_criterion(const rayes_solver_t *solver) {
+    return solver->terminationCriterion.c_str();
+}
+
+const char *rayes_get_last_error(const rayes_solver_t *solver) {
+    return solver->lastError.c_str();
+}
+
+}
@@ -0,0 +1,68 @@
+#include "es/rayes/Status.h"
+#include "es/core/util.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <thread>
+
+// Shows the progress of all runs on the host that publish their status
+// (Parameters::publishStatus), once or every few seconds with --watch.
+int main(int argc, char *argv[]) {
+    double interval = 0.0;
+    bool removeStale = false;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--watch" && i + 1 < argc) {
+            interval = std::max(0.1, std::atof(argv[++i]));
+        } else if (arg == "--clean") {
+            removeStale = true;
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--watch SECONDS] [--clean]"
+                      << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    do {
+        std::vector<es::rayes::RunStatus> statuses =
+            es::rayes::readRunStatuses(removeStale);
+        std::sort(statuses.begin(), statuses.end(),
+                  [](const es::rayes::RunStatus &a,
+                     const es::rayes::RunStatus &b) {
+                      return a.pid != b.pid ? a.pid < b.pid : a.label < b.label;
+                  });
+        if (interval > 0.0) {
+            // clear the terminal
+            std::printf("\033[H\033[2J");
+        }
+        std::printf("%8s %-28s %-12s %8s %10s %13s %10s %10s %8s\n", "PID",
+                    "LABEL", "PHASE", "GEN", "SIGMA", "BEST F", "EVALS",
+                    "EVALS/S", "TIME/S");
+        for (const es::rayes::RunStatus &status : statuses) {
+            char bestF[32] = "-";
+            if (status.bestF < std::numeric_limits<double>::max()) {
+                std::snprintf(bestF, sizeof(bestF), "%13.6e", status.bestF);
+            }
+            std::printf("%8ld %-28.28s %-12s %8d %10.3e %13s %10d %10.0f "
+                        "%8.1f\n", status.pid, status.label.c_str(),
+                        es::core::toString(status.phase).c_str(),
+                        status.generation, status.sigma, bestF,
+                        status.numFitnessEvaluations,
+                        status.fitnessEvaluationsPerSecond,
+                        status.elapsedSeconds);
+        }
+        std::printf("%lu runs\n", static_cast<unsigned long>(statuses.size()));
+        std::fflush(stdout);
+        if (interval > 0.0) {
+            std::this_thread::sleep_for(
+                std::chrono::duration<double>(interval));
+        }
+    } while (interval > 0.0);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,27 @@
+#!/bin/sh
+# Runs es_rayesclient against a daemon started on a temporary socket and
+# checks that the daemon shuts down cleanly.
+#
+# Usage: test_daemon.sh ES_RAYESTOOL ES_RAYESCLIENT
+
+directory=$(mktemp -d) || exit 1
+socket="$directory/rayes.sock"
+"$1" --daemon "$socket" > "$directory/daemon.log" 2>&1 &
+daemon=$!
+trap 'kill $daemon 2> /dev/null; rm -rf "$directory"' EXIT
+
+# the daemon creates the socket when it is ready
+waited=0
+while [ ! -S "$socket" ]; do
+    if [ $waited -ge 100 ] || ! kill -0 $daemon 2> /dev/null; then
+        echo "the daemon did not start:"
+        cat "$directory/daemon.log"
+        exit 1
+    fi
+    sleep 0.1
+    waited=$((waited + 1))
+done
+
+"$2" "$socket" --repetitions 3 --shutdown || exit 1
+wait $daemon || exit 1
+cat "$directory/daemon.log"
@@ -0,0 +1,97 @@
+// Checks that the batch mode (line searches in lockstep) and the parallel
+// line searches repeat the run with per-point functions exactly.
+
+#include "es/rayes/RayEs.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+namespace {
+
+const int DIMENSION = 4;
+
+double objective(const Eigen::VectorXd &x) {
+    return (x.array() - 1.0).square().sum();
+}
+
+// sum(x) <= 1
+Eigen::VectorXd constraint(const Eigen::VectorXd &x) {
+    return Eigen::VectorXd::Constant(1, x.sum() - 1.0);
+}
+
+Eigen::VectorXd batchObjective(const Eigen::MatrixXd &points) {
+    Eigen::VectorXd f(points.cols());
+    for (int k = 0; k < points.cols(); ++k) {
+        f(k) = objective(points.col(k));
+    }
+    return f;
+}
+
+Eigen::MatrixXd batchConstraint(const Eigen::MatrixXd &points) {
+    Eigen::MatrixXd c(1, points.cols());
+    for (int k = 0; k < points.cols(); ++k) {
+        c.col(k) = constraint(points.col(k));
+    }
+    return c;
+}
+
+es::rayes::Info run(es::rayes::LineSearchAlg lineSearchAlg,
+                    const es::rayes::Parameters &parameters, bool batch) {
+    const Eigen::VectorXd lbnds = Eigen::VectorXd::Constant(DIMENSION, -5.0);
+    const Eigen::VectorXd ubnds = Eigen::VectorXd::Constant(DIMENSION, 5.0);
+    const Eigen::VectorXd origin = Eigen::VectorXd::Zero(DIMENSION);
+    if (batch) {
+        return es::rayes::RayEs(batchObjective, batchConstraint, lbnds, ubnds,
+                                origin, lineSearchAlg, parameters).run();
+    }
+    return es::rayes::RayEs(objective, constraint, lbnds, ubnds, origin,
+                            lineSearchAlg, parameters).run();
+}
+
+bool equal(const es::rayes::Info &a, const es::rayes::Info &b) {
+    return a.getBestIndividual().f() == b.getBestIndividual().f() &&
+        a.getBestIndividual().bestOnRay() ==
+            b.getBestIndividual().bestOnRay() &&
+        a.getNumFitnessEvaluations() == b.getNumFitnessEvaluations() &&
+        a.getNumGenerations() == b.getNumGenerations();
+}
+
+}
+
+int main() {
+    const es::rayes::LineSearchAlg lineSearchAlgs[] = {
+        es::rayes::LineSearchAlg::Standard,
+        es::rayes::LineSearchAlg::Modified,
+        es::rayes::LineSearchAlg::Adaptive};
+    int numFailures = 0;
+    for (es::rayes::LineSearchAlg lineSearchAlg : lineSearchAlgs) {
+        for (double planeSearchRatio : {0.0, 0.3}) {
+            es::rayes::Parameters parameters;
+            parameters.seed = 1;
+            parameters.planeSearchRatio = planeSearchRatio;
+            const es::rayes::Info reference =
+                run(lineSearchAlg, parameters, false);
+            const es::rayes::Info batch = run(lineSearchAlg, parameters, true);
+            parameters.numThreads = 3;
+            const es::rayes::Info parallel =
+                run(lineSearchAlg, parameters, false);
+
+            std::cout << lineSearchAlg << ", planeSearchRatio "
+                      << planeSearchRatio << ": f "
+                      << reference.getBestIndividual().f() << ", "
+                      << reference.getNumFitnessEvaluations()
+                      << " evaluations";
+            if (!equal(reference, batch)) {
+                std::cout << ", batch run differs";
+                ++numFailures;
+            }
+            if (!equal(reference, parallel)) {
+                std::cout << ", parallel run differs";
+                ++numFailures;
+            }
+            std::cout << std::endl;
+        }
+    }
+    return numFailures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
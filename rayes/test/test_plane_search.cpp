@@ -0,0 +1,88 @@
+// Checks that the sigma that the plane search gives to its offspring (the
+// sigma that explains the turned ray) does not destabilize the step size:
+// sigma stays below twice its value of the first generation and converges
+// to the same optimum as without plane searches.
+
+#include "es/rayes/RayEs.h"
+#include "es/rayes/Status.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+
+namespace {
+
+const int DIMENSION = 4;
+
+// an ellipsoid whose constrained optimum lies at the intersection of the
+// two constraints
+double objective(const Eigen::VectorXd &x) {
+    double f = 0.0;
+    for (int i = 0; i < x.size(); ++i) {
+        f += std::pow(10.0, 2.0 * i / (x.size() - 1)) *
+            (x(i) - 1.0) * (x(i) - 1.0);
+    }
+    return f;
+}
+
+// sum(x) <= 1, x_0 <= x_1
+Eigen::VectorXd constraint(const Eigen::VectorXd &x) {
+    Eigen::VectorXd c(2);
+    c << x.sum() - 1.0, x(0) - x(1);
+    return c;
+}
+
+}
+
+int main() {
+    const Eigen::VectorXd lbnds = Eigen::VectorXd::Constant(DIMENSION, -5.0);
+    const Eigen::VectorXd ubnds = Eigen::VectorXd::Constant(DIMENSION, 5.0);
+    const Eigen::VectorXd origin = Eigen::VectorXd::Zero(DIMENSION);
+    int numFailures = 0;
+    for (unsigned seed = 1; seed <= 3; ++seed) {
+        double fReference = 0.0;
+        for (double planeSearchRatio : {0.0, 0.3, 1.0}) {
+            es::rayes::Parameters parameters;
+            parameters.seed = seed;
+            parameters.planeSearchRatio = planeSearchRatio;
+            es::rayes::RayEs solver(objective, constraint, lbnds, ubnds,
+                                    origin,
+                                    es::rayes::LineSearchAlg::Modified,
+                                    parameters);
+            double sigmaFirst = -1.0, sigmaMax = 0.0;
+            solver.setProgressFun([&](const es::rayes::RunStatus &status) {
+                if (sigmaFirst < 0.0) {
+                    sigmaFirst = status.sigma;
+                }
+                sigmaMax = std::max(sigmaMax, status.sigma);
+            });
+            const es::rayes::Info info = solver.run();
+            const double f = info.getBestIndividual().f();
+            if (planeSearchRatio == 0.0) {
+                fReference = f;
+            }
+
+            std::cout << "seed " << seed << ", planeSearchRatio "
+                      << planeSearchRatio << ": f " << f
+                      << ", largest sigma " << sigmaMax / sigmaFirst
+                      << " times the first, "
+                      << info.getTerminationCriterion();
+            if (info.getTerminationCriterion() !=
+                    es::rayes::TerminationCriterion::SigmaLimitReached) {
+                std::cout << ", sigma did not converge";
+                ++numFailures;
+            }
+            if (!(sigmaMax <= 2.0 * sigmaFirst)) {
+                std::cout << ", sigma grew";
+                ++numFailures;
+            }
+            if (!(std::abs(f - fReference) <= 1e-6 * fReference)) {
+                std::cout << ", another optimum";
+                ++numFailures;
+            }
+            std::cout << std::endl;
+        }
+    }
+    return numFailures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,97 @@
+/* Checks the C interface: a complete run, a run stopped by a callback and
+ * the reporting of invalid arguments. */
+
+#include <es/rayes/rayes_c.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* the number of objective evaluations after which the run is stopped */
+static long budget;
+
+static int objective(const double *x, double *f, void *user_data) {
+    long *numEvaluations = (long *) user_data;
+    *f = (x[0] - 1.0) * (x[0] - 1.0) + (x[1] - 1.0) * (x[1] - 1.0);
+    return ++*numEvaluations > budget;
+}
+
+/* x[0] + x[1] <= 1 */
+static int constraint(const double *x, double *c, void *user_data) {
+    (void) user_data;
+    c[0] = x[0] + x[1] - 1.0;
+    return 0;
+}
+
+static int check(int condition, const char *message) {
+    if (!condition) {
+        printf("failed: %s\n", message);
+    }
+    return !condition;
+}
+
+static int run(long runBudget, int expectedStatus) {
+    const double lower[2] = {-5.0, -5.0};
+    const double upper[2] = {5.0, 5.0};
+    const double origin[2] = {0.0, 0.0};
+    double x[2];
+    long numEvaluations = 0;
+    int numFailures = 0;
+    int status;
+    rayes_solver_t *solver = rayes_create(2, 1, lower, upper, origin,
+                                          objective, constraint,
+                                          &numEvaluations);
+    if (solver == NULL) {
+        return check(0, "rayes_create");
+    }
+    budget = runBudget;
+    numFailures += check(rayes_set_parameter(solver, "seed", "1") == RAYES_OK,
+                         "rayes_set_parameter");
+    status = rayes_run(solver);
+    numFailures += check(status == expectedStatus, "status of rayes_run");
+    numFailures += check(rayes_get_best_solution(solver, x) == RAYES_OK,
+                         "rayes_get_best_solution");
+    numFailures += check(x[0] + x[1] <= 1.0 + 1e-12,
+                         "the best point is feasible");
+    numFailures += check(rayes_get_best_value(solver) ==
+                         (x[0] - 1.0) * (x[0] - 1.0) +
+                         (x[1] - 1.0) * (x[1] - 1.0),
+                         "the best value belongs to the best point");
+    numFailures += check(rayes_get_evaluations(solver) > 0,
+                         "evaluations are counted");
+    printf("status %d (%s): f %.12g at (%.6f, %.6f), %ld evaluations\n",
+           status, rayes_get_termination_criterion(solver),
+           rayes_get_best_value(solver), x[0], x[1],
+           rayes_get_evaluations(solver));
+    rayes_destroy(solver);
+    return numFailures;
+}
+
+int main(void) {
+    const double lower[2] = {-5.0, -5.0};
+    const double upper[2] = {5.0, 5.0};
+    const double origin[2] = {0.0, 0.0};
+    long numEvaluations = 0;
+    int numFailures = 0;
+    rayes_solver_t *solver;
+
+    numFailures += run(1000000000L, RAYES_OK);
+    numFailures += run(500, RAYES_STOPPED);
+
+    solver = rayes_create(2, 1, lower, upper, origin, objective, constraint,
+                          &numEvaluations);
+    numFailures += check(rayes_set_line_search(solver, 42) == RAYES_ERROR,
+                         "an unknown line search is rejected");
+    numFailures += check(rayes_set_parameter(solver, "noSuchParameter", "1")
+                         == RAYES_ERROR, "an unknown parameter is rejected");
+    numFailures += check(strlen(rayes_get_last_error(solver)) > 0,
+                         "the error is reported");
+    numFailures += check(rayes_set_parameter(solver, "numThreads", "2") ==
+                         RAYES_OK && rayes_run(solver) == RAYES_ERROR,
+                         "numThreads > 1 is rejected");
+    rayes_destroy(solver);
+    numFailures += check(rayes_create(2, 1, lower, upper, origin, NULL, NULL,
+                                      NULL) == NULL,
+                         "a missing objective is rejected");
+    return numFailures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
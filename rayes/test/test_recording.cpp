@@ -0,0 +1,94 @@
+// Checks that a recorded run is repeated by its replay and that a replay
+// detects a run that deviates from the recording.
+
+#include "es/rayes/RayEs.h"
+#include "es/rayes/Recording.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+double objective(const Eigen::VectorXd &x) {
+    return (x.array() - 1.0).square().sum();
+}
+
+Eigen::VectorXd constraint(const Eigen::VectorXd &x) {
+    return Eigen::VectorXd::Constant(1, x.sum() - 1.0);
+}
+
+}
+
+int main(int argc, char *argv[]) {
+    if (argc != 2) {
+        std::cerr << "Usage: " << argv[0] << " RECORDING" << std::endl;
+        return EXIT_FAILURE;
+    }
+    const std::string path = argv[1];
+    const Eigen::VectorXd lbnds = Eigen::VectorXd::Constant(3, -5.0);
+    const Eigen::VectorXd ubnds = Eigen::VectorXd::Constant(3, 5.0);
+    const Eigen::VectorXd origin = Eigen::VectorXd::Zero(3);
+    int numFailures = 0;
+    try {
+        es::rayes::Parameters parameters;
+        parameters.seed = 7;
+        es::rayes::EvaluationRecorder recorder(
+            path, lbnds, ubnds, origin, es::rayes::LineSearchAlg::Modified,
+            parameters);
+        const es::rayes::Info recorded = es::rayes::RayEs(
+            recorder.objective(objective), recorder.constraint(constraint),
+            lbnds, ubnds, origin, es::rayes::LineSearchAlg::Modified,
+            parameters).run();
+        recorder.flush();
+
+        es::rayes::EvaluationReplay replay(path);
+        for (int repetition = 0; repetition < 2; ++repetition) {
+            replay.rewind();
+            const es::rayes::Info replayed = es::rayes::RayEs(
+                replay.objective(), replay.constraint(), replay.getLbnds(),
+                replay.getUbnds(), replay.getRayOriginInit(),
+                replay.getLineSearchAlg(), replay.getParameters()).run();
+            if (replayed.getBestIndividual().f() !=
+                    recorded.getBestIndividual().f() ||
+                replay.getNumReplayedEvaluations() !=
+                    replay.getNumEvaluations()) {
+                std::cout << "replay " << repetition
+                          << " differs from the recorded run" << std::endl;
+                ++numFailures;
+            }
+        }
+        std::cout << replay.getNumEvaluations() << " evaluations replayed"
+                  << std::endl;
+
+        // another seed asks for other points than the recorded ones
+        parameters = replay.getParameters();
+        parameters.seed = 8;
+        replay.rewind();
+        try {
+            es::rayes::RayEs(replay.objective(), replay.constraint(),
+                             lbnds, ubnds, origin,
+                             es::rayes::LineSearchAlg::Modified,
+                             parameters).run();
+            std::cout << "a deviating run was replayed" << std::endl;
+            ++numFailures;
+        } catch (const std::runtime_error &) {
+        }
+
+        parameters.numThreads = 2;
+        try {
+            es::rayes::EvaluationRecorder(
+                path, lbnds, ubnds, origin,
+                es::rayes::LineSearchAlg::Modified, parameters);
+            std::cout << "recording with several threads was accepted"
+                      << std::endl;
+            ++numFailures;
+        } catch (const std::runtime_error &) {
+        }
+    } catch (const std::exception &e) {
+        std::cout << "Error: " << e.what() << std::endl;
+        ++numFailures;
+    }
+    return numFailures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}